@@ -44,6 +44,24 @@ int cmCPackArchiveGenerator::InitializeInternal()
   this->SetOptionIfNotSet("CPACK_INCLUDE_TOPLEVEL_DIRECTORY", "1");
   return this->Superclass::InitializeInternal();
 }
+//----------------------------------------------------------------------
+unsigned int cmCPackArchiveGenerator::GetThreadCount()
+{
+  const char* threads = 0;
+  if (const char* gen = this->GetOption("CPACK_GENERATOR"))
+    {
+    std::string genVar = "CPACK_ARCHIVE_";
+    genVar += gen;
+    genVar += "_THREADS";
+    threads = this->GetOption(genVar.c_str());
+    }
+  if (!threads)
+    {
+    threads = this->GetOption("CPACK_ARCHIVE_THREADS");
+    }
+  return threads? static_cast<unsigned int>(atoi(threads)) : 1;
+}
+
 //----------------------------------------------------------------------
 int cmCPackArchiveGenerator::addOneComponentToArchive(cmArchiveWrite& archive,
                              cmCPackComponent* component)
@@ -100,7 +118,8 @@ if (!GenerateHeader(&gf)) \
             << ">." << std::endl); \
     return 0; \
   } \
-cmArchiveWrite archive(gf,this->Compress, this->Archive); \
+cmArchiveWrite archive(gf,this->Compress, this->Archive, \
+                       this->GetThreadCount()); \
 if (!archive) \
   { \
   cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to create archive < " \
@@ -111,6 +130,21 @@ if (!archive) \
   return 0; \
   }
 
+/*
+ * The macro will finish writing the 'archive' object
+ * declared by DECLARE_AND_OPEN_ARCHIVE.
+ */
+#define CLOSE_ARCHIVE(filename,archive) \
+if (!archive.Close()) \
+  { \
+  cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to write archive < " \
+     << filename \
+     << ">. ERROR =" \
+     << archive.GetError() \
+     << std::endl); \
+  return 0; \
+  }
+
 //----------------------------------------------------------------------
 int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
 {
@@ -146,6 +180,7 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
           // Add the files of this component to the archive
           addOneComponentToArchive(archive,*compIt);
           }
+        CLOSE_ARCHIVE(packageFileName,archive);
       }
       // add the generated package to package file names list
       packageFileNames.push_back(packageFileName);
@@ -178,6 +213,7 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
           DECLARE_AND_OPEN_ARCHIVE(packageFileName,archive);
           // Add the files of this component to the archive
           addOneComponentToArchive(archive,&(compIt->second));
+          CLOSE_ARCHIVE(packageFileName,archive);
         }
         // add the generated package to package file names list
         packageFileNames.push_back(packageFileName);
@@ -205,6 +241,7 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
         DECLARE_AND_OPEN_ARCHIVE(packageFileName,archive);
         // Add the files of this component to the archive
         addOneComponentToArchive(archive,&(compIt->second));
+        CLOSE_ARCHIVE(packageFileName,archive);
       }
       // add the generated package to package file names list
       packageFileNames.push_back(packageFileName);
@@ -237,7 +274,7 @@ int cmCPackArchiveGenerator::PackageComponentsAllInOne()
     addOneComponentToArchive(archive,&(compIt->second));
     }
 
-  // archive goes out of scope so it will finalized and closed.
+  CLOSE_ARCHIVE(packageFileNames[0],archive);
   return 1;
 }
 
@@ -289,7 +326,7 @@ int cmCPackArchiveGenerator::PackageFiles()
       }
     }
   cmSystemTools::ChangeDirectory(dir.c_str());
-  // The destructor of cmArchiveWrite will close and finish the write
+  CLOSE_ARCHIVE(packageFileNames[0],archive);
   return 1;
 }
 
@@ -67,6 +67,11 @@ protected:
    */
   int PackageComponentsAllInOne();
   virtual const char* GetOutputExtension() = 0;
+  /**
+   * The number of threads to compress on, from
+   * CPACK_ARCHIVE_<GENNAME>_THREADS or CPACK_ARCHIVE_THREADS.
+   */
+  unsigned int GetThreadCount();
   cmArchiveWrite::Compress Compress;
   cmArchiveWrite::Type Archive;
   };
@@ -15,6 +15,8 @@
 #include "cmMakefile.h"
 #include "cmGeneratedFileStream.h"
 #include "cmCPackLog.h"
+#include "cmArchiveWrite.h"
+#include "cmCryptoHash.h"
 
 #include <cmsys/SystemTools.hxx>
 #include <cmsys/Glob.hxx>
@@ -282,8 +284,6 @@ int cmCPackDebGenerator::PackageFiles()
 
 int cmCPackDebGenerator::createDeb()
 {
-  const char* cmakeExecutable = this->GetOption("CMAKE_COMMAND");
-
   // debian-binary file
   std::string dbfilename;
     dbfilename += this->GetOption("WDIR");
@@ -399,14 +399,6 @@ int cmCPackDebGenerator::createDeb()
     out << std::endl;
     }
 
-  std::string cmd;
-  if (NULL != this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE")) {
-      cmd += this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE");
-  }
-  cmd += " \"";
-  cmd += cmakeExecutable;
-  cmd += "\" -E tar cfz data.tar.gz ";
-
   // now add all directories which have to be compressed
   // collect all top level install dirs for that
   // e.g. /opt/bin/foo, /usr/bin/bar and /usr/bin/baz would give /usr and /opt
@@ -415,6 +407,7 @@ int cmCPackDebGenerator::createDeb()
           << "\", length = " << topLevelLength
           << std::endl);
   std::set<std::string> installDirs;
+  std::vector<std::string> installDirList;
     for (std::vector<std::string>::const_iterator fileIt =
         packageFiles.begin();
         fileIt != packageFiles.end(); ++ fileIt )
@@ -429,29 +422,39 @@ int cmCPackDebGenerator::createDeb()
     if (installDirs.find(relativeDir) == installDirs.end())
       {
       installDirs.insert(relativeDir);
-      cmd += " .";
-      cmd += relativeDir;
+      installDirList.push_back(relativeDir);
       }
     }
 
-  std::string output;
-    int retval = -1;
-  int res = cmSystemTools::RunSingleCommand(cmd.c_str(), &output,
-      &retval, this->GetOption("WDIR"), this->GeneratorVerbose, 0);
-
-    if ( !res || retval )
-    {
-    std::string tmpFile = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
-    tmpFile += "/Deb.log";
-    cmGeneratedFileStream ofs(tmpFile.c_str());
-    ofs << "# Run command: " << cmd.c_str() << std::endl
-      << "# Working directory: " << toplevel << std::endl
-      << "# Output:" << std::endl
-      << output.c_str() << std::endl;
-    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem running tar command: "
-      << cmd.c_str() << std::endl
-      << "Please check " << tmpFile.c_str() << " for errors" << std::endl);
-    return 0;
+  // Compress the installed files and compute the checksum of each of
+  // them for md5sums in one pass.  All entries are owned by root, so
+  // the package needs not be built under fakeroot.
+  std::string topLevelString = this->GetOption("WDIR");
+  std::string dataTarName = topLevelString + "/data.tar.gz";
+  std::map<std::string, std::string> checksums;
+    { // the scope is needed for cmGeneratedFileStream
+    cmGeneratedFileStream fileStream_data_tar;
+    fileStream_data_tar.Open(dataTarName.c_str(), false, true);
+    cmArchiveWrite data_tar(fileStream_data_tar,
+                            cmArchiveWrite::CompressGZip,
+                            cmArchiveWrite::TypeTAR);
+    data_tar.SetUIDAndGID(0, 0);
+    data_tar.SetUNAMEAndGNAME("root", "root");
+    data_tar.SetChecksumAlgorithm("MD5");
+    for (std::vector<std::string>::const_iterator dirIt =
+           installDirList.begin();
+         dirIt != installDirList.end() && data_tar; ++dirIt)
+      {
+      data_tar.Add(topLevelString + *dirIt, topLevelLength, ".");
+      }
+    if (!data_tar.Close())
+      {
+      cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem creating archive <"
+        << dataTarName << ">: " << data_tar.GetError() << std::endl);
+      return 0;
+      }
+    checksums.insert(data_tar.GetChecksums().begin(),
+                     data_tar.GetChecksums().end());
     }
 
   std::string md5filename;
@@ -465,37 +468,32 @@ int cmCPackDebGenerator::createDeb()
     std::string topLevelWithTrailingSlash =
         this->GetOption("CPACK_TEMPORARY_DIRECTORY");
     topLevelWithTrailingSlash += '/';
+    cmCryptoHashMD5 md5;
       for ( fileIt = packageFiles.begin();
             fileIt != packageFiles.end(); ++ fileIt )
       {
-      cmd = "\"";
-      cmd += cmakeExecutable;
-      cmd += "\" -E md5sum \"";
-      cmd += *fileIt;
-      cmd += "\"";
-      //std::string output;
-      //int retVal = -1;
-      res = cmSystemTools::RunSingleCommand(cmd.c_str(), &output,
-          &retval, toplevel.c_str(), this->GeneratorVerbose, 0);
+      // Files not in data.tar.gz with their content, like symbolic
+      // links, are read again.
+      std::map<std::string, std::string>::const_iterator ci =
+        checksums.find("." + fileIt->substr(topLevelLength));
+      std::string md5sum = ci != checksums.end()? ci->second :
+        md5.HashFile(fileIt->c_str());
       // debian md5sums entries are like this:
       // 014f3604694729f3bf19263bac599765  usr/bin/ccmake
       // thus strip the full path (with the trailing slash)
-      cmSystemTools::ReplaceString(output,
+      std::string path = *fileIt;
+      cmSystemTools::ReplaceString(path,
                                    topLevelWithTrailingSlash.c_str(), "");
-      out << output;
+      out << md5sum << "  " << path << "\n";
       }
     // each line contains a eol.
     // Do not end the md5sum file with yet another (invalid)
     }
 
-    cmd = "";
-    if (NULL != this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE"))
-      {
-      cmd = this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE");
-      }
-    cmd += " \"";
-    cmd += cmakeExecutable;
-    cmd += "\" -E tar cfz control.tar.gz ./control ./md5sums";
+  // debian is picky and need relative to ./ path in the tar.gz
+  std::vector<std::string> controlFiles;
+  controlFiles.push_back("control");
+  controlFiles.push_back("md5sums");
     const char* controlExtra =
       this->GetOption("CPACK_DEBIAN_PACKAGE_CONTROL_EXTRA");
   if( controlExtra )
@@ -514,43 +512,43 @@ int cmCPackDebGenerator::createDeb()
       if( cmsys::SystemTools::CopyFileIfDifferent(
             i->c_str(), localcopy.c_str()) )
         {
-        // debian is picky and need relative to ./ path in the tar.gz
-        cmd += " ./";
-        cmd += filenamename;
+        controlFiles.push_back(filenamename);
         }
       }
     }
-  res = cmSystemTools::RunSingleCommand(cmd.c_str(), &output,
-      &retval, this->GetOption("WDIR"), this->GeneratorVerbose, 0);
-
-    if ( !res || retval )
-    {
-    std::string tmpFile = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
-    tmpFile += "/Deb.log";
-    cmGeneratedFileStream ofs(tmpFile.c_str());
-    ofs << "# Run command: " << cmd.c_str() << std::endl
-      << "# Working directory: " << toplevel << std::endl
-      << "# Output:" << std::endl
-      << output.c_str() << std::endl;
-    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem running tar command: "
-      << cmd.c_str() << std::endl
-      << "Please check " << tmpFile.c_str() << " for errors" << std::endl);
-    return 0;
+  std::string controlTarName = topLevelString + "/control.tar.gz";
+    { // the scope is needed for cmGeneratedFileStream
+    cmGeneratedFileStream fileStream_control_tar;
+    fileStream_control_tar.Open(controlTarName.c_str(), false, true);
+    cmArchiveWrite control_tar(fileStream_control_tar,
+                               cmArchiveWrite::CompressGZip,
+                               cmArchiveWrite::TypeTAR);
+    control_tar.SetUIDAndGID(0, 0);
+    control_tar.SetUNAMEAndGNAME("root", "root");
+    for (std::vector<std::string>::const_iterator i = controlFiles.begin();
+         i != controlFiles.end() && control_tar; ++i)
+      {
+      control_tar.Add(topLevelString + "/" + *i, topLevelLength + 1, "./");
+      }
+    if (!control_tar.Close())
+      {
+      cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem creating archive <"
+        << controlTarName << ">: " << control_tar.GetError() << std::endl);
+      return 0;
+      }
     }
 
   // ar -r your-package-name.deb debian-binary control.tar.gz data.tar.gz
   // since debian packages require BSD ar (most Linux distros and even
   // FreeBSD and NetBSD ship GNU ar) we use a copy of OpenBSD ar here.
   std::vector<std::string> arFiles;
-    std::string topLevelString = this->GetOption("WDIR");
-  topLevelString += "/";
-  arFiles.push_back(topLevelString + "debian-binary");
-  arFiles.push_back(topLevelString + "control.tar.gz");
-  arFiles.push_back(topLevelString + "data.tar.gz");
+  arFiles.push_back(dbfilename);
+  arFiles.push_back(controlTarName);
+  arFiles.push_back(dataTarName);
     std::string outputFileName = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
     outputFileName += "/";
     outputFileName += this->GetOption("CPACK_OUTPUT_FILE_NAME");
-    res = ar_append(outputFileName.c_str(), arFiles);
+    int res = ar_append(outputFileName.c_str(), arFiles);
   if ( res!=0 )
     {
     std::string tmpFile = this->GetOption("CPACK_TEMPORARY_PACKAGE_FILE_NAME");
@@ -80,6 +80,18 @@ void cmCPackDocumentVariables::DefineVariables(cmake* cm)
            " it.", false,
            "Variables common to all CPack generators");
 
+  cm->DefineProperty
+        ("CPACK_ARCHIVE_THREADS", cmProperty::VARIABLE,
+         "Number of threads the archive generators compress on.",
+         "The TGZ, TBZ2 and STGZ generators compress the archive in "
+         "independent blocks on this many threads.  The result is read "
+         "by gzip and bzip2 like any other such archive.  Set it to 0 "
+         "to use as many threads as the machine has.  The default is 1, "
+         "which compresses the archive as a single stream.\n"
+         "CPACK_ARCHIVE_<GENNAME>_THREADS, e.g. "
+         "CPACK_ARCHIVE_TGZ_THREADS, overrides it for one generator.", false,
+         "Variables common to all CPack generators");
+
   cm->DefineProperty
         ("CPACK_INSTALL_SCRIPT", cmProperty::VARIABLE,
          "Extra CMake script provided by the user.",
@@ -89,6 +101,33 @@ void cmCPackDocumentVariables::DefineVariables(cmake* cm)
          " The script is not called by e.g.: make install.", false,
          "Variables common to all CPack generators");
 
+  cm->DefineProperty
+        ("CPACK_REUSE_STAGED_INSTALL", cmProperty::VARIABLE,
+         "Install each component once for all generators.",
+         "When cpack is run with several generators it stages the install "
+         "of each CMake project component once per install prefix in "
+         "_CPack_Packages/<CPACK_TOPLEVEL_TAG>/_Staging and copies it into "
+         "the install directory of every generator that installs it the "
+         "same way, instead of running cmake_install.cmake again.  The "
+         "staged installs are kept for the next cpack run, which only "
+         "copies the files that changed and removes those no longer "
+         "installed, as recorded in the install database of each staged "
+         "install.  Files created by install(CODE) or install(SCRIPT) "
+         "are not recorded and stay until the _Staging directory is "
+         "deleted.  Set this to "
+         "OFF to run the install scripts for each generator.", false,
+         "Variables common to all CPack generators");
+
+  cm->DefineProperty
+        ("CPACK_STAGED_INSTALL_HARDLINKS", cmProperty::VARIABLE,
+         "Hardlink staged files instead of copying them.",
+         "If set, the files of a staged install are hardlinked into the "
+         "install directory of each generator where the platform supports "
+         "it.  Generators that modify the installed files in place then "
+         "modify them for all generators, so this is OFF by default.",
+         false,
+         "Variables common to all CPack generators");
+
   cm->DefineProperty
         ("CPACK_ABSOLUTE_DESTINATION_FILES", cmProperty::VARIABLE,
          "List of files which have been installed using "
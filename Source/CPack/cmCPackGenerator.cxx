@@ -19,6 +19,7 @@
 #include "cmLocalGenerator.h"
 #include "cmGeneratedFileStream.h"
 #include "cmCPackComponentGroup.h"
+#include "cmCPackStagedInstall.h"
 #include "cmXMLSafe.h"
 
 #include <cmsys/SystemTools.hxx>
@@ -720,6 +721,47 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
             }
           }
 
+        // If DESTDIR has been 'internally set ON' this means that
+        // the underlying CPack specific generator did ask for that
+        // In this case we may override CPACK_INSTALL_PREFIX with
+        // CPACK_PACKAGING_INSTALL_PREFIX
+        // I know this is tricky and awkward but it's the price for
+        // CPACK_SET_DESTDIR backward compatibility.
+        if (setDestDir && cmSystemTools::IsInternallyOn(
+              this->GetOption("CPACK_SET_DESTDIR")))
+          {
+          this->SetOption("CPACK_INSTALL_PREFIX",
+                          this->GetOption("CPACK_PACKAGING_INSTALL_PREFIX"));
+          }
+
+        // When cpack builds several generators the install of this
+        // component is staged once and copied for each of them.
+        std::string componentDirectory = tempInstallDirectory;
+        cmsys::auto_ptr<cmCPackStagedInstall> staged;
+        bool reuseStaged = false;
+        const char* stagingRoot
+          = this->GetOption("CPACK_STAGED_INSTALL_DIRECTORY");
+        if (stagingRoot && *stagingRoot)
+          {
+          staged.reset(new cmCPackStagedInstall(stagingRoot,
+            this->GetStagedInstallKey(installFile, installComponent,
+                                      setDestDir)));
+          bool stage = false;
+          if (!staged->Acquire(stage))
+            {
+            cmCPackLogger(cmCPackLog::LOG_ERROR,
+                          "Problem staging install of component: "
+                          << installComponent << ": "
+                          << staged->GetError() << std::endl);
+            return 0;
+            }
+          reuseStaged = !stage;
+          if (stage)
+            {
+            tempInstallDirectory = staged->GetTree();
+            }
+          }
+
         if (!setDestDir)
           {
           tempInstallDirectory += this->GetPackagingInstallPrefix();
@@ -731,19 +773,6 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
           // CMAKE_INSTALL_PREFIX underneath the tempInstallDirectory. The
           // value of the project's CMAKE_INSTALL_PREFIX is sent in here as
           // the value of the CPACK_INSTALL_PREFIX variable.
-          //
-          // If DESTDIR has been 'internally set ON' this means that
-          // the underlying CPack specific generator did ask for that
-          // In this case we may override CPACK_INSTALL_PREFIX with
-          // CPACK_PACKAGING_INSTALL_PREFIX
-          // I know this is tricky and awkward but it's the price for
-          // CPACK_SET_DESTDIR backward compatibility.
-          if (cmSystemTools::IsInternallyOn(
-                this->GetOption("CPACK_SET_DESTDIR")))
-            {
-            this->SetOption("CPACK_INSTALL_PREFIX",
-                            this->GetOption("CPACK_PACKAGING_INSTALL_PREFIX"));
-            }
           std::string dir;
           if (this->GetOption("CPACK_INSTALL_PREFIX"))
             {
@@ -822,6 +851,10 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
           {
           mf->AddDefinition("BUILD_TYPE", buildConfig);
           }
+        // Installs into a staged tree are kept up to date with its own
+        // database.  Others are not recorded in the build tree one.
+        mf->AddDefinition("CMAKE_INSTALL_DATABASE",
+                          staged.get()? staged->GetDatabase().c_str() : "");
         std::string installComponentLowerCase
           = cmSystemTools::LowerCase(installComponent);
         if ( installComponentLowerCase != "all" )
@@ -838,7 +871,12 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
           }
         // Remember the list of files before installation
         // of the current component (if we are in component install)
-        const char* InstallPrefix = tempInstallDirectory.c_str();
+        std::string installPrefix = componentDirectory;
+        if (!setDestDir)
+          {
+          installPrefix += this->GetPackagingInstallPrefix();
+          }
+        const char* InstallPrefix = installPrefix.c_str();
         std::vector<std::string> filesBefore;
         std::string findExpr(InstallPrefix);
         if (componentInstall)
@@ -869,7 +907,43 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
                               "1");
           }
         // do installation
-        int res = mf->ReadListFile(0, installFile.c_str());
+        int res = 1;
+        if (reuseStaged)
+          {
+          cmCPackLogger(cmCPackLog::LOG_VERBOSE,
+                        "- Reuse staged install of: " << installComponent
+                        << std::endl);
+          if (!staged->GetAbsoluteDestinationFiles().empty())
+            {
+            mf->AddDefinition("CMAKE_ABSOLUTE_DESTINATION_FILES",
+              staged->GetAbsoluteDestinationFiles().c_str());
+            }
+          }
+        else
+          {
+          res = mf->ReadListFile(0, installFile.c_str());
+          if (staged.get() && res && !cmSystemTools::GetErrorOccuredFlag())
+            {
+            staged->SetAbsoluteDestinationFiles(
+              mf->GetDefinition("CMAKE_ABSOLUTE_DESTINATION_FILES"));
+            if (!staged->Commit())
+              {
+              cmCPackLogger(cmCPackLog::LOG_ERROR,
+                            "Problem staging install of component: "
+                            << installComponent << std::endl);
+              return 0;
+              }
+            }
+          }
+        if (staged.get() && res &&
+            !staged->CopyTo(componentDirectory,
+                            this->IsOn("CPACK_STAGED_INSTALL_HARDLINKS")))
+          {
+          cmCPackLogger(cmCPackLog::LOG_ERROR,
+                        "Problem copying staged install to: "
+                        << componentDirectory << std::endl);
+          return 0;
+          }
         // forward definition of CMAKE_ABSOLUTE_DESTINATION_FILES
         // to CPack (may be used by generators like CPack RPM or DEB)
         // in order to transparently handle ABSOLUTE PATH
@@ -956,6 +1030,45 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
   return 1;
 }
 
+//----------------------------------------------------------------------
+std::string
+cmCPackGenerator::GetStagedInstallKey(std::string const& installFile,
+                                      std::string const& installComponent,
+                                      bool setDestDir)
+{
+  const char* options[] = {
+    "CPACK_BUILD_CONFIG",
+    "CPACK_STRIP_FILES",
+    "CPACK_WARN_ON_ABSOLUTE_INSTALL_DESTINATION",
+    "CPACK_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION",
+    0
+  };
+  std::string key = "cpack staged install 1\n";
+  key += installFile + "\n" + installComponent + "\n";
+  if (setDestDir)
+    {
+    key += "DESTDIR ";
+    const char* prefix = this->GetOption("CPACK_INSTALL_PREFIX");
+    key += prefix? prefix : "";
+    }
+  else
+    {
+    key += "PREFIX ";
+    key += this->GetPackagingInstallPrefix();
+    }
+  key += "\n";
+  key += this->SupportsAbsoluteDestination()? "ABSOLUTE\n" : "RELATIVE\n";
+  for (const char** option = options; *option; ++option)
+    {
+    const char* value = this->GetOption(*option);
+    key += *option;
+    key += "=";
+    key += value? value : "";
+    key += "\n";
+    }
+  return key;
+}
+
 //----------------------------------------------------------------------
 bool cmCPackGenerator::ReadListFile(const char* moduleName)
 {
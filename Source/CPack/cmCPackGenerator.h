@@ -324,6 +324,14 @@ protected:
   cmCPackLog* Logger;
 private:
   cmMakefile* MakefileMap;
+
+  /**
+   * Identify everything the install of a component depends on, so
+   * that generators installing it the same way share a staged install.
+   */
+  std::string GetStagedInstallKey(std::string const& installFile,
+                                  std::string const& installComponent,
+                                  bool setDestDir);
 };
 
 #endif
@@ -0,0 +1,221 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc.
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+
+#include "cmCPackStagedInstall.h"
+
+#include "cmCryptoHash.h"
+#include "cmGeneratedFileStream.h"
+#include "cmInstallDatabase.h"
+#include "cmSystemTools.h"
+
+#include <cmsys/Directory.hxx>
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------
+static std::string cmCPackStagedInstallDirectory(std::string const& root,
+                                                 std::string const& key)
+{
+  cmCryptoHashMD5 md5;
+  return root + "/" + md5.HashString(key.c_str());
+}
+
+//----------------------------------------------------------------------
+cmCPackStagedInstall::cmCPackStagedInstall(std::string const& root,
+                                           std::string const& key):
+  Directory(cmCPackStagedInstallDirectory(root, key)),
+  Lock(Directory + ".lock")
+{
+}
+
+//----------------------------------------------------------------------
+bool cmCPackStagedInstall::Load()
+{
+  std::string info = this->Directory + "/info.txt";
+  std::ifstream fin(info.c_str());
+  if(!fin)
+    {
+    return false;
+    }
+  std::string line;
+  cmSystemTools::GetLineFromStream(fin, line);
+  this->AbsoluteDestinationFiles = line;
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool cmCPackStagedInstall::Acquire(bool& stage)
+{
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(this->Directory).c_str());
+  stage = false;
+  int ownerless = 0;
+  for(;;)
+    {
+    if(this->Load())
+      {
+      return true;
+      }
+    if(this->Lock.TryAcquire())
+      {
+      // The install may have been committed before we took the lock.
+      if(this->Load())
+        {
+        this->Lock.Release();
+        return true;
+        }
+      cmSystemTools::MakeDirectory(this->GetTree().c_str());
+      stage = true;
+      return true;
+      }
+    if(!this->Lock.Exists())
+      {
+      // The lock cannot be created.  Staging will report why.
+      stage = true;
+      return true;
+      }
+
+    // The owner records itself right after taking the lock, so give up
+    // only if it is not known for a while.
+    if(this->Lock.OwnerRuns())
+      {
+      ownerless = 0;
+      }
+    else if(++ownerless > 50)
+      {
+      this->Error = "The process staging this install stopped before "
+        "it was complete.  Remove the lock \"" + this->Lock.GetPath() +
+        "\" or run cpack again.";
+      return false;
+      }
+    cmSystemTools::Delay(100);
+    }
+}
+
+//----------------------------------------------------------------------
+bool cmCPackStagedInstall::Commit()
+{
+  cmInstallDatabase* database = cmInstallDatabase::Get(this->GetDatabase());
+  database->Prune(this->GetTree());
+  if(!database->Save())
+    {
+    return false;
+    }
+  std::string info = this->Directory + "/info.txt";
+    {
+    cmGeneratedFileStream fout(info.c_str());
+    fout << this->AbsoluteDestinationFiles << "\n";
+    if(!fout.Close())
+      {
+      return false;
+      }
+    }
+  this->Lock.Release();
+  return true;
+}
+
+//----------------------------------------------------------------------
+void cmCPackStagedInstall::Invalidate(std::string const& root)
+{
+  cmsys::Directory d;
+  if(!d.Load(root.c_str()))
+    {
+    return;
+    }
+  for(unsigned long i = 0; i < d.GetNumberOfFiles(); ++i)
+    {
+    std::string name = d.GetFile(i);
+    if(name == "." || name == "..")
+      {
+      continue;
+      }
+    std::string path = root + "/" + name;
+    if(cmSystemTools::GetFilenameLastExtension(name) == ".lock")
+      {
+      // Left behind by a cpack process that did not finish.
+      cmSystemTools::RemoveADirectory(path.c_str());
+      }
+    else
+      {
+      cmSystemTools::RemoveFile((path + "/info.txt").c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------
+bool cmCPackStagedInstall::CopyTo(std::string const& dir, bool hardlink)
+{
+  return CopyTree(this->GetTree(), dir, hardlink);
+}
+
+//----------------------------------------------------------------------
+bool cmCPackStagedInstall::CopyTree(std::string const& from,
+                                    std::string const& to, bool hardlink)
+{
+  cmsys::Directory d;
+  if(!d.Load(from.c_str()) || !cmSystemTools::MakeDirectory(to.c_str()))
+    {
+    return false;
+    }
+  mode_t mode;
+  if(cmSystemTools::GetPermissions(from.c_str(), mode))
+    {
+    cmSystemTools::SetPermissions(to.c_str(), mode);
+    }
+  for(unsigned long i = 0; i < d.GetNumberOfFiles(); ++i)
+    {
+    std::string name = d.GetFile(i);
+    if(name == "." || name == "..")
+      {
+      continue;
+      }
+    std::string src = from + "/" + name;
+    std::string dst = to + "/" + name;
+    if(cmSystemTools::FileIsSymlink(src.c_str()))
+      {
+      std::string target;
+      cmSystemTools::RemoveFile(dst.c_str());
+      if(!cmSystemTools::ReadSymlink(src.c_str(), target) ||
+         !cmSystemTools::CreateSymlink(target.c_str(), dst.c_str()))
+        {
+        return false;
+        }
+      }
+    else if(cmSystemTools::FileIsDirectory(src.c_str()))
+      {
+      if(!CopyTree(src, dst, hardlink))
+        {
+        return false;
+        }
+      }
+    else
+      {
+      bool linked = false;
+#if !defined(_WIN32) || defined(__CYGWIN__)
+      if(hardlink)
+        {
+        cmSystemTools::RemoveFile(dst.c_str());
+        linked = link(src.c_str(), dst.c_str()) == 0;
+        }
+#endif
+      if(!linked &&
+         (!cmSystemTools::CopyFileAlways(src.c_str(), dst.c_str()) ||
+          !cmSystemTools::CopyFileTime(src.c_str(), dst.c_str())))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
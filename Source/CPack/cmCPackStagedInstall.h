@@ -0,0 +1,89 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc.
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+
+#ifndef cmCPackStagedInstall_h
+#define cmCPackStagedInstall_h
+
+#include "cmStandardIncludes.h"
+
+#include "cmDirectoryLock.h"
+
+/** \class cmCPackStagedInstall
+ * \brief An install of one project component shared by CPack generators
+ *
+ * CPack runs a project's cmake_install.cmake once per generator.  When
+ * several generators are built, the first one to install a component
+ * into a given prefix stages the result in a directory named after a
+ * hash of everything the install script depends on.  The others copy,
+ * or hardlink, the staged tree instead of running the script again.
+ *
+ * Staged trees are kept between cpack runs together with a database of
+ * the files installed into them, so that staging again only copies the
+ * files that changed and removes those no longer installed.  A tree is
+ * valid for the current run once it has been committed.  The process
+ * staging it holds a lock directory meanwhile, so cpack processes
+ * running concurrently never see half of one.  The lock records the
+ * process holding it, so that others stop waiting if it dies.
+ */
+class cmCPackStagedInstall
+{
+public:
+  /** Refer to the install identified by key below the root directory.  */
+  cmCPackStagedInstall(std::string const& root, std::string const& key);
+
+  /** Load a staged install.  Returns false if there is none yet.  */
+  bool Load();
+
+  /** Wait until the install is either staged or ours to stage.  Sets
+      stage if the caller must stage it and then Commit.  Returns false
+      if the process staging it died without committing.  */
+  bool Acquire(bool& stage);
+
+  /** Get the reason Acquire failed.  */
+  std::string const& GetError() const { return this->Error; }
+
+  /** Get the directory in which to stage the install.  */
+  std::string GetTree() const { return this->Directory + "/tree"; }
+
+  /** Get the database of files installed into the tree.  */
+  std::string GetDatabase() const
+    { return this->Directory + "/install_database.txt"; }
+
+  /** Remove what is no longer installed and mark the install staged.  */
+  bool Commit();
+
+  /** Mark all installs staged below a root directory as out of date.
+      They are brought up to date when staged again.  */
+  static void Invalidate(std::string const& root);
+
+  /** Copy the staged install into a directory, or hardlink its files
+      where the platform supports it.  */
+  bool CopyTo(std::string const& dir, bool hardlink);
+
+  /** Get or set the absolute destination files reported by the install
+      script, which are not part of the staged tree.  */
+  std::string const& GetAbsoluteDestinationFiles() const
+    { return this->AbsoluteDestinationFiles; }
+  void SetAbsoluteDestinationFiles(const char* files)
+    { this->AbsoluteDestinationFiles = files? files : ""; }
+
+private:
+  std::string Directory;
+  std::string Error;
+  cmDirectoryLock Lock;
+  std::string AbsoluteDestinationFiles;
+
+  static bool CopyTree(std::string const& from, std::string const& to,
+                       bool hardlink);
+};
+
+#endif
@@ -24,8 +24,10 @@
 #include "cmMakefile.h"
 
 #include "cmCPackLog.h"
+#include "cmCPackStagedInstall.h"
 
 #include <cmsys/CommandLineArguments.hxx>
+#include <cmsys/Process.h>
 #include <cmsys/SystemTools.hxx>
 
 //----------------------------------------------------------------------------
@@ -92,6 +94,12 @@ static const char * cmDocumentationOptions[][3] =
      "If vendor is not specified on cpack command line "
      "(or inside CMakeLists.txt) then"
      "CPack.cmake defines it with a default value"},
+    {"-j <jobs>, --parallel <jobs>",
+     "Run the generators in parallel using the given number of jobs.",
+     "When several generators are given, the first one is run as usual "
+     "and the others are run by up to <jobs> cpack processes at a time.  "
+     "They reuse the installs staged by the first one, see "
+     "CPACK_REUSE_STAGED_INSTALL."},
     {"--help-command cmd [file]", "Print help for a single command and exit.",
     "Full documentation specific to the given command is displayed. "
     "If a file is specified, the documentation is written into and the output "
@@ -173,6 +181,66 @@ int cpackDefinitionArgument(const char* argument, const char* cValue,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+struct cpackChild
+{
+  std::string Generator;
+  std::vector<std::string> Command;
+  cmsysProcess* Process;
+};
+
+//----------------------------------------------------------------------------
+static bool cpackWaitForChild(cpackChild& child, cmCPackLog* log)
+{
+  cmsysProcess_WaitForExit(child.Process, 0);
+  bool ok = cmsysProcess_GetState(child.Process) == cmsysProcess_State_Exited
+    && cmsysProcess_GetExitValue(child.Process) == 0;
+  cmsysProcess_Delete(child.Process);
+  child.Process = 0;
+  if ( !ok )
+    {
+    cmCPack_Log(log, cmCPackLog::LOG_ERROR,
+      "Error when generating package with generator: "
+      << child.Generator << std::endl);
+    }
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+// Run each child cpack, at most jobs at a time.  Their output goes
+// straight to ours.
+static bool cpackRunChildren(std::vector<cpackChild>& children,
+                             unsigned int jobs, cmCPackLog* log)
+{
+  bool ok = true;
+  size_t waited = 0;
+  for ( size_t i = 0; i < children.size(); ++i )
+    {
+    std::vector<const char*> argv;
+    for ( std::vector<std::string>::const_iterator ai =
+            children[i].Command.begin();
+          ai != children[i].Command.end(); ++ai )
+      {
+      argv.push_back(ai->c_str());
+      }
+    argv.push_back(0);
+    cmsysProcess* cp = cmsysProcess_New();
+    cmsysProcess_SetCommand(cp, &*argv.begin());
+    cmsysProcess_SetPipeShared(cp, cmsysProcess_Pipe_STDOUT, 1);
+    cmsysProcess_SetPipeShared(cp, cmsysProcess_Pipe_STDERR, 1);
+    cmsysProcess_Execute(cp);
+    children[i].Process = cp;
+    if ( i + 1 - waited >= jobs )
+      {
+      ok = cpackWaitForChild(children[waited++], log) && ok;
+      }
+    }
+  while ( waited < children.size() )
+    {
+    ok = cpackWaitForChild(children[waited++], log) && ok;
+    }
+  return ok;
+}
 
 //----------------------------------------------------------------------------
 // this is CPack.
@@ -211,6 +279,7 @@ int main (int argc, char *argv[])
   std::string cpackProjectPatch;
   std::string cpackProjectVendor;
   std::string cpackConfigFile;
+  int jobs = 1;
 
   cpackDefinitions definitions;
   definitions.Log = &log;
@@ -248,6 +317,8 @@ int main (int argc, char *argv[])
     &cpackProjectPatch, "CPack project patch");
   arg.AddArgument("--vendor", argT::SPACE_ARGUMENT,
     &cpackProjectVendor, "CPack project vendor");
+  arg.AddArgument("-j", argT::SPACE_ARGUMENT, &jobs, "CPack jobs");
+  arg.AddArgument("--parallel", argT::SPACE_ARGUMENT, &jobs, "-j");
   arg.AddCallback("-D", argT::SPACE_ARGUMENT,
     cpackDefinitionArgument, &definitions, "CPack Definitions");
   arg.SetUnknownArgumentCallback(cpackUnknownArgument);
@@ -371,6 +442,63 @@ int main (int argc, char *argv[])
       globalMF->AddDefinition("CPACK_PACKAGE_VENDOR",
         cpackProjectVendor.c_str());
       }
+    // Child cpack processes get the same command line options.
+    std::vector<std::string> childCommand;
+    childCommand.push_back(std::string(
+        cmSystemTools::GetExecutableDirectory()) + "/cpack" +
+      cmSystemTools::GetExecutableExtension());
+    if ( cmSystemTools::FileExists(cpackConfigFile.c_str()) )
+      {
+      childCommand.push_back("--config");
+      childCommand.push_back(cpackConfigFile);
+      }
+    if ( verbose )
+      {
+      childCommand.push_back("--verbose");
+      }
+    if ( debug )
+      {
+      childCommand.push_back("--debug");
+      }
+    if ( !cpackBuildConfig.empty() )
+      {
+      childCommand.push_back("-C");
+      childCommand.push_back(cpackBuildConfig);
+      }
+    if ( !cpackProjectName.empty() )
+      {
+      childCommand.push_back("-P");
+      childCommand.push_back(cpackProjectName);
+      }
+    if ( !cpackProjectVersion.empty() )
+      {
+      childCommand.push_back("-R");
+      childCommand.push_back(cpackProjectVersion);
+      }
+    if ( !cpackProjectDirectory.empty() )
+      {
+      childCommand.push_back("-B");
+      childCommand.push_back(cpackProjectDirectory);
+      }
+    if ( !cpackProjectPatch.empty() )
+      {
+      childCommand.push_back("--patch");
+      childCommand.push_back(cpackProjectPatch);
+      }
+    if ( !cpackProjectVendor.empty() )
+      {
+      childCommand.push_back("--vendor");
+      childCommand.push_back(cpackProjectVendor);
+      }
+    for ( cpackDefinitions::MapType::iterator cdit =
+            definitions.Map.begin();
+          cdit != definitions.Map.end();
+          ++cdit )
+      {
+      childCommand.push_back("-D");
+      childCommand.push_back(cdit->first + "=" + cdit->second);
+      }
+
     // if this is not empty it has been set on the command line
     // go for it. Command line override values set in config file.
     if ( !cpackProjectDirectory.empty() )
@@ -420,12 +548,54 @@ int main (int argc, char *argv[])
       std::vector<std::string> generatorsVector;
       cmSystemTools::ExpandListArgument(genList,
         generatorsVector);
+
+      // Stage the installs of the first generator for the others to
+      // reuse.  Installs staged by a previous run are brought up to
+      // date instead of being staged from scratch.  Child processes
+      // are given the staging directory of their parent.
+      std::string stagingDirectory;
+      const char* reuse = globalMF->GetDefinition(
+        "CPACK_REUSE_STAGED_INSTALL");
+      if ( generatorsVector.size() > 1 &&
+           !globalMF->GetDefinition("CPACK_STAGED_INSTALL_DIRECTORY") &&
+           (!reuse || !cmSystemTools::IsOff(reuse)) )
+        {
+        stagingDirectory =
+          globalMF->GetSafeDefinition("CPACK_PACKAGE_DIRECTORY");
+        stagingDirectory += "/_CPack_Packages/";
+        const char* tag = globalMF->GetDefinition("CPACK_TOPLEVEL_TAG");
+        if ( tag )
+          {
+          stagingDirectory += tag;
+          stagingDirectory += "/";
+          }
+        stagingDirectory += "_Staging";
+        cmCPackStagedInstall::Invalidate(stagingDirectory);
+        globalMF->AddDefinition("CPACK_STAGED_INSTALL_DIRECTORY",
+                                stagingDirectory.c_str());
+        childCommand.push_back("-D");
+        childCommand.push_back("CPACK_STAGED_INSTALL_DIRECTORY=" +
+                               stagingDirectory);
+        }
+
+      std::vector<cpackChild> children;
       std::vector<std::string>::iterator it;
       for ( it = generatorsVector.begin();
         it != generatorsVector.end();
         ++it )
         {
         const char* gen = it->c_str();
+        if ( parsed && jobs > 1 && it != generatorsVector.begin() )
+          {
+          cpackChild child;
+          child.Generator = gen;
+          child.Command = childCommand;
+          child.Command.push_back("-G");
+          child.Command.push_back(gen);
+          child.Process = 0;
+          children.push_back(child);
+          continue;
+          }
         cmMakefile newMF(*globalMF);
         cmMakefile* mf = &newMF;
         cmCPack_Log(&log, cmCPackLog::LOG_VERBOSE,
@@ -519,6 +689,12 @@ int main (int argc, char *argv[])
             }
           }
         }
+      if ( parsed && !children.empty() &&
+           !cpackRunChildren(children, static_cast<unsigned int>(jobs),
+                             &log) )
+        {
+        return 1;
+        }
       }
     }
 
@@ -69,7 +69,10 @@ public:
       "The RETURN_VALUE option specifies a variable in which to store the "
       "return value of the native build tool. "
       "The NUMBER_ERRORS and NUMBER_WARNINGS options specify variables in "
-      "which to store the number of build errors and warnings detected."
+      "which to store the number of build errors and warnings detected.\n"
+      "The build output is checked for errors and warnings on several "
+      "threads.  Set CTEST_CUSTOM_BUILD_SCAN_THREADS to the number of "
+      "threads to use instead of the number of processors."
       "\n"
       CTEST_COMMAND_APPEND_OPTION_DOCS;
     }
@@ -20,6 +20,7 @@
 #include "cmGeneratedFileStream.h"
 #include "cmXMLSafe.h"
 #include "cmFileTimeComparison.h"
+#include "cmWorkerPool.h"
 
 //#include <cmsys/RegularExpression.hxx>
 #include <cmsys/Process.h>
@@ -184,12 +185,41 @@ cmCTestBuildHandler::cmCTestBuildHandler()
 
   this->MaxErrors = 50;
   this->MaxWarnings = 50;
+  this->ScanThreads = 0;
 
   this->LastErrorOrWarning = this->ErrorsAndWarnings.end();
 
+  this->PendingLinesSize = 0;
+
   this->UseCTestLaunch = false;
 }
 
+//----------------------------------------------------------------------
+void cmCTestBuildHandler::GetDefaultRegularExpressions(
+  std::vector<std::string>& errors,
+  std::vector<std::string>& errorExceptions,
+  std::vector<std::string>& warnings,
+  std::vector<std::string>& warningExceptions)
+{
+  int cc;
+  for ( cc = 0; cmCTestErrorMatches[cc]; cc ++ )
+    {
+    errors.push_back(cmCTestErrorMatches[cc]);
+    }
+  for ( cc = 0; cmCTestErrorExceptions[cc]; cc ++ )
+    {
+    errorExceptions.push_back(cmCTestErrorExceptions[cc]);
+    }
+  for ( cc = 0; cmCTestWarningMatches[cc]; cc ++ )
+    {
+    warnings.push_back(cmCTestWarningMatches[cc]);
+    }
+  for ( cc = 0; cmCTestWarningExceptions[cc]; cc ++ )
+    {
+    warningExceptions.push_back(cmCTestWarningExceptions[cc]);
+    }
+}
+
 //----------------------------------------------------------------------
 void cmCTestBuildHandler::Initialize()
 {
@@ -208,10 +238,15 @@ void cmCTestBuildHandler::Initialize()
   this->ErrorExceptionRegex.clear();
   this->WarningMatchRegex.clear();
   this->WarningExceptionRegex.clear();
+  this->ErrorMatchFilter.Clear();
+  this->ErrorExceptionFilter.Clear();
+  this->WarningMatchFilter.Clear();
+  this->WarningExceptionFilter.Clear();
   this->BuildProcessingQueue.clear();
   this->BuildProcessingErrorQueue.clear();
   this->BuildOutputLogSize = 0;
-  this->CurrentProcessingLine.clear();
+  this->PendingLines.clear();
+  this->PendingLinesSize = 0;
 
   this->SimplifySourceDir = "";
   this->SimplifyBuildDir = "";
@@ -232,6 +267,7 @@ void cmCTestBuildHandler::Initialize()
 
   this->MaxErrors = 50;
   this->MaxWarnings = 50;
+  this->ScanThreads = 0;
 
   this->UseCTestLaunch = false;
 }
@@ -253,6 +289,9 @@ void cmCTestBuildHandler::PopulateCustomVectors(cmMakefile *mf)
   this->CTest->PopulateCustomInteger(mf,
                              "CTEST_CUSTOM_MAXIMUM_NUMBER_OF_WARNINGS",
                              this->MaxWarnings);
+  this->CTest->PopulateCustomInteger(mf,
+                             "CTEST_CUSTOM_BUILD_SCAN_THREADS",
+                             this->ScanThreads);
 
   int n = -1;
   this->CTest->PopulateCustomInteger(mf, "CTEST_CUSTOM_ERROR_PRE_CONTEXT", n);
@@ -401,8 +440,9 @@ int cmCTestBuildHandler::ProcessHandler()
   // Pre-compile regular expressions objects for all regular expressions
   std::vector<cmStdString>::iterator it;
 
-#define cmCTestBuildHandlerPopulateRegexVector(strings, regexes) \
+#define cmCTestBuildHandlerPopulateRegexVector(strings, regexes, filter) \
   regexes.clear(); \
+  filter.Clear(); \
     cmCTestLog(this->CTest, DEBUG, this << "Add " #regexes \
     << std::endl); \
   for ( it = strings.begin(); it != strings.end(); ++it ) \
@@ -410,15 +450,21 @@ int cmCTestBuildHandler::ProcessHandler()
     cmCTestLog(this->CTest, DEBUG, "Add " #strings ": " \
     << it->c_str() << std::endl); \
     regexes.push_back(it->c_str()); \
-    }
+    filter.AddPattern(it->c_str()); \
+    } \
+  filter.Compile()
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomErrorMatches, this->ErrorMatchRegex);
+    this->CustomErrorMatches, this->ErrorMatchRegex,
+    this->ErrorMatchFilter);
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomErrorExceptions, this->ErrorExceptionRegex);
+    this->CustomErrorExceptions, this->ErrorExceptionRegex,
+    this->ErrorExceptionFilter);
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomWarningMatches, this->WarningMatchRegex);
+    this->CustomWarningMatches, this->WarningMatchRegex,
+    this->WarningMatchFilter);
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomWarningExceptions, this->WarningExceptionRegex);
+    this->CustomWarningExceptions, this->WarningExceptionRegex,
+    this->WarningExceptionFilter);
 
 
   // Determine source and binary tree substitutions to simplify the output.
@@ -938,6 +984,8 @@ int cmCTestBuildHandler::RunMakeCommand(const char* command,
 
   // Initialize building structures
   this->BuildProcessingQueue.clear();
+  this->PendingLines.clear();
+  this->PendingLinesSize = 0;
   this->OutputLineCounter = 0;
   this->ErrorsAndWarnings.clear();
   this->TotalErrors = 0;
@@ -1053,131 +1101,24 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
   t_BuildProcessingQueueType* queue)
 {
   const std::string::size_type tick_line_len = 50;
-  const char* ptr;
-  for ( ptr = data; ptr < data+length; ptr ++ )
-    {
-    queue->push_back(*ptr);
-    }
+  queue->append(data, length);
   this->BuildOutputLogSize += length;
 
-  // until there are any lines left in the buffer
-  while ( 1 )
+  // Move the complete lines to those waiting to be scanned.  They are
+  // scanned in batches large enough to be worth spreading over the
+  // worker threads, and all of them once the output ends.
+  std::string::size_type start = 0;
+  std::string::size_type end;
+  while((end = queue->find('\n', start)) != std::string::npos)
     {
-    // Find the end of line
-    t_BuildProcessingQueueType::iterator it;
-    for ( it = queue->begin();
-      it != queue->end();
-      ++ it )
-      {
-      if ( *it == '\n' )
-        {
-        break;
-        }
-      }
-
-    // Once certain number of errors or warnings reached, ignore future errors
-    // or warnings.
-    if ( this->TotalWarnings >= this->MaxWarnings )
-      {
-      this->WarningQuotaReached = true;
-      }
-    if ( this->TotalErrors >= this->MaxErrors )
-      {
-      this->ErrorQuotaReached = true;
-      }
-
-    // If the end of line was found
-    if ( it != queue->end() )
-      {
-      // Create a contiguous array for the line
-      this->CurrentProcessingLine.clear();
-      t_BuildProcessingQueueType::iterator cit;
-      for ( cit = queue->begin(); cit != it; ++cit )
-        {
-        this->CurrentProcessingLine.push_back(*cit);
-        }
-      this->CurrentProcessingLine.push_back(0);
-      const char* line = &*this->CurrentProcessingLine.begin();
-
-      // Process the line
-      int lineType = this->ProcessSingleLine(line);
-
-      // Erase the line from the queue
-      queue->erase(queue->begin(), it+1);
-
-      // Depending on the line type, produce error or warning, or nothing
-      cmCTestBuildErrorWarning errorwarning;
-      bool found = false;
-      switch ( lineType )
-        {
-      case b_WARNING_LINE:
-        this->LastTickChar = '*';
-        errorwarning.Error = false;
-        found = true;
-        this->TotalWarnings ++;
-        break;
-      case b_ERROR_LINE:
-        this->LastTickChar = '!';
-        errorwarning.Error = true;
-        found = true;
-        this->TotalErrors ++;
-        break;
-        }
-      if ( found )
-        {
-        // This is an error or warning, so generate report
-        errorwarning.LogLine   = static_cast<int>(this->OutputLineCounter+1);
-        errorwarning.Text        = line;
-        errorwarning.PreContext  = "";
-        errorwarning.PostContext = "";
-
-        // Copy pre-context to report
-        std::deque<cmStdString>::iterator pcit;
-        for ( pcit = this->PreContext.begin();
-          pcit != this->PreContext.end();
-          ++pcit )
-          {
-          errorwarning.PreContext += *pcit + "\n";
-          }
-        this->PreContext.clear();
-
-        // Store report
-        this->ErrorsAndWarnings.push_back(errorwarning);
-        this->LastErrorOrWarning = this->ErrorsAndWarnings.end()-1;
-        this->PostContextCount = 0;
-        }
-      else
-        {
-        // This is not an error or warning.
-        // So, figure out if this is a post-context line
-        if ( this->ErrorsAndWarnings.size() &&
-             this->LastErrorOrWarning != this->ErrorsAndWarnings.end() &&
-             this->PostContextCount < this->MaxPostContext )
-          {
-          this->PostContextCount ++;
-          this->LastErrorOrWarning->PostContext += line;
-          if ( this->PostContextCount < this->MaxPostContext )
-            {
-            this->LastErrorOrWarning->PostContext += "\n";
-            }
-          }
-        else
-          {
-          // Otherwise store pre-context for the next error
-          this->PreContext.push_back(line);
-          if ( this->PreContext.size() > this->MaxPreContext )
-            {
-            this->PreContext.erase(this->PreContext.begin(),
-              this->PreContext.end()-this->MaxPreContext);
-            }
-          }
-        }
-      this->OutputLineCounter ++;
-      }
-    else
-      {
-      break;
-      }
+    this->PendingLines.push_back(queue->substr(start, end - start));
+    this->PendingLinesSize += end - start + 1;
+    start = end + 1;
+    }
+  queue->erase(0, start);
+  if(!data || this->PendingLinesSize >= 256 * 1024)
+    {
+    this->ScanPendingLines();
     }
 
   // Now that the buffer is processed, display missing ticks
@@ -1208,7 +1149,200 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
 }
 
 //----------------------------------------------------------------------
-int cmCTestBuildHandler::ProcessSingleLine(const char* data)
+class cmCTestBuildHandler::ScanJob: public cmWorkerPool::Job
+{
+public:
+  // Each job matches with copies of the regular expressions since
+  // matching stores its results in them.
+  ScanJob(cmCTestBuildHandler* handler, size_t begin, size_t end):
+    Handler(handler), Begin(begin), End(end),
+    MatchErrors(handler->TotalErrors < handler->MaxErrors),
+    MatchWarnings(handler->TotalWarnings < handler->MaxWarnings),
+    ErrorMatchRegex(handler->ErrorMatchRegex),
+    ErrorExceptionRegex(handler->ErrorExceptionRegex),
+    WarningMatchRegex(handler->WarningMatchRegex),
+    WarningExceptionRegex(handler->WarningExceptionRegex)
+    {}
+  std::vector<LineMatch> Matches;
+  virtual void Run()
+    {
+    this->Matches.resize(this->End - this->Begin);
+    for(size_t i = this->Begin; i < this->End; ++i)
+      {
+      const char* line = this->Handler->PendingLines[i].c_str();
+      LineMatch& match = this->Matches[i - this->Begin];
+      match.Error = match.ErrorException = -1;
+      match.Warning = match.WarningException = -1;
+      if(this->MatchErrors)
+        {
+        match.Error = this->Handler->ErrorMatchFilter.Find(
+          this->ErrorMatchRegex, line);
+        match.ErrorException = this->Handler->ErrorExceptionFilter.Find(
+          this->ErrorExceptionRegex, line);
+        }
+      if(this->MatchWarnings)
+        {
+        match.Warning = this->Handler->WarningMatchFilter.Find(
+          this->WarningMatchRegex, line);
+        match.WarningException = this->Handler->WarningExceptionFilter.Find(
+          this->WarningExceptionRegex, line);
+        }
+      }
+    }
+private:
+  cmCTestBuildHandler* Handler;
+  size_t Begin;
+  size_t End;
+  // Lines past the limit on the number of errors or warnings are not
+  // checked for them.  The limits are known to be reached before the
+  // batch when these are false and may be reached within it otherwise.
+  bool MatchErrors;
+  bool MatchWarnings;
+  std::vector<cmsys::RegularExpression> ErrorMatchRegex;
+  std::vector<cmsys::RegularExpression> ErrorExceptionRegex;
+  std::vector<cmsys::RegularExpression> WarningMatchRegex;
+  std::vector<cmsys::RegularExpression> WarningExceptionRegex;
+};
+
+//----------------------------------------------------------------------
+void cmCTestBuildHandler::ScanPendingLines()
+{
+  size_t count = this->PendingLines.size();
+  std::vector<ScanJob*> jobs;
+  if(!this->UseCTestLaunch && count > 0)
+    {
+    // Give each thread a few thousand lines at least, unless the
+    // number of threads is given.
+    size_t threads = cmWorkerPool::GetDefaultThreadCount();
+    size_t maxJobs = count / 4096 + 1;
+    if(this->ScanThreads > 0)
+      {
+      threads = static_cast<size_t>(this->ScanThreads);
+      maxJobs = count;
+      }
+    size_t numJobs = threads < maxJobs? threads : maxJobs;
+    for(size_t j = 0; j < numJobs; ++j)
+      {
+      jobs.push_back(new ScanJob(this, count * j / numJobs,
+                                 count * (j + 1) / numJobs));
+      }
+    std::vector<cmWorkerPool::Job*> poolJobs(jobs.begin(), jobs.end());
+    cmWorkerPool::RunJobs(poolJobs, static_cast<unsigned int>(numJobs));
+    }
+
+  // Report the lines in order since the contexts and the limits on the
+  // number of errors and warnings depend on the lines before.
+  LineMatch none = { -1, -1, -1, -1 };
+  size_t i = 0;
+  for(std::vector<ScanJob*>::iterator ji = jobs.begin();
+      ji != jobs.end(); ++ji)
+    {
+    for(std::vector<LineMatch>::const_iterator mi = (*ji)->Matches.begin();
+        mi != (*ji)->Matches.end(); ++mi, ++i)
+      {
+      this->ProcessLine(this->PendingLines[i].c_str(), *mi);
+      }
+    delete *ji;
+    }
+  for(; i < count; ++i)
+    {
+    this->ProcessLine(this->PendingLines[i].c_str(), none);
+    }
+  this->PendingLines.clear();
+  this->PendingLinesSize = 0;
+}
+
+//----------------------------------------------------------------------
+void cmCTestBuildHandler::ProcessLine(const char* line,
+                                      LineMatch const& match)
+{
+  // Once certain number of errors or warnings reached, ignore future errors
+  // or warnings.
+  if ( this->TotalWarnings >= this->MaxWarnings )
+    {
+    this->WarningQuotaReached = true;
+    }
+  if ( this->TotalErrors >= this->MaxErrors )
+    {
+    this->ErrorQuotaReached = true;
+    }
+
+  // Process the line
+  int lineType = this->ProcessSingleLine(line, match);
+
+  // Depending on the line type, produce error or warning, or nothing
+  cmCTestBuildErrorWarning errorwarning;
+  bool found = false;
+  switch ( lineType )
+    {
+  case b_WARNING_LINE:
+    this->LastTickChar = '*';
+    errorwarning.Error = false;
+    found = true;
+    this->TotalWarnings ++;
+    break;
+  case b_ERROR_LINE:
+    this->LastTickChar = '!';
+    errorwarning.Error = true;
+    found = true;
+    this->TotalErrors ++;
+    break;
+    }
+  if ( found )
+    {
+    // This is an error or warning, so generate report
+    errorwarning.LogLine   = static_cast<int>(this->OutputLineCounter+1);
+    errorwarning.Text        = line;
+    errorwarning.PreContext  = "";
+    errorwarning.PostContext = "";
+
+    // Copy pre-context to report
+    std::deque<cmStdString>::iterator pcit;
+    for ( pcit = this->PreContext.begin();
+      pcit != this->PreContext.end();
+      ++pcit )
+      {
+      errorwarning.PreContext += *pcit + "\n";
+      }
+    this->PreContext.clear();
+
+    // Store report
+    this->ErrorsAndWarnings.push_back(errorwarning);
+    this->LastErrorOrWarning = this->ErrorsAndWarnings.end()-1;
+    this->PostContextCount = 0;
+    }
+  else
+    {
+    // This is not an error or warning.
+    // So, figure out if this is a post-context line
+    if ( this->ErrorsAndWarnings.size() &&
+         this->LastErrorOrWarning != this->ErrorsAndWarnings.end() &&
+         this->PostContextCount < this->MaxPostContext )
+      {
+      this->PostContextCount ++;
+      this->LastErrorOrWarning->PostContext += line;
+      if ( this->PostContextCount < this->MaxPostContext )
+        {
+        this->LastErrorOrWarning->PostContext += "\n";
+        }
+      }
+    else
+      {
+      // Otherwise store pre-context for the next error
+      this->PreContext.push_back(line);
+      if ( this->PreContext.size() > this->MaxPreContext )
+        {
+        this->PreContext.erase(this->PreContext.begin(),
+          this->PreContext.end()-this->MaxPreContext);
+        }
+      }
+    }
+  this->OutputLineCounter ++;
+}
+
+//----------------------------------------------------------------------
+int cmCTestBuildHandler::ProcessSingleLine(const char* data,
+                                           LineMatch const& match)
 {
   if(this->UseCTestLaunch)
     {
@@ -1218,83 +1352,51 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
 
   cmCTestLog(this->CTest, DEBUG, "Line: [" << data << "]" << std::endl);
 
-  std::vector<cmsys::RegularExpression>::iterator it;
-
   int warningLine = 0;
   int errorLine = 0;
 
-  // Check for regular expressions
+  // Check the regular expressions matched by the scan
 
   if ( !this->ErrorQuotaReached )
     {
     // Errors
-    int wrxCnt = 0;
-    for ( it = this->ErrorMatchRegex.begin();
-      it != this->ErrorMatchRegex.end();
-      ++ it )
+    if ( match.Error >= 0 )
       {
-      if ( it->find(data) )
-        {
-        errorLine = 1;
-        cmCTestLog(this->CTest, DEBUG, "  Error Line: " << data
-          << " (matches: " << this->CustomErrorMatches[wrxCnt] << ")"
-          << std::endl);
-        break;
-        }
-      wrxCnt ++;
+      errorLine = 1;
+      cmCTestLog(this->CTest, DEBUG, "  Error Line: " << data
+        << " (matches: " << this->CustomErrorMatches[match.Error] << ")"
+        << std::endl);
       }
     // Error exceptions
-    wrxCnt = 0;
-    for ( it = this->ErrorExceptionRegex.begin();
-      it != this->ErrorExceptionRegex.end();
-      ++ it )
+    if ( match.ErrorException >= 0 )
       {
-      if ( it->find(data) )
-        {
-        errorLine = 0;
-        cmCTestLog(this->CTest, DEBUG, "  Not an error Line: " << data
-          << " (matches: " << this->CustomErrorExceptions[wrxCnt] << ")"
-          << std::endl);
-        break;
-        }
-      wrxCnt ++;
+      errorLine = 0;
+      cmCTestLog(this->CTest, DEBUG, "  Not an error Line: " << data
+        << " (matches: "
+        << this->CustomErrorExceptions[match.ErrorException] << ")"
+        << std::endl);
       }
     }
   if ( !this->WarningQuotaReached )
     {
     // Warnings
-    int wrxCnt = 0;
-    for ( it = this->WarningMatchRegex.begin();
-      it != this->WarningMatchRegex.end();
-      ++ it )
+    if ( match.Warning >= 0 )
       {
-      if ( it->find(data) )
-        {
-        warningLine = 1;
-        cmCTestLog(this->CTest, DEBUG,
-          "  Warning Line: " << data
-          << " (matches: " << this->CustomWarningMatches[wrxCnt] << ")"
-          << std::endl);
-        break;
-        }
-      wrxCnt ++;
+      warningLine = 1;
+      cmCTestLog(this->CTest, DEBUG,
+        "  Warning Line: " << data
+        << " (matches: " << this->CustomWarningMatches[match.Warning] << ")"
+        << std::endl);
       }
 
-    wrxCnt = 0;
     // Warning exceptions
-    for ( it = this->WarningExceptionRegex.begin();
-      it != this->WarningExceptionRegex.end();
-      ++ it )
+    if ( match.WarningException >= 0 )
       {
-      if ( it->find(data) )
-        {
-        warningLine = 0;
-        cmCTestLog(this->CTest, DEBUG, "  Not a warning Line: " << data
-          << " (matches: " << this->CustomWarningExceptions[wrxCnt] << ")"
-          << std::endl);
-        break;
-        }
-      wrxCnt ++;
+      warningLine = 0;
+      cmCTestLog(this->CTest, DEBUG, "  Not a warning Line: " << data
+        << " (matches: "
+        << this->CustomWarningExceptions[match.WarningException] << ")"
+        << std::endl);
       }
     }
   if ( errorLine )
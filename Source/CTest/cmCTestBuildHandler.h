@@ -17,6 +17,8 @@
 #include "cmCTestGenericHandler.h"
 #include "cmListFileCache.h"
 
+#include "cmRegexPrefilter.h"
+
 #include <cmsys/RegularExpression.hxx>
 
 class cmMakefile;
@@ -47,6 +49,16 @@ public:
   int GetTotalErrors() { return this->TotalErrors;}
   int GetTotalWarnings() { return this->TotalWarnings;}
 
+  /**
+   * Get the default regular expressions for errors, error exceptions,
+   * warnings and warning exceptions in build output.
+   */
+  static void GetDefaultRegularExpressions(
+    std::vector<std::string>& errors,
+    std::vector<std::string>& errorExceptions,
+    std::vector<std::string>& warnings,
+    std::vector<std::string>& warningExceptions);
+
 private:
   std::string GetMakeCommand();
 
@@ -109,17 +121,39 @@ private:
   std::vector<cmsys::RegularExpression> ErrorExceptionRegex;
   std::vector<cmsys::RegularExpression> WarningMatchRegex;
   std::vector<cmsys::RegularExpression> WarningExceptionRegex;
+  // Rule out most of the regular expressions above before matching.
+  cmRegexPrefilter ErrorMatchFilter;
+  cmRegexPrefilter ErrorExceptionFilter;
+  cmRegexPrefilter WarningMatchFilter;
+  cmRegexPrefilter WarningExceptionFilter;
 
-  typedef std::deque<char> t_BuildProcessingQueueType;
+  typedef std::string t_BuildProcessingQueueType;
+
+  // The first error, error exception, warning and warning exception
+  // regular expressions matching a line, or -1 for none.
+  struct LineMatch
+  {
+    int Error;
+    int ErrorException;
+    int Warning;
+    int WarningException;
+  };
+  class ScanJob;
+  friend class ScanJob;
 
   void ProcessBuffer(const char* data, int length, size_t& tick,
     size_t tick_len, std::ofstream& ofs, t_BuildProcessingQueueType* queue);
-  int ProcessSingleLine(const char* data);
+  // Match the complete lines read so far on worker threads and then
+  // process them in order.
+  void ScanPendingLines();
+  void ProcessLine(const char* line, LineMatch const& match);
+  int ProcessSingleLine(const char* data, LineMatch const& match);
 
   t_BuildProcessingQueueType            BuildProcessingQueue;
   t_BuildProcessingQueueType            BuildProcessingErrorQueue;
   size_t                                BuildOutputLogSize;
-  std::vector<char>                     CurrentProcessingLine;
+  std::vector<std::string>              PendingLines;
+  size_t                                PendingLinesSize;
 
   cmStdString                           SimplifySourceDir;
   cmStdString                           SimplifyBuildDir;
@@ -141,6 +175,8 @@ private:
 
   int                                   MaxErrors;
   int                                   MaxWarnings;
+  // Threads to scan the build output on, or 0 for a default.
+  int                                   ScanThreads;
 
   bool UseCTestLaunch;
   std::string CTestLaunchDir;
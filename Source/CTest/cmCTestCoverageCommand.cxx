@@ -25,6 +25,10 @@ cmCTestGenericHandler* cmCTestCoverageCommand::InitializeHandler()
 {
   this->CTest->SetCTestConfigurationFromCMakeVariable(this->Makefile,
     "CoverageCommand", "CTEST_COVERAGE_COMMAND");
+  this->CTest->SetCTestConfigurationFromCMakeVariable(this->Makefile,
+    "CoverageExtraFlags", "CTEST_COVERAGE_EXTRA_FLAGS");
+  this->CTest->SetCTestConfigurationFromCMakeVariable(this->Makefile,
+    "CoverageCacheDirectory", "CTEST_COVERAGE_CACHE_DIRECTORY");
 
   cmCTestCoverageHandler* handler = static_cast<cmCTestCoverageHandler*>(
     this->CTest->GetInitializedHandler("coverage"));
@@ -64,6 +64,16 @@ public:
       "The LABELS option filters the coverage report to include only "
       "source files labeled with at least one of the labels specified."
       "\n"
+      "If CTEST_COVERAGE_CACHE_DIRECTORY is set, the line counts read "
+      "from each gcc .gcda file are cached in that directory together with "
+      "a hash of the file contents, so that unchanged coverage files are "
+      "not processed again by a later run.  Entries of .gcda files that "
+      "no longer exist are removed."
+      "\n"
+      "CTEST_COVERAGE_EXTRA_FLAGS holds options given to gcov.  gcov runs "
+      "on as many files at a time as given by the -j option of ctest, or "
+      "as there are processors when it is not given."
+      "\n"
       CTEST_COMMAND_APPEND_OPTION_DOCS;
     }
 
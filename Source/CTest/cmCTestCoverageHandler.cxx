@@ -13,6 +13,7 @@
 #include "cmParsePHPCoverage.h"
 #include "cmParseGTMCoverage.h"
 #include "cmParseCacheCoverage.h"
+#include "cmParseGCDACoverage.h"
 #include "cmCTest.h"
 #include "cmake.h"
 #include "cmMakefile.h"
@@ -23,6 +24,7 @@
 #include <cmsys/Process.h>
 #include <cmsys/RegularExpression.hxx>
 #include <cmsys/Glob.hxx>
+#include <cmsys/SystemInformation.hxx>
 #include <cmsys/stl/iterator>
 #include <cmsys/stl/algorithm>
 
@@ -127,6 +129,176 @@ private:
   double TimeOut;
 };
 
+//----------------------------------------------------------------------
+// Run gcov on a list of coverage files, several at a time.  Each
+// running process writes its .gcov files to a scratch directory of its
+// own.  Results are taken in list order and a scratch directory is
+// reused only once the results of the previous run in it were taken.
+class cmCTestCoverageHandlerGCovRuns
+{
+public:
+  struct Run
+  {
+    std::string Command;
+    std::string Directory;
+    std::string Output;
+    std::string Errors;
+    int RetVal;
+    bool Result;
+    bool Done;
+    cmsysProcess* Process;
+  };
+  cmCTestCoverageHandlerGCovRuns(size_t maxRunning):
+    MaxRunning(maxRunning > 0? maxRunning : 1), Next(0) {}
+  ~cmCTestCoverageHandlerGCovRuns()
+    {
+    for(std::vector<Run>::iterator ri = this->Runs.begin();
+        ri != this->Runs.end(); ++ri)
+      {
+      if(ri->Process)
+        {
+        cmsysProcess_Kill(ri->Process);
+        cmsysProcess_Delete(ri->Process);
+        }
+      }
+    }
+  void AddRun(std::string const& command, std::string const& tempDir)
+    {
+    char slot[64];
+    sprintf(slot, "/gcov-%lu",
+            static_cast<unsigned long>(this->Runs.size() % this->MaxRunning));
+    Run run;
+    run.Command = command;
+    run.Directory = tempDir + slot;
+    run.RetVal = 0;
+    run.Result = false;
+    run.Done = false;
+    run.Process = 0;
+    this->Runs.push_back(run);
+    }
+  // Wait for the given run, which follows all runs already taken, and
+  // return its results.
+  Run& Take(size_t index)
+    {
+    Run& run = this->Runs[index];
+    while(!run.Done)
+      {
+      while(this->Next < this->Runs.size() &&
+            this->Next < index + this->MaxRunning)
+        {
+        this->Start(this->Runs[this->Next++]);
+        }
+      // Sleep until a run has output or exits, then read them all.
+      std::vector<cmsysProcess*> running;
+      for(size_t i = index; i < this->Next; ++i)
+        {
+        if(!this->Runs[i].Done)
+          {
+          running.push_back(this->Runs[i].Process);
+          }
+        }
+      if(!running.empty())
+        {
+        double timeout = 1;
+        cmsysProcess_WaitForAny(&*running.begin(),
+                                static_cast<int>(running.size()), &timeout);
+        }
+      for(size_t i = index; i < this->Next; ++i)
+        {
+        if(!this->Runs[i].Done)
+          {
+          this->Poll(this->Runs[i]);
+          }
+        }
+      }
+    return run;
+    }
+private:
+  size_t MaxRunning;
+  size_t Next;
+  std::vector<Run> Runs;
+
+  void Start(Run& run)
+    {
+    cmSystemTools::MakeDirectory(run.Directory.c_str());
+    std::vector<cmStdString> args =
+      cmSystemTools::ParseArguments(run.Command.c_str());
+    std::vector<const char*> argv;
+    for(std::vector<cmStdString>::const_iterator a = args.begin();
+        a != args.end(); ++a)
+      {
+      argv.push_back(a->c_str());
+      }
+    argv.push_back(0);
+    run.Process = cmsysProcess_New();
+    cmsysProcess_SetCommand(run.Process, &*argv.begin());
+    cmsysProcess_SetWorkingDirectory(run.Process, run.Directory.c_str());
+    if(cmSystemTools::GetRunCommandHideConsole())
+      {
+      cmsysProcess_SetOption(run.Process, cmsysProcess_Option_HideWindow, 1);
+      }
+    cmsysProcess_Execute(run.Process);
+    if(cmsysProcess_GetState(run.Process) != cmsysProcess_State_Executing)
+      {
+      this->Finish(run);
+      }
+    }
+  // Read the output available without blocking and finish the run
+  // once the process has exited.
+  void Poll(Run& run)
+    {
+    char* data;
+    int length;
+    for(;;)
+      {
+      double timeout = 0;
+      int pipe = cmsysProcess_WaitForData(run.Process, &data, &length,
+                                          &timeout);
+      if(pipe == cmsysProcess_Pipe_STDOUT)
+        {
+        run.Output.append(data, length);
+        }
+      else if(pipe == cmsysProcess_Pipe_STDERR)
+        {
+        run.Errors.append(data, length);
+        }
+      else if(pipe == cmsysProcess_Pipe_None)
+        {
+        cmsysProcess_WaitForExit(run.Process, 0);
+        this->Finish(run);
+        return;
+        }
+      else
+        {
+        return;
+        }
+      }
+    }
+  // Record how the process ended as cmCTest::RunCommand does.
+  void Finish(Run& run)
+    {
+    int state = cmsysProcess_GetState(run.Process);
+    run.Result = true;
+    if(state == cmsysProcess_State_Exited)
+      {
+      run.RetVal = cmsysProcess_GetExitValue(run.Process);
+      }
+    else if(state == cmsysProcess_State_Exception)
+      {
+      run.Errors += cmsysProcess_GetExceptionString(run.Process);
+      run.Result = false;
+      }
+    else if(state == cmsysProcess_State_Error)
+      {
+      run.Errors += cmsysProcess_GetErrorString(run.Process);
+      run.Result = false;
+      }
+    cmsysProcess_Delete(run.Process);
+    run.Process = 0;
+    run.Done = true;
+    }
+};
+
 
 //----------------------------------------------------------------------
 
@@ -449,6 +621,10 @@ int cmCTestCoverageHandler::ProcessHandler()
     fileIterator != cont.TotalCoverage.end();
     ++fileIterator )
     {
+    // Take the counts of this file out of the map so that they are
+    // freed once its XML is written.
+    cmCTestCoverageHandlerContainer::SingleFileCoverageVector fcov;
+    fcov.swap(fileIterator->second);
     cmCTestLog(this->CTest, HANDLER_OUTPUT, "." << std::flush);
     file_count ++;
     if ( file_count % 50 == 0 )
@@ -496,8 +672,6 @@ int cmCTestCoverageHandler::ProcessHandler()
       = cmSystemTools::GetFilenameName(fullFileName.c_str());
     std::string shortFileName =
       this->CTest->GetShortPathToFile(fullFileName.c_str());
-    const cmCTestCoverageHandlerContainer::SingleFileCoverageVector& fcov
-      = fileIterator->second;
     covLogFile << "\t<File Name=\"" << cmXMLSafe(fileName)
       << "\" FullPath=\"" << cmXMLSafe(shortFileName) << "\">\n"
       << "\t\t<Report>" << std::endl;
@@ -897,30 +1071,70 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
 
   // files is a list of *.da and *.gcda files with coverage data in them.
   // These are binary files that you give as input to gcov so that it will
-  // give us text output we can analyze to summarize coverage.
+  // give us text output we can analyze to summarize coverage.  Files in a
+  // format we understand are read directly when gcov would be run with
+  // no options that change its output.  Run gcov on the rest, on as many
+  // of them at a time as ctest runs tests, or as there are processors
+  // when that is not given, and analyze the output in order.
   //
+  size_t maxRunning = this->CTest->GetParallelLevel();
+  if(!this->CTest->GetParallelLevelSet())
+    {
+    cmsys::SystemInformation info;
+    info.RunCPUCheck();
+    maxRunning = info.GetNumberOfLogicalCPU();
+    }
+  bool readFiles = this->CanReadGCovFiles();
+  cmParseGCDACoverage parser;
+  parser.SetCacheDirectory(
+    this->CTest->GetCTestConfiguration("CoverageCacheDirectory"));
+  GCovSourceMap sources;
+  cmCTestCoverageHandlerGCovRuns runs(maxRunning);
+  std::vector<std::string> gcovFiles;
   for ( it = files.begin(); it != files.end(); ++ it )
+    {
+    if ( readFiles && this->ReadGCovFile(cont, parser, *it, sources) )
+      {
+      cmCTestLog(this->CTest, HANDLER_OUTPUT, "." << std::flush);
+      file_count++;
+      if ( file_count % 50 == 0 )
+        {
+        cmCTestLog(this->CTest, HANDLER_OUTPUT, " processed: " << file_count
+          << " out of " << files.size() << std::endl);
+        cmCTestLog(this->CTest, HANDLER_OUTPUT, "    ");
+        }
+      continue;
+      }
+    std::string fileDir = cmSystemTools::GetFilenamePath(it->c_str());
+    runs.AddRun("\"" + gcovCommand + "\" " +
+                gcovExtraFlags + " " +
+                "-o \"" + fileDir + "\" " +
+                "\"" + *it + "\"", tempDir);
+    gcovFiles.push_back(*it);
+    }
+  parser.PruneCache();
+  for ( it = gcovFiles.begin(); it != gcovFiles.end(); ++ it )
     {
     cmCTestLog(this->CTest, HANDLER_OUTPUT, "." << std::flush);
 
-    // Call gcov to get coverage data for this *.gcda file:
+    // Get the coverage data gcov gave for this *.gcda file:
     //
     std::string fileDir = cmSystemTools::GetFilenamePath(it->c_str());
-    std::string command = "\"" + gcovCommand + "\" " +
-      gcovExtraFlags + " " +
-      "-o \"" + fileDir + "\" " +
-      "\"" + *it + "\"";
+    cmCTestCoverageHandlerGCovRuns::Run& run =
+      runs.Take(it - gcovFiles.begin());
+    std::string const& command = run.Command;
 
     cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, command.c_str()
       << std::endl);
 
-    std::string output = "";
-    std::string errors = "";
-    int retVal = 0;
+    std::string output;
+    std::string errors;
+    output.swap(run.Output);
+    errors.swap(run.Errors);
+    int retVal = run.RetVal;
     *cont->OFS << "* Run coverage for: " << fileDir.c_str() << std::endl;
     *cont->OFS << "  Command: " << command.c_str() << std::endl;
-    int res = this->CTest->RunCommand(command.c_str(), &output, &errors,
-      &retVal, tempDir.c_str(), 0 /*this->TimeOut*/);
+    int res = run.Result? 1 : 0;
 
     *cont->OFS << "  Output: " << output.c_str() << std::endl;
     *cont->OFS << "  Errors: " << errors.c_str() << std::endl;
@@ -1123,6 +1337,11 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
         cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "   in gcovFile: "
           << gcovFile << std::endl);
 
+        // gcov wrote the file to the directory it ran in.
+        if ( !cmSystemTools::FileIsFullPath(gcovFile.c_str()) )
+          {
+          gcovFile = run.Directory + "/" + gcovFile;
+          }
         std::ifstream ifile(gcovFile.c_str());
         if ( ! ifile )
           {
@@ -1254,6 +1473,132 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   return file_count;
 }
 
+//----------------------------------------------------------------------------
+bool cmCTestCoverageHandler::CanReadGCovFiles()
+{
+  // The counts we compute are those gcov writes without options, so
+  // only read coverage files ourselves for a gcov run with options that
+  // do not change the line counts.
+  std::string gcovCommand
+    = this->CTest->GetCTestConfiguration("CoverageCommand");
+  std::string name = cmSystemTools::GetFilenameName(gcovCommand);
+  if(!cmSystemTools::StringStartsWith(name.c_str(), "gcov"))
+    {
+    return false;
+    }
+  std::vector<cmStdString> flags = cmSystemTools::ParseArguments(
+    this->CTest->GetCTestConfiguration("CoverageExtraFlags").c_str());
+  for(std::vector<cmStdString>::const_iterator fi = flags.begin();
+      fi != flags.end(); ++fi)
+    {
+    if(*fi != "-l" && *fi != "--long-file-names" &&
+       *fi != "-p" && *fi != "--preserve-paths" &&
+       *fi != "-b" && *fi != "--branch-probabilities" &&
+       *fi != "-c" && *fi != "--branch-counts")
+      {
+      cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+        "   Running gcov for option: " << *fi << std::endl);
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmCTestCoverageHandler::ReadGCovFile(
+  cmCTestCoverageHandlerContainer* cont, cmParseGCDACoverage& parser,
+  std::string const& file, GCovSourceMap& sources)
+{
+  cmParseGCDACoverage::FileLinesType lines;
+  if(!parser.ReadGCDAFile(file.c_str(), lines))
+    {
+    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+      "   Running gcov on " << file << ": " << parser.GetError()
+      << std::endl);
+    return false;
+    }
+
+  *cont->OFS << "* Read coverage for: "
+    << cmSystemTools::GetFilenamePath(file).c_str()
+    << (parser.GetCacheHit()? " (cached)" : "") << std::endl;
+  *cont->OFS << "  File: " << file.c_str() << std::endl;
+  for(cmParseGCDACoverage::FileLinesType::const_iterator li = lines.begin();
+      li != lines.end(); ++li)
+    {
+    // Most sources, headers in particular, appear in many coverage
+    // files.  Look each of them up only once.
+    std::string const& sourceFile = li->first;
+    GCovSourceMap::iterator si = sources.find(sourceFile);
+    if(si == sources.end())
+      {
+      GCovSource source;
+      source.Dir = 0;
+      source.Lines = 0;
+      if(IsFileInDir(sourceFile, cont->SourceDir))
+        {
+        source.Dir = "source";
+        }
+      else if(IsFileInDir(sourceFile, cont->BinaryDir))
+        {
+        source.Dir = "binary";
+        }
+      else
+        {
+        cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+          "Cannot find file: [" << sourceFile.c_str() << "]" << std::endl);
+        *cont->OFS << "  Something went wrong. Cannot find file: "
+          << sourceFile.c_str()
+          << " in source dir: " << cont->SourceDir.c_str()
+          << " or binary dir: " << cont->BinaryDir.c_str() << std::endl;
+        }
+      if(source.Dir)
+        {
+        // A .gcov file has a line for every line of the source file.
+        source.FullPath =
+          cmSystemTools::CollapseFullPath(sourceFile.c_str());
+        std::ifstream ifs(source.FullPath.c_str());
+        std::string line;
+        while(cmSystemTools::GetLineFromStream(ifs, line))
+          {
+          ++source.Lines;
+          }
+        }
+      si = sources.insert(GCovSourceMap::value_type(sourceFile, source)).first;
+      }
+    GCovSource const& source = si->second;
+    if(!source.Dir)
+      {
+      continue;
+      }
+    *cont->OFS << "  produced in " << source.Dir << " dir: "
+      << sourceFile.c_str() << std::endl;
+    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "   read: "
+      << source.FullPath << std::endl);
+
+    // Add the counts the same way as those read from .gcov files.
+    cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec
+      = cont->TotalCoverage[source.FullPath];
+    std::vector<int> const& counts = li->second;
+    size_t size = counts.size() > source.Lines? counts.size() : source.Lines;
+    if(vec.size() < size)
+      {
+      vec.resize(size, -1);
+      }
+    for(size_t i = 0; i < counts.size(); ++i)
+      {
+      if(counts[i] >= 0)
+        {
+        if(vec[i] < 0)
+          {
+          vec[i] = 0;
+          }
+        vec[i] += counts[i];
+        }
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void cmCTestCoverageHandler::FindGCovFiles(std::vector<std::string>& files)
 {
@@ -20,6 +20,7 @@
 #include <cmsys/RegularExpression.hxx>
 
 class cmGeneratedFileStream;
+class cmParseGCDACoverage;
 class cmCTestCoverageHandlerContainer
 {
 public:
@@ -67,6 +68,19 @@ private:
   //! Handle coverage using GCC's GCov
   int HandleGCovCoverage(cmCTestCoverageHandlerContainer* cont);
   void FindGCovFiles(std::vector<std::string>& files);
+  bool CanReadGCovFiles();
+
+  // Where a source named in coverage files is and how many lines it has.
+  struct GCovSource
+  {
+    std::string FullPath;
+    const char* Dir;
+    size_t Lines;
+  };
+  typedef std::map<cmStdString, GCovSource> GCovSourceMap;
+  bool ReadGCovFile(cmCTestCoverageHandlerContainer* cont,
+                    cmParseGCDACoverage& parser, std::string const& file,
+                    GCovSourceMap& sources);
 
   //! Handle coverage using xdebug php coverage
   int HandlePHPCoverage(cmCTestCoverageHandlerContainer* cont);
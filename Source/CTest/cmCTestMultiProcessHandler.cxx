@@ -17,6 +17,7 @@
 #include <stdlib.h>
 #include <stack>
 #include <float.h>
+#include <math.h>
 
 class TestComparator
 {
@@ -24,11 +25,10 @@ public:
   TestComparator(cmCTestMultiProcessHandler* handler) : Handler(handler) {}
   ~TestComparator() {}
 
-  // Sorts tests in descending order of cost
+  // Sorts tests in descending order of priority
   bool operator() (int index1, int index2) const
     {
-    return Handler->Properties[index1]->Cost >
-      Handler->Properties[index2]->Cost;
+    return Handler->Priorities[index1] > Handler->Priorities[index2];
     }
 
 private:
@@ -41,6 +41,7 @@ cmCTestMultiProcessHandler::cmCTestMultiProcessHandler()
   this->Completed = 0;
   this->RunningCount = 0;
   this->StopTimePassed = false;
+  this->PredictedTime = -1;
 }
 
 cmCTestMultiProcessHandler::~cmCTestMultiProcessHandler()
@@ -84,6 +85,10 @@ void cmCTestMultiProcessHandler::RunTests()
     return;
     }
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
+  if(!this->ExpectedCosts.empty())
+    {
+    this->PredictedTime = this->PredictRunTime();
+    }
   this->StartNextTests();
   while(this->Tests.size() != 0)
     {
@@ -154,6 +159,14 @@ void cmCTestMultiProcessHandler::LockResources(int index)
     {
     this->LockedResources.insert(*i);
     }
+
+  std::map<std::string, double> needed;
+  this->GetResourcesNeeded(index, needed);
+  for(std::map<std::string, double>::const_iterator i = needed.begin();
+      i != needed.end(); ++i)
+    {
+    this->ResourcesInUse[i->first] += i->second;
+    }
 }
 
 //---------------------------------------------------------
@@ -165,6 +178,50 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
     {
     this->LockedResources.erase(*i);
     }
+
+  std::map<std::string, double> needed;
+  this->GetResourcesNeeded(index, needed);
+  for(std::map<std::string, double>::const_iterator i = needed.begin();
+      i != needed.end(); ++i)
+    {
+    this->ResourcesInUse[i->first] -= i->second;
+    }
+}
+
+//---------------------------------------------------------
+bool cmCTestMultiProcessHandler::HasResources(int index)
+{
+  std::map<std::string, double> needed;
+  this->GetResourcesNeeded(index, needed);
+  for(std::map<std::string, double>::const_iterator i = needed.begin();
+      i != needed.end(); ++i)
+    {
+    if(this->ResourcesInUse[i->first] + i->second >
+       this->ResourceCapacities[i->first])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//---------------------------------------------------------
+void
+cmCTestMultiProcessHandler::GetResourcesNeeded(int index,
+                                      std::map<std::string, double>& needed)
+{
+  std::map<std::string, double> const& resources =
+    this->Properties[index]->Resources;
+  for(std::map<std::string, double>::const_iterator i = resources.begin();
+      i != resources.end(); ++i)
+    {
+    std::map<std::string, double>::const_iterator c =
+      this->ResourceCapacities.find(i->first);
+    if(c != this->ResourceCapacities.end())
+      {
+      needed[i->first] = i->second < c->second? i->second : c->second;
+      }
+    }
 }
 
 //---------------------------------------------------------
@@ -204,6 +261,11 @@ bool cmCTestMultiProcessHandler::StartTest(int test)
       return false;
       }
     }
+  //Check for enough of the named resources
+  if(!this->HasResources(test))
+    {
+    return false;
+    }
 
   // copy the depend tests locally because when
   // a test is finished it will be removed from the depend list
@@ -295,6 +357,25 @@ bool cmCTestMultiProcessHandler::CheckOutput()
     {
     return false;
     }
+
+  // Sleep until a running test has output or finishes so that its job
+  // slot is refilled right away, unless a test still has output left
+  // from the last round.  Wake up now and then anyway.
+  std::vector<cmProcess*> processes;
+  bool pending = false;
+  for(std::set<cmCTestRunTest*>::const_iterator i = this->RunningTests.begin();
+      i != this->RunningTests.end(); ++i)
+    {
+    processes.push_back((*i)->GetProcess());
+    pending = pending || (*i)->HasPendingOutput();
+    }
+  if(!pending)
+    {
+    cmProcess::WaitForAny(processes, 1);
+    }
+
+  // Read what every running test has printed without waiting on any
+  // one of them.
   std::vector<cmCTestRunTest*> finished;
   std::string out, err;
   for(std::set<cmCTestRunTest*>::const_iterator i = this->RunningTests.begin();
@@ -358,24 +439,21 @@ void cmCTestMultiProcessHandler::UpdateCostData()
       if(line == "---") break;
       std::vector<cmsys::String> parts =
         cmSystemTools::SplitString(line.c_str(), ' ');
-      //Format: <name> <previous_runs> <avg_cost>
+      //Format: <name> <previous_runs> <avg_cost> [<cost_stddev>]
       if(parts.size() < 3) break;
 
       std::string name = parts[0];
-      int prev = atoi(parts[1].c_str());
-      float cost = static_cast<float>(atof(parts[2].c_str()));
 
       int index = this->SearchByName(name);
       if(index == -1)
         {
         // This test is not in memory. We just rewrite the entry
-        fout << name << " " << prev << " " << cost << "\n";
+        fout << line << "\n";
         }
       else
         {
         // Update with our new average cost
-        fout << name << " " << this->Properties[index]->PreviousRuns << " "
-          << this->Properties[index]->Cost << "\n";
+        this->WriteCostData(fout, this->Properties[index]);
         temp.erase(index);
         }
       }
@@ -386,8 +464,7 @@ void cmCTestMultiProcessHandler::UpdateCostData()
   // Add all tests not previously listed in the file
   for(PropertiesMap::iterator i = temp.begin(); i != temp.end(); ++i)
     {
-    fout << i->second->Name << " " << i->second->PreviousRuns << " "
-      << i->second->Cost << "\n";
+    this->WriteCostData(fout, i->second);
     }
 
   // Write list of failed tests
@@ -401,6 +478,15 @@ void cmCTestMultiProcessHandler::UpdateCostData()
   cmSystemTools::RenameFile(tmpout.c_str(), fname.c_str());
 }
 
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler
+::WriteCostData(std::ostream& fout,
+                cmCTestTestHandler::cmCTestTestProperties* p)
+{
+  fout << p->Name << " " << p->PreviousRuns << " " << p->Cost << " "
+    << sqrt(p->CostVariance) << "\n";
+}
+
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::ReadCostData()
 {
@@ -439,6 +525,11 @@ void cmCTestMultiProcessHandler::ReadCostData()
          this->Properties[index]->Cost == 0)
         {
         this->Properties[index]->Cost = cost;
+        if(parts.size() > 3)
+          {
+          double stddev = atof(parts[3].c_str());
+          this->Properties[index]->CostVariance = stddev * stddev;
+          }
         }
       }
     // Next part of the file is the failed tests
@@ -472,10 +563,20 @@ int cmCTestMultiProcessHandler::SearchByName(std::string name)
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::CreateTestCostList()
 {
+  // Costs known from timing history or the COST property, before the
+  // failed tests are moved to the front.
+  std::map<int, double> expected;
+  size_t unknown = 0;
   for(TestMap::iterator i = this->Tests.begin();
       i != this->Tests.end(); ++i)
     {
     SortedTests.push_back(i->first);
+    expected[i->first] = this->GetExpectedCost(i->first);
+    if(this->Properties[i->first]->Cost == 0 &&
+       this->Properties[i->first]->PreviousRuns == 0)
+      {
+      ++unknown;
+      }
 
     //If the test failed last time, it should be run first, so max the cost.
     //Only do this for parallel runs; in non-parallel runs, avoid clobbering
@@ -488,8 +589,152 @@ void cmCTestMultiProcessHandler::CreateTestCostList()
       }
     }
 
+  // Without parallelism the order follows the costs alone.  Otherwise
+  // start tests by the longest path of expected costs through the tests
+  // depending on them so that long chains of dependencies start early.
+  this->Priorities.clear();
+  if(this->ParallelLevel > 1)
+    {
+    TestMap dependents;
+    for(TestMap::iterator i = this->Tests.begin();
+        i != this->Tests.end(); ++i)
+      {
+      for(TestSet::iterator d = i->second.begin(); d != i->second.end(); ++d)
+        {
+        dependents[*d].insert(i->first);
+        }
+      }
+    for(TestMap::iterator i = this->Tests.begin();
+        i != this->Tests.end(); ++i)
+      {
+      this->ComputeCriticalPath(i->first, dependents);
+      }
+    }
+  else
+    {
+    for(TestMap::iterator i = this->Tests.begin();
+        i != this->Tests.end(); ++i)
+      {
+      this->Priorities[i->first] = this->Properties[i->first]->Cost;
+      }
+    }
+
   TestComparator comp(this);
   std::stable_sort(SortedTests.begin(), SortedTests.end(), comp);
+
+  // Predict the run time once the dependencies are known to be sane.
+  this->ExpectedCosts.clear();
+  if(this->ParallelLevel > 1 && unknown < this->Tests.size())
+    {
+    this->ExpectedCosts = expected;
+    }
+}
+
+//---------------------------------------------------------
+double cmCTestMultiProcessHandler::GetExpectedCost(int test)
+{
+  // Plan for runs one standard deviation slower than the average so
+  // that tests with unsteady run times are started a bit earlier.
+  cmCTestTestHandler::cmCTestTestProperties* p = this->Properties[test];
+  return static_cast<double>(p->Cost) + sqrt(p->CostVariance);
+}
+
+//---------------------------------------------------------
+double cmCTestMultiProcessHandler::ComputeCriticalPath(int test,
+                                                       TestMap& dependents)
+{
+  std::map<int, double>::iterator found = this->Priorities.find(test);
+  if(found != this->Priorities.end())
+    {
+    return found->second;
+    }
+
+  // Break dependency cycles here.  CheckCycles reports them later.
+  this->Priorities[test] = 0;
+
+  double longest = 0;
+  TestSet const& next = dependents[test];
+  for(TestSet::const_iterator i = next.begin(); i != next.end(); ++i)
+    {
+    double path = this->ComputeCriticalPath(*i, dependents);
+    if(path > longest)
+      {
+      longest = path;
+      }
+    }
+  double path = this->GetExpectedCost(test) + longest;
+  this->Priorities[test] = path;
+  return path;
+}
+
+//---------------------------------------------------------
+double cmCTestMultiProcessHandler::PredictRunTime()
+{
+  // Replay the decisions of StartNextTests with the expected costs.
+  // Resource locks and named resources are not taken into account.
+  std::set<int> started;
+  std::set<int> finished;
+  std::multimap<double, int> running;
+  size_t used = 0;
+  double now = 0;
+  while(finished.size() < this->SortedTests.size())
+    {
+    for(TestList::iterator t = this->SortedTests.begin();
+        t != this->SortedTests.end() && used < this->ParallelLevel; ++t)
+      {
+      if(started.find(*t) != started.end())
+        {
+        continue;
+        }
+      if(this->GetProcessorsUsed(*t) > this->ParallelLevel - used)
+        {
+        break;
+        }
+      int test = this->PredictStartTest(*t, started, finished);
+      if(test != -1)
+        {
+        started.insert(test);
+        used += this->GetProcessorsUsed(test);
+        running.insert(std::make_pair(now + this->ExpectedCosts[test],
+                                      test));
+        }
+      }
+    if(running.empty())
+      {
+      // The remaining tests wait for each other.
+      return -1;
+      }
+    std::multimap<double, int>::iterator next = running.begin();
+    now = next->first;
+    finished.insert(next->second);
+    used -= this->GetProcessorsUsed(next->second);
+    running.erase(next);
+    }
+  return now;
+}
+
+//---------------------------------------------------------
+int cmCTestMultiProcessHandler::PredictStartTest(int test,
+                                                 std::set<int>& started,
+                                                 std::set<int>& finished)
+{
+  // Like StartTest, start the first dependency not started yet instead.
+  TestSet const& depends = this->Tests[test];
+  bool waiting = false;
+  for(TestSet::const_iterator i = depends.begin(); i != depends.end(); ++i)
+    {
+    if(this->Tests.find(*i) == this->Tests.end() ||
+       finished.find(*i) != finished.end())
+      {
+      continue;
+      }
+    if(started.find(*i) == started.end())
+      {
+      return this->PredictStartTest(*i, started, finished);
+      }
+    waiting = true;
+    }
+  return waiting? -1 : test;
 }
 
 //---------------------------------------------------------
@@ -37,6 +37,10 @@ public:
   void SetTests(TestMap& tests, PropertiesMap& properties);
   // Set the max number of tests that can be run at the same time.
   void SetParallelLevel(size_t);
+  // Set the quantities of named resources the tests can use at the same
+  // time.  Resources not listed here are not limited.
+  void SetResourceCapacities(std::map<std::string, double> const& capacity)
+    { this->ResourceCapacities = capacity; }
   virtual void RunTests();
   void PrintTestList();
   void PrintLabels();
@@ -57,6 +61,10 @@ public:
 
   cmCTestTestHandler * GetTestHandler()
   { return this->TestHandler; }
+
+  // Wall time the tests are expected to take from their costs, or a
+  // negative value when there is no timing history.
+  double GetPredictedTime() { return this->PredictedTime; }
 protected:
   // Start the next test or tests as many as are allowed by
   // ParallelLevel
@@ -72,6 +80,17 @@ protected:
   int SearchByName(std::string name);
 
   void CreateTestCostList();
+  // Expected run time of a test from its cost and variance
+  double GetExpectedCost(int index);
+  // Compute the priority of a test as the longest path of expected
+  // costs from it through the tests depending on it
+  double ComputeCriticalPath(int index, TestMap& dependents);
+  // Predict the wall time of the run from the expected costs
+  double PredictRunTime();
+  int PredictStartTest(int index, std::set<int>& started,
+                       std::set<int>& finished);
+  void WriteCostData(std::ostream& fout,
+                     cmCTestTestHandler::cmCTestTestProperties* p);
   // Removes the checkpoint file
   void MarkFinished();
   void EraseTest(int index);
@@ -88,9 +107,19 @@ protected:
 
   void LockResources(int index);
   void UnlockResources(int index);
+  // Return whether enough of the resources a test needs are available
+  bool HasResources(int index);
+  // Get the quantities of the limited resources a test needs, each no
+  // more than the capacity so that any test can run alone
+  void GetResourcesNeeded(int index, std::map<std::string, double>& needed);
   // map from test number to set of depend tests
   TestMap Tests;
   TestList SortedTests;
+  // Order in which SortedTests starts tests, highest first
+  std::map<int, double> Priorities;
+  // Costs to predict the run time with, if there is timing history
+  std::map<int, double> ExpectedCosts;
+  double PredictedTime;
   //Total number of tests we'll be running
   size_t Total;
   //Number of tests that are complete
@@ -106,6 +135,8 @@ protected:
   std::vector<cmStdString>* Failed;
   std::vector<std::string> LastTestsFailed;
   std::set<std::string> LockedResources;
+  std::map<std::string, double> ResourceCapacities;
+  std::map<std::string, double> ResourcesInUse;
   std::vector<cmCTestTestHandler::cmCTestTestResult>* TestResults;
   size_t ParallelLevel; // max number of process that can be run at once
   std::set<cmCTestRunTest*> RunningTests;  // current running tests
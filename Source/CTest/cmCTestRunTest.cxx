@@ -13,12 +13,15 @@
 #include "cmCTestRunTest.h"
 #include "cmCTestMemCheckHandler.h"
 #include "cmCTest.h"
+#include "cmCryptoHash.h"
 #include "cmSystemTools.h"
 #include "cm_curl.h"
 
 #include <cm_zlib.h>
 #include <cmsys/Base64.h>
 
+#include <ctype.h>
+
 cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
 {
   this->CTest = handler->CTest;
@@ -30,25 +33,35 @@ cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
   this->TestResult.TestCount = 0;
   this->TestResult.Properties = 0;
   this->ProcessOutput = "";
+  this->OutputBufferSize = 0;
+  this->OutputTailSize = 0;
+  this->OmittedOutputSize = 0;
+  this->OmittedRequiredFound = false;
+  this->OmittedFullOutput = false;
+  this->OutputLog = 0;
   this->CompressedOutput = "";
   this->CompressionRatio = 2;
   this->StopTimePassed = false;
+  this->PendingOutput = false;
 }
 
 cmCTestRunTest::~cmCTestRunTest()
 {
+  delete this->OutputLog;
 }
 
 //----------------------------------------------------------------------------
 bool cmCTestRunTest::CheckOutput()
 {
-  // Read lines for up to 0.1 seconds of total time.
-  double timeout = 0.1;
-  double timeEnd = cmSystemTools::GetTime() + timeout;
+  // Read the lines available for up to 0.1 seconds of total time so
+  // that a test with a lot of output does not hold up the others.
+  double timeEnd = cmSystemTools::GetTime() + 0.1;
   std::string line;
-  while((timeout = timeEnd - cmSystemTools::GetTime(), timeout > 0))
+  bool complete;
+  this->PendingOutput = true;
+  while(cmSystemTools::GetTime() < timeEnd)
     {
-    int p = this->TestProcess->GetNextOutputLine(line, timeout);
+    int p = this->TestProcess->GetNextOutputLine(line, complete, 0);
     if(p == cmsysProcess_Pipe_None)
       {
       // Process has terminated and all output read.
@@ -60,17 +73,291 @@ bool cmCTestRunTest::CheckOutput()
       // Store this line of output.
       cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                  this->GetIndex() << ": " << line << std::endl);
-      this->ProcessOutput += line;
-      this->ProcessOutput += "\n";
+      this->AppendOutput(line, complete);
       }
     else // if(p == cmsysProcess_Pipe_Timeout)
       {
+      this->PendingOutput = false;
       break;
       }
     }
   return true;
 }
 
+//----------------------------------------------------------------------------
+void cmCTestRunTest::AppendOutput(std::string const& line, bool complete)
+{
+  std::string text = line;
+  if(complete)
+    {
+    text += "\n";
+    }
+  if(this->OutputLog)
+    {
+    *this->OutputLog << text;
+    }
+  if(!this->OutputBufferSize ||
+     this->ProcessOutput.size() < this->OutputBufferSize)
+    {
+    this->ProcessOutput += text;
+    return;
+    }
+
+  // The head is full.  Keep the latest output as the tail.  Output
+  // dropped from it is checked in windows that overlap by the buffer
+  // size, starting with the head, so that a match no longer than the
+  // buffer is found wherever it is.
+  if(!this->OmittedOutputSize)
+    {
+    this->OmittedWindow = this->ProcessOutput;
+    }
+  this->OutputTail.push_back(text);
+  this->OutputTailSize += text.size();
+  while(this->OutputTailSize > this->OutputBufferSize &&
+        this->OutputTail.size() > 1)
+    {
+    std::string const& dropped = this->OutputTail.front();
+    this->OmittedWindow += dropped;
+    this->OmittedOutputSize += dropped.size();
+    this->OutputTailSize -= dropped.size();
+    this->OutputTail.pop_front();
+    }
+  if(this->OmittedWindow.size() >= 2 * this->OutputBufferSize)
+    {
+    this->ScanOmittedOutput(this->OmittedWindow, false);
+    this->OmittedWindow.erase(0, this->OmittedWindow.size() -
+                              this->OutputBufferSize);
+    }
+}
+
+//----------------------------------------------------------------------------
+static void cmCTestRunTestCompileFilter(cmRegexPrefilter& filter,
+  std::vector<std::pair<cmsys::RegularExpression, std::string> > const& res)
+{
+  filter.Clear();
+  for(std::vector<std::pair<cmsys::RegularExpression,
+        std::string> >::const_iterator ri = res.begin();
+      ri != res.end(); ++ri)
+    {
+    filter.AddPattern(ri->second.c_str());
+    }
+  filter.Compile();
+}
+
+//----------------------------------------------------------------------------
+// Return whether the regular expression at the given index may match
+// text for which a prefilter gave the candidates.
+static bool cmCTestRunTestCandidate(std::vector<char> const& candidates,
+                                    size_t index)
+{
+  return index >= candidates.size() || candidates[index];
+}
+
+//----------------------------------------------------------------------------
+// Return whether a regular expression uses ^ or $ to match only at the
+// start or the end of the text.
+static bool cmCTestRunTestAnchored(std::string const& regex)
+{
+  for(std::string::size_type i = 0; i < regex.size(); ++i)
+    {
+    if(regex[i] == '\\')
+      {
+      ++i;
+      }
+    else if(regex[i] == '[')
+      {
+      // Skip the bracket expression.  A leading ] is one of its members.
+      i += (i + 1 < regex.size() && regex[i + 1] == '^')? 2 : 1;
+      i += (i < regex.size() && regex[i] == ']')? 1 : 0;
+      i = regex.find(']', i);
+      if(i == std::string::npos)
+        {
+        return false;
+        }
+      }
+    else if(regex[i] == '^' || regex[i] == '$')
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::ScanOmittedOutput(std::string const& text,
+                                       bool anchored)
+{
+  typedef std::vector<std::pair<cmsys::RegularExpression,
+    std::string> > RegexList;
+  RegexList& required = this->TestProperties->RequiredRegularExpressions;
+  RegexList& errors = this->TestProperties->ErrorRegularExpressions;
+  std::vector<char> candidates;
+  if(!this->OmittedRequiredFound)
+    {
+    this->RequiredFilter.Scan(text.c_str(), candidates);
+    for(size_t i = 0; i < required.size(); ++i)
+      {
+      if(cmCTestRunTestAnchored(required[i].second) == anchored &&
+         cmCTestRunTestCandidate(candidates, i) &&
+         required[i].first.find(text.c_str()))
+        {
+        this->OmittedRequiredFound = true;
+        break;
+        }
+      }
+    }
+  if(this->OmittedErrorRegex.empty())
+    {
+    this->ErrorFilter.Scan(text.c_str(), candidates);
+    for(size_t i = 0; i < errors.size(); ++i)
+      {
+      if(cmCTestRunTestAnchored(errors[i].second) == anchored &&
+         cmCTestRunTestCandidate(candidates, i) &&
+         errors[i].first.find(text.c_str()))
+        {
+        this->OmittedErrorRegex = errors[i].second;
+        break;
+        }
+      }
+    }
+  if(!anchored && text.find("CTEST_FULL_OUTPUT") != text.npos)
+    {
+    this->OmittedFullOutput = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::FinishOutput()
+{
+  delete this->OutputLog;
+  this->OutputLog = 0;
+
+  if(this->OmittedOutputSize)
+    {
+    // Finish the last window with the tail.  The start and the end of
+    // the output, where ^ and $ match, are those of the head and tail.
+    std::string tail;
+    for(std::deque<std::string>::const_iterator i = this->OutputTail.begin();
+        i != this->OutputTail.end(); ++i)
+      {
+      tail += *i;
+      }
+    this->ScanOmittedOutput(this->OmittedWindow + tail, false);
+    this->ScanOmittedOutput(this->ProcessOutput + tail, true);
+    this->OmittedWindow = "";
+
+    cmOStringStream note;
+    note << "...\n"
+      "ctest: " << this->OmittedOutputSize << " bytes of the test output "
+      "were not kept since it exceeds the buffer size of "
+      << this->OutputBufferSize << " bytes for both its head and tail.";
+    if(!this->OutputLogFile.empty())
+      {
+      note << "  The full output is in \"" << this->OutputLogFile << "\".";
+      }
+    note << "\n...\n";
+    this->OmittedOutputNote = note.str();
+    this->ProcessOutput += this->OmittedOutputNote;
+    }
+  for(std::deque<std::string>::const_iterator i = this->OutputTail.begin();
+      i != this->OutputTail.end(); ++i)
+    {
+    this->ProcessOutput += *i;
+    }
+  this->OutputTail.clear();
+  this->OutputTailSize = 0;
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::CleanOmittedOutput(size_t length)
+{
+  std::string::size_type pos =
+    this->ProcessOutput.find(this->OmittedOutputNote);
+  if(!length || this->OmittedFullOutput || pos == std::string::npos ||
+     this->ProcessOutput.find("CTEST_FULL_OUTPUT") != std::string::npos)
+    {
+    return;
+    }
+  std::string head = this->ProcessOutput.substr(0, pos);
+  std::string tail =
+    this->ProcessOutput.substr(pos + this->OmittedOutputNote.size());
+  size_t half = length / 2;
+
+  // Cut between UTF-8 encoded characters.
+  if(head.size() > half)
+    {
+    size_t cut = half;
+    while(cut > 0 && (static_cast<unsigned char>(head[cut]) & 0xC0) == 0x80)
+      {
+      --cut;
+      }
+    head.erase(cut);
+    }
+  if(tail.size() > half)
+    {
+    size_t cut = tail.size() - half;
+    while(cut < tail.size() &&
+          (static_cast<unsigned char>(tail[cut]) & 0xC0) == 0x80)
+      {
+      ++cut;
+      }
+    tail.erase(0, cut);
+    }
+
+  cmOStringStream msg;
+  msg << "...\n"
+    "The middle of the test output was removed since it exceeds the "
+    "threshold of " << length << " bytes.";
+  if(!this->OutputLogFile.empty())
+    {
+    msg << "  The full output is in \"" << this->OutputLogFile << "\".";
+    }
+  msg << "\n...\n";
+  this->ProcessOutput = head + msg.str() + tail;
+}
+
+//----------------------------------------------------------------------------
+bool cmCTestRunTest::OpenOutputLog()
+{
+  std::string const& dir = this->TestHandler->TestOutputDirectory;
+  if(dir.empty())
+    {
+    return true;
+    }
+  // Name the log after the test with characters that may not be used
+  // in a file name replaced.  A hash of the test name then tells apart
+  // names that differ only in those characters.
+  std::string name = this->TestProperties->Name;
+  bool replaced = false;
+  for(std::string::iterator c = name.begin(); c != name.end(); ++c)
+    {
+    if(!isalnum(static_cast<unsigned char>(*c)) &&
+       *c != '.' && *c != '-' && *c != '_')
+      {
+      *c = '_';
+      replaced = true;
+      }
+    }
+  if(replaced)
+    {
+    cmCryptoHashMD5 md5;
+    name += "-";
+    name += md5.HashString(this->TestProperties->Name.c_str()).substr(0, 8);
+    }
+  this->OutputLogFile = dir + "/" + name + ".log";
+  this->OutputLog = new std::ofstream(this->OutputLogFile.c_str());
+  if(!*this->OutputLog)
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE, "Cannot write test output log: "
+               << this->OutputLogFile << std::endl);
+    delete this->OutputLog;
+    this->OutputLog = 0;
+    this->OutputLogFile = "";
+    return false;
+    }
+  return true;
+}
+
 //---------------------------------------------------------
 // Streamed compression of test output.  The compressed data
 // is appended to this->CompressedOutput
@@ -137,6 +424,7 @@ void cmCTestRunTest::CompressOutput()
 //---------------------------------------------------------
 bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
 {
+  this->FinishOutput();
   if ((!this->TestHandler->MemCheck &&
       this->CTest->ShouldCompressTestOutput()) ||
       (this->TestHandler->MemCheck &&
@@ -155,14 +443,22 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     std::string> >::iterator passIt;
   bool forceFail = false;
   bool outputTestErrorsToConsole = false;
+  std::vector<char> candidates;
+  // The output that was not kept whole has been matched while it came.
+  bool omitted = this->OmittedOutputSize > 0;
   if ( this->TestProperties->RequiredRegularExpressions.size() > 0 )
     {
     bool found = false;
+    this->RequiredFilter.Scan(this->ProcessOutput.c_str(), candidates);
     for ( passIt = this->TestProperties->RequiredRegularExpressions.begin();
           passIt != this->TestProperties->RequiredRegularExpressions.end();
           ++ passIt )
       {
-      if ( passIt->first.find(this->ProcessOutput.c_str()) )
+      size_t index = passIt -
+        this->TestProperties->RequiredRegularExpressions.begin();
+      if ( omitted? this->OmittedRequiredFound :
+           (cmCTestRunTestCandidate(candidates, index) &&
+            passIt->first.find(this->ProcessOutput.c_str())) )
         {
         found = true;
         reason = "Required regular expression found.";
@@ -186,11 +482,15 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     }
   if ( this->TestProperties->ErrorRegularExpressions.size() > 0 )
     {
+    this->ErrorFilter.Scan(this->ProcessOutput.c_str(), candidates);
     for ( passIt = this->TestProperties->ErrorRegularExpressions.begin();
           passIt != this->TestProperties->ErrorRegularExpressions.end();
           ++ passIt )
       {
-      if ( passIt->first.find(this->ProcessOutput.c_str()) )
+      size_t index = passIt -
+        this->TestProperties->ErrorRegularExpressions.begin();
+      if ( !omitted && cmCTestRunTestCandidate(candidates, index) &&
+           passIt->first.find(this->ProcessOutput.c_str()) )
         {
         reason = "Error regular expression found in output.";
         reason += " Regex=[";
@@ -200,6 +500,14 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
         break;
         }
       }
+    if ( !forceFail && !this->OmittedErrorRegex.empty() )
+      {
+      reason = "Error regular expression found in output.";
+      reason += " Regex=[";
+      reason += this->OmittedErrorRegex;
+      reason += "]";
+      forceFail = true;
+      }
     }
   if (res == cmsysProcess_State_Exited)
     {
@@ -286,11 +594,18 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   // Output since that is what is parsed by cmCTestMemCheckHandler
   if(!this->TestHandler->MemCheck && started)
     {
-    this->TestHandler->CleanTestOutput(this->ProcessOutput,
-      static_cast<size_t>
+    size_t length = static_cast<size_t>
       (this->TestResult.Status == cmCTestTestHandler::COMPLETED ?
       this->TestHandler->CustomMaximumPassedTestOutputSize :
-      this->TestHandler->CustomMaximumFailedTestOutputSize));
+      this->TestHandler->CustomMaximumFailedTestOutputSize);
+    if(this->OmittedOutputSize)
+      {
+      this->CleanOmittedOutput(length);
+      }
+    else
+      {
+      this->TestHandler->CleanTestOutput(this->ProcessOutput, length);
+      }
     }
   this->TestResult.Reason = reason;
   if (this->TestHandler->LogFile)
@@ -367,8 +682,13 @@ void cmCTestRunTest::ComputeWeightedCost()
 
   if(this->TestResult.Status == cmCTestTestHandler::COMPLETED)
     {
-    this->TestProperties->Cost =
-      static_cast<float>(((prev * avgcost) + current) / (prev + 1.0));
+    double newcost = ((prev * avgcost) + current) / (prev + 1.0);
+    // Welford's update of the variance along with the average.
+    double variance = ((prev * this->TestProperties->CostVariance) +
+                       (current - avgcost) * (current - newcost)) /
+      (prev + 1.0);
+    this->TestProperties->Cost = static_cast<float>(newcost);
+    this->TestProperties->CostVariance = variance > 0? variance : 0;
     this->TestProperties->PreviousRuns++;
     }
 }
@@ -487,6 +807,19 @@ bool cmCTestRunTest::StartTest(size_t total)
     }
   this->StartTime = this->CTest->CurrentTime();
 
+  // The memory checkers parse all of the output so it is kept whole.
+  if(!this->TestHandler->MemCheck &&
+     this->TestHandler->CustomTestOutputBufferSize > 0)
+    {
+    this->OutputBufferSize =
+      static_cast<size_t>(this->TestHandler->CustomTestOutputBufferSize);
+    }
+  this->OpenOutputLog();
+  cmCTestRunTestCompileFilter(this->RequiredFilter,
+    this->TestProperties->RequiredRegularExpressions);
+  cmCTestRunTestCompileFilter(this->ErrorFilter,
+    this->TestProperties->ErrorRegularExpressions);
+
   double timeout = this->ResolveTimeout();
 
   if(this->StopTimePassed)
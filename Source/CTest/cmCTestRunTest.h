@@ -15,6 +15,7 @@
 #include <cmStandardIncludes.h>
 #include <cmCTestTestHandler.h>
 #include <cmProcess.h>
+#include <cmRegexPrefilter.h>
 
 /** \class cmRunTest
  * \brief represents a single test to be run
@@ -44,9 +45,15 @@ public:
   cmCTestTestHandler::cmCTestTestResult GetTestResults()
   { return this->TestResult; }
 
-  // Read and store output.  Returns true if it must be called again.
+  // Read and store the output available without waiting.  Returns
+  // true if it must be called again.
   bool CheckOutput();
 
+  cmProcess* GetProcess() { return this->TestProcess; }
+
+  // Whether the last call to CheckOutput left output to be read.
+  bool HasPendingOutput() { return this->PendingOutput; }
+
   // Compresses the output, writing to CompressedOutput
   void CompressOutput();
 
@@ -60,6 +67,20 @@ public:
   void ComputeWeightedCost();
 private:
   void DartProcessing();
+  // Store a line of output, or a piece of one that is not complete.
+  // Past the buffer size only the head and the tail of the output are
+  // kept in memory.
+  void AppendOutput(std::string const& line, bool complete);
+  // Check output that is not kept whole for what EndTest looks for,
+  // with the regular expressions that are anchored or those that are
+  // not.
+  void ScanOmittedOutput(std::string const& text, bool anchored);
+  // Join the head and the tail once the output is complete.
+  void FinishOutput();
+  // Trim output that had lines omitted to the given length, keeping
+  // equal parts of its head and tail.
+  void CleanOmittedOutput(size_t length);
+  bool OpenOutputLog();
   void ExeNotFound(std::string exe);
   // Figures out a final timeout which is min(STOP_TIME, NOW+TIMEOUT)
   double ResolveTimeout();
@@ -83,6 +104,21 @@ private:
   std::string PrefixCommand;
 
   std::string ProcessOutput;
+  std::deque<std::string> OutputTail;
+  size_t OutputBufferSize;
+  size_t OutputTailSize;
+  size_t OmittedOutputSize;
+  std::string OmittedWindow;
+  std::string OmittedOutputNote;
+  bool OmittedRequiredFound;
+  std::string OmittedErrorRegex;
+  bool OmittedFullOutput;
+  // Rule out most of the required and error regular expressions of
+  // the test before matching them.
+  cmRegexPrefilter RequiredFilter;
+  cmRegexPrefilter ErrorFilter;
+  std::ofstream* OutputLog;
+  std::string OutputLogFile;
   std::string CompressedOutput;
   double CompressionRatio;
   //The test results
@@ -92,6 +128,7 @@ private:
   std::string ActualCommand;
   std::vector<std::string> Arguments;
   bool StopTimePassed;
+  bool PendingOutput;
 };
 
 inline int getNumWidth(size_t n)
@@ -25,6 +25,9 @@ cmCTestTestCommand::cmCTestTestCommand()
   this->Arguments[ctt_INCLUDE_LABEL] = "INCLUDE_LABEL";
   this->Arguments[ctt_PARALLEL_LEVEL] = "PARALLEL_LEVEL";
   this->Arguments[ctt_SCHEDULE_RANDOM] = "SCHEDULE_RANDOM";
+  this->Arguments[ctt_RESOURCE_SPEC_FILE] = "RESOURCE_SPEC_FILE";
+  this->Arguments[ctt_TEST_OUTPUT_DIR] = "TEST_OUTPUT_DIR";
+  this->Arguments[ctt_SHARD] = "SHARD";
   this->Arguments[ctt_STOP_TIME] = "STOP_TIME";
   this->Arguments[ctt_LAST] = 0;
   this->Last = ctt_LAST;
@@ -99,6 +102,20 @@ cmCTestGenericHandler* cmCTestTestCommand::InitializeHandler()
     handler->SetOption("ScheduleRandom",
                        this->Values[ctt_SCHEDULE_RANDOM]);
     }
+  if(this->Values[ctt_RESOURCE_SPEC_FILE])
+    {
+    handler->SetOption("ResourceSpecFile",
+                       this->Values[ctt_RESOURCE_SPEC_FILE]);
+    }
+  if(this->Values[ctt_TEST_OUTPUT_DIR])
+    {
+    handler->SetOption("TestOutputDirectory",
+                       this->Values[ctt_TEST_OUTPUT_DIR]);
+    }
+  if(this->Values[ctt_SHARD])
+    {
+    handler->SetOption("Shard", this->Values[ctt_SHARD]);
+    }
   if(this->Values[ctt_STOP_TIME])
     {
     this->CTest->SetStopTime(this->Values[ctt_STOP_TIME]);
@@ -63,6 +63,9 @@ public:
       "             [INCLUDE_LABEL label regex] \n"
       "             [PARALLEL_LEVEL level] \n"
       "             [SCHEDULE_RANDOM on] \n"
+      "             [RESOURCE_SPEC_FILE file] \n"
+      "             [TEST_OUTPUT_DIR dir] \n"
+      "             [SHARD index/count] \n"
       "             [STOP_TIME time of day]) \n"
       "Tests the given build directory and stores results in Test.xml. The "
       "second argument is a variable that will hold value. Optionally, "
@@ -74,7 +77,13 @@ public:
       "property LABEL. PARALLEL_LEVEL should be set to a positive number "
       "representing the number of tests to be run in parallel. "
       "SCHEDULE_RANDOM will launch tests in a random order, and is "
-      "typically used to detect implicit test dependencies. STOP_TIME is the "
+      "typically used to detect implicit test dependencies. "
+      "RESOURCE_SPEC_FILE names a file with the quantities of resources "
+      "available to tests with the RESOURCES property, as for the ctest "
+      "--resource-spec-file option. TEST_OUTPUT_DIR names a directory in "
+      "which the full output of each test is written, as for the ctest "
+      "--test-output-dir option. SHARD runs only one of several shards "
+      "of the tests, as for the ctest --shard option. STOP_TIME is the "
       "time of day at which the tests should all stop running."
       "\n"
       CTEST_COMMAND_APPEND_OPTION_DOCS;
@@ -98,6 +107,9 @@ protected:
     ctt_INCLUDE_LABEL,
     ctt_PARALLEL_LEVEL,
     ctt_SCHEDULE_RANDOM,
+    ctt_RESOURCE_SPEC_FILE,
+    ctt_TEST_OUTPUT_DIR,
+    ctt_SHARD,
     ctt_STOP_TIME,
     ctt_LAST
   };
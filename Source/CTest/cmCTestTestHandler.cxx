@@ -28,7 +28,9 @@
 #include "cmXMLSafe.h"
 #include "cm_utf8.h"
 
+#include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <float.h>
 
@@ -405,6 +407,10 @@ cmCTestTestHandler::cmCTestTestHandler()
 
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->CustomTestOutputBufferSize = 1024 * 1024;
+
+  this->ShardIndex = 0;
+  this->ShardCount = 0;
 
   this->MemCheck = false;
 
@@ -424,6 +430,7 @@ void cmCTestTestHandler::Initialize()
   this->Superclass::Initialize();
 
   this->ElapsedTestingTime = -1;
+  this->PredictedTestingTime = -1;
 
   this->TestResults.clear();
 
@@ -435,6 +442,7 @@ void cmCTestTestHandler::Initialize()
   this->CustomPostTest.clear();
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->CustomTestOutputBufferSize = 1024 * 1024;
 
   this->TestsToRun.clear();
 
@@ -469,6 +477,9 @@ void cmCTestTestHandler::PopulateCustomVectors(cmMakefile *mf)
   this->CTest->PopulateCustomInteger(mf,
                              "CTEST_CUSTOM_MAXIMUM_FAILED_TEST_OUTPUT_SIZE",
                              this->CustomMaximumFailedTestOutputSize);
+  this->CTest->PopulateCustomInteger(mf,
+                             "CTEST_CUSTOM_TEST_OUTPUT_BUFFER_SIZE",
+                             this->CustomTestOutputBufferSize);
 }
 
 //----------------------------------------------------------------------
@@ -537,6 +548,43 @@ int cmCTestTestHandler::ProcessHandler()
     this->UseExcludeRegExp();
     this->SetExcludeRegExp(val);
     }
+  this->ResourceCapacities.clear();
+  val = this->GetOption("ResourceSpecFile");
+  if ( val && !this->ReadResourceSpecFile(val) )
+    {
+    return -1;
+    }
+  this->TestOutputDirectory = "";
+  val = this->GetOption("TestOutputDirectory");
+  if ( val && *val )
+    {
+    this->TestOutputDirectory = cmSystemTools::CollapseFullPath(val);
+    if ( !cmSystemTools::MakeDirectory(this->TestOutputDirectory.c_str()) )
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Cannot create test output directory: "
+                 << this->TestOutputDirectory << std::endl);
+      return -1;
+      }
+    }
+  this->ShardIndex = 0;
+  this->ShardCount = 0;
+  val = this->GetOption("Shard");
+  if ( val && *val )
+    {
+    char extra;
+    if ( sscanf(val, "%d/%d%c", &this->ShardIndex, &this->ShardCount,
+                &extra) != 2 || this->ShardIndex < 1 ||
+         this->ShardIndex > this->ShardCount )
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Invalid shard \"" << val << "\", expected <index>/<count> "
+                 "with 1 <= index <= count." << std::endl);
+      this->ShardIndex = 0;
+      this->ShardCount = 0;
+      return -1;
+      }
+    }
 
   this->TestResults.clear();
 
@@ -608,6 +656,13 @@ int cmCTestTestHandler::ProcessHandler()
     sprintf(realBuf, "%6.2f sec", (double)(clock_finish - clock_start));
     cmCTestLog(this->CTest, HANDLER_OUTPUT, "\nTotal Test time (real) = "
                << realBuf << "\n" );
+    if(this->PredictedTestingTime >= 0)
+      {
+      // Compare with the time expected from past runs of the tests.
+      sprintf(realBuf, "%6.2f sec", this->PredictedTestingTime);
+      cmCTestLog(this->CTest, HANDLER_OUTPUT, "Predicted test time    = "
+                 << realBuf << "\n" );
+      }
 
     if (failed.size())
       {
@@ -1022,6 +1077,10 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<cmStdString> &passed,
                                          std::vector<cmStdString> &failed)
 {
   this->ComputeTestList();
+  if(this->ShardCount > 0)
+    {
+    this->ShardTestList();
+    }
   this->StartTest = this->CTest->CurrentTime();
   this->StartTestTime = static_cast<unsigned int>(cmSystemTools::GetTime());
   double elapsed_time_start = cmSystemTools::GetTime();
@@ -1030,6 +1089,7 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<cmStdString> &passed,
     new cmCTestBatchTestHandler : new cmCTestMultiProcessHandler;
   parallel->SetCTest(this->CTest);
   parallel->SetParallelLevel(this->CTest->GetParallelLevel());
+  parallel->SetResourceCapacities(this->ResourceCapacities);
   parallel->SetTestHandler(this);
 
   *this->LogFile << "Start testing: "
@@ -1098,6 +1158,7 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<cmStdString> &passed,
     {
     parallel->RunTests();
     }
+  this->PredictedTestingTime = parallel->GetPredictedTime();
   delete parallel;
   this->EndTest = this->CTest->CurrentTime();
   this->EndTestTime = static_cast<unsigned int>(cmSystemTools::GetTime());
@@ -2067,6 +2128,26 @@ bool cmCTestTestHandler::SetTestsProperties(
               rtit->LockedResources.insert(*f);
               }
             }
+          if ( key == "RESOURCES" )
+            {
+            std::vector<std::string> lval;
+            cmSystemTools::ExpandListArgument(val.c_str(), lval);
+
+            for(std::vector<std::string>::iterator f = lval.begin();
+                f != lval.end(); ++f)
+              {
+              std::string name;
+              double quantity;
+              if(!cmCTestTestHandler::ParseResource(*f, name, quantity))
+                {
+                cmCTestLog(this->CTest, ERROR_MESSAGE,
+                           "Test " << rtit->Name << " has invalid RESOURCES "
+                           "entry \"" << *f << "\"." << std::endl);
+                continue;
+                }
+              rtit->Resources[name] = quantity;
+              }
+            }
           if ( key == "TIMEOUT" )
             {
             rtit->Timeout = atof(val.c_str());
@@ -2246,6 +2327,7 @@ bool cmCTestTestHandler::AddTest(const std::vector<std::string>& args)
   test.Timeout = 0;
   test.ExplicitTimeout = false;
   test.Cost = 0;
+  test.CostVariance = 0;
   test.Processors = 1;
   test.PreviousRuns = 0;
   if (this->UseIncludeRegExpFlag &&
@@ -2263,3 +2345,322 @@ bool cmCTestTestHandler::AddTest(const std::vector<std::string>& args)
   return true;
 }
 
+
+//----------------------------------------------------------------------
+bool cmCTestTestHandler::ReadResourceSpecFile(const char* fname)
+{
+  std::ifstream fin(fname);
+  if(!fin)
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Cannot read resource specification file: " << fname
+               << std::endl);
+    return false;
+    }
+  // Each line gives a resource as "name=quantity".  Empty lines and
+  // lines starting in '#' are ignored.
+  std::string line;
+  int lineNumber = 0;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    ++lineNumber;
+    std::string::size_type pos = line.find_first_not_of(" \t\r");
+    if(pos == std::string::npos || line[pos] == '#')
+      {
+      continue;
+      }
+    std::string name;
+    double quantity;
+    if(!cmCTestTestHandler::ParseResource(line, name, quantity))
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 fname << ":" << lineNumber << ": Invalid resource \""
+                 << line << "\", expected name=quantity." << std::endl);
+      return false;
+      }
+    this->ResourceCapacities[name] = quantity;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool cmCTestTestHandler::ParseResource(std::string const& entry,
+                                       std::string& name, double& quantity)
+{
+  std::string::size_type eq = entry.find('=');
+  if(eq == std::string::npos)
+    {
+    return false;
+    }
+  name = cmSystemTools::TrimWhitespace(entry.substr(0, eq));
+  std::string value = cmSystemTools::TrimWhitespace(entry.substr(eq + 1));
+  if(name.empty() || value.empty())
+    {
+    return false;
+    }
+  const char* begin = value.c_str();
+  char* end = 0;
+  quantity = strtod(begin, &end);
+  if(end == begin || quantity < 0)
+    {
+    return false;
+    }
+  if(*end)
+    {
+    static const char suffixes[] = "KMGT";
+    const char* suffix = strchr(suffixes, toupper(*end));
+    if(!suffix || end[1])
+      {
+      return false;
+      }
+    for(const char* s = suffixes; s <= suffix; ++s)
+      {
+      quantity *= 1024;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------
+void cmCTestTestHandler::ShardTestList()
+{
+  // Average run times of the tests from earlier runs.
+  std::map<std::string, double> history;
+  std::string fname = this->CTest->GetCostDataFile();
+  std::ifstream fin(fname.c_str());
+  std::string line;
+  while(fin && std::getline(fin, line) && line != "---")
+    {
+    std::vector<cmsys::String> parts =
+      cmSystemTools::SplitString(line.c_str(), ' ');
+    if(parts.size() >= 3)
+      {
+      history[parts[0]] = atof(parts[2].c_str());
+      }
+    }
+
+  // A COST property takes precedence over the history as it does for
+  // scheduling.  Tests with neither count as the average of the others.
+  size_t count = this->TestList.size();
+  std::vector<double> costs(count, -1);
+  double known = 0;
+  size_t numKnown = 0;
+  std::map<std::string, size_t> positions;
+  for(size_t i = 0; i < count; ++i)
+    {
+    cmCTestTestProperties& p = this->TestList[i];
+    positions[p.Name] = i;
+    std::map<std::string, double>::const_iterator h = history.find(p.Name);
+    if(p.Cost > 0)
+      {
+      costs[i] = p.Cost;
+      }
+    else if(h != history.end())
+      {
+      costs[i] = h->second;
+      }
+    if(costs[i] >= 0)
+      {
+      known += costs[i];
+      ++numKnown;
+      }
+    }
+  double average = numKnown? known / static_cast<double>(numKnown) : 1;
+
+  // Group tests connected by DEPENDS in either direction.  Each group
+  // is named by its first test in the list.
+  std::vector<size_t> group(count);
+  for(size_t i = 0; i < count; ++i)
+    {
+    group[i] = i;
+    }
+  for(size_t i = 0; i < count; ++i)
+    {
+    std::vector<std::string> const& depends = this->TestList[i].Depends;
+    for(std::vector<std::string>::const_iterator d = depends.begin();
+        d != depends.end(); ++d)
+      {
+      std::map<std::string, size_t>::const_iterator j = positions.find(*d);
+      if(j == positions.end())
+        {
+        continue;
+        }
+      size_t a = i;
+      while(group[a] != a)
+        {
+        a = group[a];
+        }
+      size_t b = j->second;
+      while(group[b] != b)
+        {
+        b = group[b];
+        }
+      group[a > b? a : b] = a < b? a : b;
+      }
+    }
+  std::map<size_t, double> groupCosts;
+  for(size_t i = 0; i < count; ++i)
+    {
+    while(group[group[i]] != group[i])
+      {
+      group[i] = group[group[i]];
+      }
+    groupCosts[group[i]] += costs[i] >= 0? costs[i] : average;
+    }
+
+  // Give the most expensive group left to the shard with the least
+  // work so far.  Ties are broken by position so that every shard
+  // computes the same partition from the same cost data.
+  std::vector<std::pair<double, size_t> > order;
+  for(std::map<size_t, double>::const_iterator g = groupCosts.begin();
+      g != groupCosts.end(); ++g)
+    {
+    order.push_back(std::make_pair(-g->second, g->first));
+    }
+  std::sort(order.begin(), order.end());
+  std::vector<double> loads(this->ShardCount, 0);
+  std::map<size_t, int> groupShards;
+  for(std::vector<std::pair<double, size_t> >::const_iterator g =
+        order.begin(); g != order.end(); ++g)
+    {
+    int shard = 0;
+    for(int s = 1; s < this->ShardCount; ++s)
+      {
+      if(loads[s] < loads[shard])
+        {
+        shard = s;
+        }
+      }
+    loads[shard] -= g->first;
+    groupShards[g->second] = shard;
+    }
+
+  ListOfTests shardList;
+  for(size_t i = 0; i < count; ++i)
+    {
+    if(groupShards[group[i]] == this->ShardIndex - 1)
+      {
+      shardList.push_back(this->TestList[i]);
+      }
+    }
+  this->TestList = shardList;
+
+  cmCTestLog(this->CTest, HANDLER_OUTPUT, "Shard " << this->ShardIndex
+             << " of " << this->ShardCount << ": " << shardList.size()
+             << " of " << count << " tests, expected cost "
+             << loads[this->ShardIndex - 1] << " sec" << std::endl);
+}
+
+//----------------------------------------------------------------------
+// Find the text of the first element with the given name in a range of
+// a Test.xml file.
+static std::string cmCTestTestHandlerElement(std::string const& xml,
+                                             const char* name,
+                                             std::string::size_type begin,
+                                             std::string::size_type end)
+{
+  std::string start = std::string("<") + name + ">";
+  std::string::size_type pos = xml.find(start, begin);
+  if(pos == std::string::npos || pos >= end)
+    {
+    return "";
+    }
+  pos += start.size();
+  std::string::size_type stop = xml.find("</", pos);
+  if(stop == std::string::npos)
+    {
+    return "";
+    }
+  return xml.substr(pos, stop - pos);
+}
+
+//----------------------------------------------------------------------
+bool cmCTestTestHandler::MergeTestXML(const char* output,
+                                      std::vector<cmStdString> const& inputs)
+{
+  static const std::string listStart = "\t<TestList>\n";
+  static const std::string listEnd = "\t</TestList>\n";
+  static const std::string footerStart = "\t<EndDateTime>";
+
+  // The site and start time come from the shard that started first and
+  // the end time from the one that finished last.  The lists of tests
+  // and their results are concatenated.
+  std::string header;
+  std::string testList;
+  std::string results;
+  std::string endDateTime;
+  unsigned long startTime = 0;
+  unsigned long endTime = 0;
+  for(std::vector<cmStdString>::const_iterator i = inputs.begin();
+      i != inputs.end(); ++i)
+    {
+    std::ifstream fin(i->c_str());
+    if(!fin)
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE, "Cannot read test results: "
+                 << *i << std::endl);
+      return false;
+      }
+    cmOStringStream content;
+    content << fin.rdbuf();
+    std::string xml = content.str();
+    std::string::size_type listPos = xml.find(listStart);
+    std::string::size_type resultsPos = listPos == std::string::npos?
+      listPos : xml.find(listEnd, listPos);
+    std::string::size_type footerPos = resultsPos == std::string::npos?
+      resultsPos : xml.find(footerStart, resultsPos);
+    if(footerPos == std::string::npos)
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE, "Not a Test.xml file written "
+                 "by ctest: " << *i << std::endl);
+      return false;
+      }
+    unsigned long start = static_cast<unsigned long>(atol(
+      cmCTestTestHandlerElement(xml, "StartTestTime", 0, listPos).c_str()));
+    unsigned long end = static_cast<unsigned long>(atol(
+      cmCTestTestHandlerElement(xml, "EndTestTime", footerPos,
+                                xml.size()).c_str()));
+    if(i == inputs.begin() || start < startTime)
+      {
+      header = xml.substr(0, listPos + listStart.size());
+      startTime = start;
+      }
+    if(i == inputs.begin() || end > endTime)
+      {
+      endDateTime = cmCTestTestHandlerElement(xml, "EndDateTime", footerPos,
+                                              xml.size());
+      endTime = end;
+      }
+    listPos += listStart.size();
+    testList += xml.substr(listPos, resultsPos - listPos);
+    resultsPos += listEnd.size();
+    results += xml.substr(resultsPos, footerPos - resultsPos);
+    }
+  if(header.empty())
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE, "No test results to merge."
+               << std::endl);
+    return false;
+    }
+
+  cmGeneratedFileStream os(output);
+  if(!os)
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE, "Cannot write test results: "
+               << output << std::endl);
+    return false;
+    }
+  double elapsed = endTime > startTime?
+    static_cast<double>(endTime - startTime) : 0;
+  os << header << testList << listEnd << results
+     << "\t<EndDateTime>" << endDateTime << "</EndDateTime>\n"
+     << "\t<EndTestTime>" << endTime << "</EndTestTime>\n"
+     << "<ElapsedMinutes>"
+     << static_cast<int>(elapsed/6)/10.0
+     << "</ElapsedMinutes>"
+     << "</Testing>" << std::endl;
+  this->CTest->EndXML(os);
+  cmCTestLog(this->CTest, HANDLER_OUTPUT, "Merged the results of "
+             << inputs.size() << " shards into " << output << std::endl);
+  return true;
+}
@@ -61,6 +61,13 @@ public:
   ///! pass the -I argument down
   void SetTestsToRunInformation(const char*);
 
+  /**
+   * Merge the Test.xml files written by the shards of a test run into
+   * one file
+   */
+  bool MergeTestXML(const char* output,
+                    std::vector<cmStdString> const& inputs);
+
   cmCTestTestHandler();
 
   /*
@@ -96,6 +103,8 @@ public:
     bool IsInBasedOnREOptions;
     bool WillFail;
     float Cost;
+    //Variance of the run times averaged in Cost
+    double CostVariance;
     int PreviousRuns;
     bool RunSerial;
     double Timeout;
@@ -106,6 +115,8 @@ public:
     std::vector<std::string> Environment;
     std::vector<std::string> Labels;
     std::set<std::string> LockedResources;
+    //Requested quantities of named resources
+    std::map<std::string, double> Resources;
   };
 
   struct cmCTestTestResult
@@ -165,6 +176,7 @@ protected:
   bool CleanTestOutput(std::string& output, size_t length);
 
   double                  ElapsedTestingTime;
+  double                  PredictedTestingTime;
 
   typedef std::vector<cmCTestTestResult> TestResultsVector;
   TestResultsVector    TestResults;
@@ -177,6 +189,7 @@ protected:
   bool MemCheck;
   int CustomMaximumPassedTestOutputSize;
   int CustomMaximumFailedTestOutputSize;
+  int CustomTestOutputBufferSize;
   int MaxIndex;
 public:
   enum { // Program statuses
@@ -236,6 +249,24 @@ private:
   const char* GetTestStatus(int status);
   void ExpandTestsToRunInformation(size_t numPossibleTests);
 
+  /**
+   * Read the quantities of named resources available to the tests
+   */
+  bool ReadResourceSpecFile(const char* fname);
+  // Parse a "name=quantity" entry.  The quantity may have a K, M, G
+  // or T suffix for multiples of 1024.
+  static bool ParseResource(std::string const& entry, std::string& name,
+                            double& quantity);
+  std::map<std::string, double> ResourceCapacities;
+  // Directory in which the full output of each test is written.
+  std::string TestOutputDirectory;
+
+  // Keep only the tests in shard ShardIndex of ShardCount.  Groups of
+  // tests connected by DEPENDS are balanced across the shards by cost.
+  void ShardTestList();
+  int ShardIndex;
+  int ShardCount;
+
   std::vector<cmStdString> CustomPreTest;
   std::vector<cmStdString> CustomPostTest;
 
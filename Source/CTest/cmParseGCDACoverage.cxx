@@ -0,0 +1,1250 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc.
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmStandardIncludes.h"
+#include "cmSystemTools.h"
+#include "cmParseGCDACoverage.h"
+#include "cmCryptoHash.h"
+#include "cmGeneratedFileStream.h"
+
+#include "cmIML/INT.h"
+
+#include <cmsys/Directory.hxx>
+
+#include <limits.h>
+
+/*
+  The .gcno file written by the compiler describes the control flow
+  graph of each function: its basic blocks, the arcs between them and
+  the source lines of each block.  The .gcda file written by the
+  program gives the number of times each arc not on a spanning tree of
+  the graph was taken.  The counts of the other arcs and of the blocks
+  follow from the flow being conserved at each block.  Line counts are
+  then derived from the block and arc counts the way gcov does.
+
+  Both files are sequences of records made of 32 bit words.  Since gcc
+  12 record lengths are in bytes and strings are not padded.
+*/
+
+typedef cmIML_INT_int64_t cmParseGCDACount;
+
+static const unsigned int cmParseGCDANoteMagic = 0x67636e6f; // "gcno"
+static const unsigned int cmParseGCDADataMagic = 0x67636461; // "gcda"
+static const unsigned int cmParseGCDATagFunction = 0x01000000;
+static const unsigned int cmParseGCDATagBlocks = 0x01410000;
+static const unsigned int cmParseGCDATagArcs = 0x01430000;
+static const unsigned int cmParseGCDATagLines = 0x01450000;
+static const unsigned int cmParseGCDATagArcCounts = 0x01a10000;
+static const unsigned int cmParseGCDAArcOnTree = 1;
+static const unsigned int cmParseGCDAArcFake = 2;
+static const unsigned int cmParseGCDAArcFallThrough = 4;
+
+//----------------------------------------------------------------------------
+// The version is four characters: the major version as a letter for
+// its tens and a digit, the minor version and the release status.
+static bool cmParseGCDAVersionSupported(unsigned int version)
+{
+  char major = static_cast<char>((version >> 24) & 0xff);
+  char minor = static_cast<char>((version >> 16) & 0xff);
+  return (major == 'B' && minor >= '2' && minor <= '9') ||
+    (major > 'B' && major <= 'Z');
+}
+
+//----------------------------------------------------------------------------
+class cmParseGCDACoverage::Reader
+{
+public:
+  Reader(): Ok(false), Swap(false), Pos(0) {}
+  bool Ok;
+
+  bool Open(const char* file, unsigned int magic)
+    {
+    std::ifstream fin(file, std::ios::in | cmsys_ios_binary);
+    if(!fin)
+      {
+      return false;
+      }
+    fin.seekg(0, std::ios::end);
+    std::streamoff size = fin.tellg();
+    fin.seekg(0, std::ios::beg);
+    this->Data.resize(size > 0? static_cast<size_t>(size) : 0);
+    if(!this->Data.empty() &&
+       !fin.read(&this->Data[0], static_cast<std::streamsize>(size)))
+      {
+      return false;
+      }
+    this->Ok = true;
+    unsigned int m = this->ReadUnsigned();
+    if(this->Ok && m != magic)
+      {
+      this->Swap = true;
+      this->Ok = SwapBytes(m) == magic;
+      }
+    return this->Ok;
+    }
+  bool AtEnd() const { return this->Pos >= this->Data.size(); }
+  size_t Remaining() const
+    { return this->AtEnd()? 0 : this->Data.size() - this->Pos; }
+  size_t GetPosition() const { return this->Pos; }
+  void Seek(size_t pos)
+    {
+    this->Ok = this->Ok && pos <= this->Data.size();
+    this->Pos = pos;
+    }
+  unsigned int ReadUnsigned()
+    {
+    if(!this->Ok || this->Remaining() < 4)
+      {
+      this->Ok = false;
+      return 0;
+      }
+    const unsigned char* p =
+      reinterpret_cast<const unsigned char*>(&this->Data[this->Pos]);
+    this->Pos += 4;
+    unsigned int value;
+    memcpy(&value, p, 4);
+    return this->Swap? SwapBytes(value) : value;
+    }
+  cmParseGCDACount ReadCounter()
+    {
+    cmIML_INT_uint64_t low = this->ReadUnsigned();
+    cmIML_INT_uint64_t high = this->ReadUnsigned();
+    return static_cast<cmParseGCDACount>(low | (high << 32));
+    }
+  // Read a string and return whether it is not null.
+  bool ReadString(std::string& s)
+    {
+    s = "";
+    unsigned int length = this->ReadUnsigned();
+    if(!this->Ok || length == 0)
+      {
+      return false;
+      }
+    if(this->Remaining() < length)
+      {
+      this->Ok = false;
+      return false;
+      }
+    s.assign(&this->Data[this->Pos], length - 1);
+    this->Pos += length;
+    return true;
+    }
+  void SkipString()
+    {
+    unsigned int length = this->ReadUnsigned();
+    this->Seek(this->Pos + length);
+    }
+private:
+  bool Swap;
+  size_t Pos;
+  std::vector<char> Data;
+  static unsigned int SwapBytes(unsigned int v)
+    {
+    return ((v >> 24) & 0xff) | ((v >> 8) & 0xff00) |
+      ((v << 8) & 0xff0000) | ((v << 24) & 0xff000000);
+    }
+};
+
+//----------------------------------------------------------------------------
+struct cmParseGCDAFunction
+{
+  struct Arc
+  {
+    unsigned int Src;
+    unsigned int Dst;
+    unsigned int Flags;
+    bool Valid;
+    bool Throw;
+    cmParseGCDACount Count;
+    cmParseGCDACount CycleCount;
+  };
+  struct Location
+  {
+    unsigned int Source;
+    std::vector<unsigned int> Lines;
+  };
+  struct Block
+  {
+    std::vector<size_t> Succ;
+    std::vector<size_t> Pred;
+    std::vector<Location> Locations;
+    bool Valid;
+    bool Exceptional;
+    cmParseGCDACount Count;
+  };
+  // A line of a function that shares its first line with others, such
+  // as the instantiations of a template.
+  struct Line
+  {
+    Line(): Exists(false), Unexceptional(false), Count(0) {}
+    bool Exists;
+    bool Unexceptional;
+    cmParseGCDACount Count;
+    std::vector<std::pair<cmParseGCDAFunction*, size_t> > Blocks;
+  };
+
+  cmParseGCDAFunction(): Ident(0), LinenoChecksum(0), CfgChecksum(0),
+    Artificial(false), Source(0), StartLine(0), EndLine(0),
+    HasCounts(false), Group(false) {}
+  unsigned int Ident;
+  unsigned int LinenoChecksum;
+  unsigned int CfgChecksum;
+  bool Artificial;
+  unsigned int Source;
+  unsigned int StartLine;
+  unsigned int EndLine;
+  std::vector<Block> Blocks;
+  std::vector<Arc> Arcs;
+  std::vector<cmParseGCDACount> Counts;
+  bool HasCounts;
+  bool Group;
+  std::vector<Line> Lines;
+
+  bool IsGroupLine(unsigned int source, unsigned int line) const
+    {
+    return this->Group && source == this->Source &&
+      line >= this->StartLine && line <= this->EndLine;
+    }
+};
+
+typedef cmParseGCDAFunction::Line cmParseGCDALine;
+typedef std::pair<cmParseGCDAFunction*, size_t> cmParseGCDABlockRef;
+
+//----------------------------------------------------------------------------
+cmParseGCDACoverage::cmParseGCDACoverage()
+{
+  this->CacheHit = false;
+}
+
+//----------------------------------------------------------------------------
+cmParseGCDACoverage::~cmParseGCDACoverage()
+{
+  this->Clear();
+}
+
+//----------------------------------------------------------------------------
+void cmParseGCDACoverage::Clear()
+{
+  for(std::vector<Function*>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    delete *fi;
+    }
+  this->Functions.clear();
+  this->SourceFiles.clear();
+  this->SourceIndex.clear();
+  this->Cwd = "";
+  this->Error = "";
+}
+
+//----------------------------------------------------------------------------
+bool cmParseGCDACoverage::ReadGCDAFile(const char* gcdaFile,
+                                       FileLinesType& lines)
+{
+  this->Clear();
+  std::string gcnoFile = gcdaFile;
+  std::string::size_type dot = gcnoFile.rfind('.');
+  if(dot == std::string::npos)
+    {
+    this->Error = "Not a .gcda file";
+    return false;
+    }
+  gcnoFile = gcnoFile.substr(0, dot) + ".gcno";
+  this->CacheHit = false;
+  if(this->CacheDirectory.empty())
+    {
+    return this->ReadFiles(gcdaFile, gcnoFile.c_str(), lines);
+    }
+
+  // The counts depend on the contents of both files, and the same
+  // contents may be found for two objects of a source file.
+  cmCryptoHashMD5 md5;
+  std::string gcdaHash = md5.HashFile(gcdaFile);
+  std::string gcnoHash = md5.HashFile(gcnoFile.c_str());
+  if(gcdaHash.empty() || gcnoHash.empty())
+    {
+    return this->ReadFiles(gcdaFile, gcnoFile.c_str(), lines);
+    }
+  std::string hashes = gcdaHash + " " + gcnoHash;
+  std::string gcdaPath = cmSystemTools::CollapseFullPath(gcdaFile);
+  std::string cacheFile = this->GetCacheFile(gcdaPath);
+  if(this->ReadCacheFile(cacheFile, gcdaPath, hashes, lines))
+    {
+    this->CacheHit = true;
+    return true;
+    }
+  if(!this->ReadFiles(gcdaFile, gcnoFile.c_str(), lines))
+    {
+    return false;
+    }
+  this->WriteCacheFile(cacheFile, gcdaPath, hashes, lines);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmParseGCDACoverage::ReadFiles(const char* gcdaFile,
+                                    const char* gcnoFile,
+                                    FileLinesType& lines)
+{
+  unsigned int stamp = 0;
+  if(!this->ReadNotes(gcnoFile, stamp) ||
+     !this->ReadData(gcdaFile, stamp))
+    {
+    return false;
+    }
+  for(std::vector<Function*>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    Function& fn = **fi;
+    if(fn.HasCounts && !fn.Artificial)
+      {
+      if(!this->SolveFlowGraph(fn))
+        {
+        return false;
+        }
+      this->FindExceptionBlocks(fn);
+      }
+    }
+  this->ComputeLines(lines);
+  return true;
+}
+
+// Version of the cache file format and of the line counts stored in
+// it.  Changing it invalidates all existing cache files.
+static const char cmParseGCDACacheVersion[] = "cmParseGCDACoverage 2";
+
+//----------------------------------------------------------------------------
+std::string cmParseGCDACoverage::GetCacheFile(std::string const& gcdaPath)
+{
+  // Each .gcda file has one entry replaced whenever its counts change.
+  cmCryptoHashMD5 md5;
+  std::string key = cmParseGCDACacheVersion;
+  key += "\n" + gcdaPath;
+  return this->CacheDirectory + "/" + md5.HashString(key.c_str()) + ".txt";
+}
+
+//----------------------------------------------------------------------------
+bool cmParseGCDACoverage::ReadCacheFile(std::string const& cacheFile,
+                                        std::string const& gcdaPath,
+                                        std::string const& hashes,
+                                        FileLinesType& lines)
+{
+  // The file holds the version line, the path of the .gcda file, the
+  // hashes of the .gcda and .gcno files, and then the name of each
+  // source file followed by a line with its counts.
+  std::ifstream fin(cacheFile.c_str());
+  if(!fin)
+    {
+    return false;
+    }
+  std::string line;
+  std::string path;
+  std::string stored;
+  if(!cmSystemTools::GetLineFromStream(fin, line) ||
+     line != cmParseGCDACacheVersion ||
+     !cmSystemTools::GetLineFromStream(fin, path) || path != gcdaPath ||
+     !cmSystemTools::GetLineFromStream(fin, stored) || stored != hashes)
+    {
+    return false;
+    }
+  FileLinesType cached;
+  std::string name;
+  while(cmSystemTools::GetLineFromStream(fin, name))
+    {
+    if(!cmSystemTools::GetLineFromStream(fin, line))
+      {
+      return false;
+      }
+    std::vector<int>& counts = cached[name];
+    const char* c = line.c_str();
+    char* end;
+    for(long count = strtol(c, &end, 10); end != c;
+        count = strtol(c, &end, 10))
+      {
+      counts.push_back(static_cast<int>(count));
+      c = end;
+      }
+    }
+  lines.swap(cached);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmParseGCDACoverage::WriteCacheFile(std::string const& cacheFile,
+                                         std::string const& gcdaPath,
+                                         std::string const& hashes,
+                                         FileLinesType const& lines)
+{
+  cmSystemTools::MakeDirectory(this->CacheDirectory.c_str());
+  cmGeneratedFileStream fout(cacheFile.c_str(), true);
+  fout << cmParseGCDACacheVersion << "\n";
+  fout << gcdaPath << "\n" << hashes << "\n";
+  for(FileLinesType::const_iterator li = lines.begin();
+      li != lines.end(); ++li)
+    {
+    fout << li->first << "\n";
+    for(std::vector<int>::const_iterator ci = li->second.begin();
+        ci != li->second.end(); ++ci)
+      {
+      fout << (ci == li->second.begin()? "" : " ") << *ci;
+      }
+    fout << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmParseGCDACoverage::PruneCache()
+{
+  cmsys::Directory dir;
+  if(this->CacheDirectory.empty() ||
+     !dir.Load(this->CacheDirectory.c_str()))
+    {
+    return;
+    }
+  for(unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i)
+    {
+    std::string name = dir.GetFile(i);
+    if(cmSystemTools::GetFilenameLastExtension(name) != ".txt")
+      {
+      continue;
+      }
+    // Entries of an older format are never read again either.
+    std::string cacheFile = this->CacheDirectory + "/" + name;
+    bool keep = false;
+    {
+    std::ifstream fin(cacheFile.c_str());
+    std::string line;
+    std::string path;
+    keep = cmSystemTools::GetLineFromStream(fin, line) &&
+      line == cmParseGCDACacheVersion &&
+      cmSystemTools::GetLineFromStream(fin, path) &&
+      cmSystemTools::FileExists(path.c_str(), true);
+    }
+    if(!keep)
+      {
+      cmSystemTools::RemoveFile(cacheFile.c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+unsigned int cmParseGCDACoverage::GetSourceIndex(std::string const& file)
+{
+  // The notes name the source of every block, so look names up as given.
+  std::map<cmStdString, unsigned int>::iterator si =
+    this->SourceIndex.find(file);
+  if(si != this->SourceIndex.end())
+    {
+    return si->second;
+    }
+  std::string path = file;
+  if(!cmSystemTools::FileIsFullPath(path.c_str()) && !this->Cwd.empty())
+    {
+    path = this->Cwd + "/" + path;
+    }
+  unsigned int index = static_cast<unsigned int>(
+    std::find(this->SourceFiles.begin(), this->SourceFiles.end(), path) -
+    this->SourceFiles.begin());
+  if(index == this->SourceFiles.size())
+    {
+    this->SourceFiles.push_back(path);
+    }
+  this->SourceIndex[file] = index;
+  return index;
+}
+
+//----------------------------------------------------------------------------
+bool cmParseGCDACoverage::ReadNotes(const char* gcnoFile, unsigned int& stamp)
+{
+  Reader r;
+  if(!r.Open(gcnoFile, cmParseGCDANoteMagic))
+    {
+    this->Error = "Cannot read ";
+    this->Error += gcnoFile;
+    return false;
+    }
+  unsigned int version = r.ReadUnsigned();
+  if(!cmParseGCDAVersionSupported(version))
+    {
+    this->Error = "Unsupported version of ";
+    this->Error += gcnoFile;
+    return false;
+    }
+  stamp = r.ReadUnsigned();
+  r.ReadUnsigned(); // checksum
+  r.ReadString(this->Cwd);
+  r.ReadUnsigned(); // whether blocks may be partially executed
+
+  Function* fn = 0;
+  std::string source;
+  while(r.Ok && !r.AtEnd())
+    {
+    unsigned int tag = r.ReadUnsigned();
+    if(tag == 0)
+      {
+      break;
+      }
+    unsigned int length = r.ReadUnsigned();
+    if(!r.Ok || length > r.Remaining())
+      {
+      r.Ok = false;
+      break;
+      }
+    size_t end = r.GetPosition() + length;
+    if(tag == cmParseGCDATagFunction)
+      {
+      fn = new Function;
+      this->Functions.push_back(fn);
+      fn->Ident = r.ReadUnsigned();
+      fn->LinenoChecksum = r.ReadUnsigned();
+      fn->CfgChecksum = r.ReadUnsigned();
+      r.SkipString(); // name
+      fn->Artificial = r.ReadUnsigned() != 0;
+      r.ReadString(source);
+      fn->Source = this->GetSourceIndex(source);
+      fn->StartLine = r.ReadUnsigned();
+      r.ReadUnsigned(); // start column
+      fn->EndLine = r.ReadUnsigned();
+      }
+    else if(fn && tag == cmParseGCDATagBlocks)
+      {
+      // Every block but the entry block is the destination of an arc,
+      // and each arc takes 8 bytes in the rest of the file.  Do not let
+      // a corrupt count allocate more blocks than that.
+      unsigned int count = r.ReadUnsigned();
+      if(!r.Ok || count > r.Remaining() / 8 + 2)
+        {
+        r.Ok = false;
+        break;
+        }
+      fn->Blocks.resize(count);
+      }
+    else if(fn && tag == cmParseGCDATagArcs)
+      {
+      unsigned int src = r.ReadUnsigned();
+      if(src >= fn->Blocks.size())
+        {
+        r.Ok = false;
+        break;
+        }
+      fn->Arcs.reserve(fn->Arcs.size() + (end - r.GetPosition()) / 8);
+      while(r.Ok && r.GetPosition() + 8 <= end)
+        {
+        Function::Arc arc;
+        arc.Src = src;
+        arc.Dst = r.ReadUnsigned();
+        arc.Flags = r.ReadUnsigned();
+        arc.Valid = false;
+        arc.Throw = false;
+        arc.Count = 0;
+        arc.CycleCount = 0;
+        if(arc.Dst >= fn->Blocks.size())
+          {
+          r.Ok = false;
+          break;
+          }
+        fn->Blocks[src].Succ.push_back(fn->Arcs.size());
+        fn->Blocks[arc.Dst].Pred.push_back(fn->Arcs.size());
+        fn->Arcs.push_back(arc);
+        }
+      }
+    else if(fn && tag == cmParseGCDATagLines)
+      {
+      unsigned int blockIndex = r.ReadUnsigned();
+      if(blockIndex >= fn->Blocks.size())
+        {
+        r.Ok = false;
+        break;
+        }
+      Function::Block& block = fn->Blocks[blockIndex];
+      while(r.Ok)
+        {
+        unsigned int line = r.ReadUnsigned();
+        if(line)
+          {
+          if(block.Locations.empty())
+            {
+            block.Locations.push_back(Function::Location());
+            block.Locations.back().Source = fn->Source;
+            }
+          block.Locations.back().Lines.push_back(line);
+          continue;
+          }
+        if(!r.ReadString(source))
+          {
+          break;
+          }
+        block.Locations.push_back(Function::Location());
+        block.Locations.back().Source = this->GetSourceIndex(source);
+        }
+      }
+    r.Seek(end);
+    }
+  if(!r.Ok)
+    {
+    this->Error = "Corrupt notes file ";
+    this->Error += gcnoFile;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmParseGCDACoverage::ReadData(const char* gcdaFile, unsigned int stamp)
+{
+  Reader r;
+  if(!r.Open(gcdaFile, cmParseGCDADataMagic))
+    {
+    this->Error = "Cannot read ";
+    this->Error += gcdaFile;
+    return false;
+    }
+  unsigned int version = r.ReadUnsigned();
+  if(!cmParseGCDAVersionSupported(version))
+    {
+    this->Error = "Unsupported version of ";
+    this->Error += gcdaFile;
+    return false;
+    }
+  if(r.ReadUnsigned() != stamp)
+    {
+    this->Error = "Stamp mismatch with notes file for ";
+    this->Error += gcdaFile;
+    return false;
+    }
+  r.ReadUnsigned(); // checksum
+
+  // gcc writes the functions in the same order to both files, so look
+  // for each one after the previous before searching all of them.
+  std::map<unsigned int, Function*> functions;
+  size_t nextFunction = 0;
+  Function* fn = 0;
+  while(r.Ok && !r.AtEnd())
+    {
+    unsigned int tag = r.ReadUnsigned();
+    if(tag == 0)
+      {
+      break; // gcc may end a file with a zero word
+      }
+    unsigned int length = r.ReadUnsigned();
+    if(!r.Ok)
+      {
+      break;
+      }
+    // A negative length stands for that many bytes of zero counters.
+    int signedLength = static_cast<int>(length);
+    if(tag == cmParseGCDATagArcCounts && signedLength < 0)
+      {
+      if(fn)
+        {
+        fn->Counts.assign(static_cast<size_t>(-signedLength) / 8, 0);
+        fn->HasCounts = true;
+        }
+      continue;
+      }
+    if(length > r.Remaining())
+      {
+      r.Ok = false;
+      break;
+      }
+    size_t end = r.GetPosition() + length;
+    if(tag == cmParseGCDATagFunction)
+      {
+      fn = 0;
+      if(length > 0)
+        {
+        unsigned int ident = r.ReadUnsigned();
+        unsigned int linenoChecksum = r.ReadUnsigned();
+        unsigned int cfgChecksum = r.ReadUnsigned();
+        if(nextFunction < this->Functions.size() &&
+           this->Functions[nextFunction]->Ident == ident)
+          {
+          fn = this->Functions[nextFunction++];
+          }
+        else
+          {
+          if(functions.empty())
+            {
+            for(std::vector<Function*>::iterator fi =
+                  this->Functions.begin(); fi != this->Functions.end(); ++fi)
+              {
+              functions[(*fi)->Ident] = *fi;
+              }
+            }
+          std::map<unsigned int, Function*>::iterator fi =
+            functions.find(ident);
+          fn = fi != functions.end()? fi->second : 0;
+          }
+        if(!fn || fn->LinenoChecksum != linenoChecksum ||
+           fn->CfgChecksum != cfgChecksum)
+          {
+          this->Error = "Function mismatch with notes file in ";
+          this->Error += gcdaFile;
+          return false;
+          }
+        }
+      }
+    else if(fn && tag == cmParseGCDATagArcCounts)
+      {
+      fn->Counts.clear();
+      while(r.Ok && r.GetPosition() + 8 <= end)
+        {
+        fn->Counts.push_back(r.ReadCounter());
+        }
+      fn->HasCounts = true;
+      }
+    r.Seek(end);
+    }
+  if(!r.Ok)
+    {
+    this->Error = "Corrupt data file ";
+    this->Error += gcdaFile;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+struct cmParseGCDAArcDstLess
+{
+  cmParseGCDAArcDstLess(std::vector<cmParseGCDAFunction::Arc> const& arcs):
+    Arcs(arcs) {}
+  bool operator()(size_t l, size_t r) const
+    { return this->Arcs[l].Dst < this->Arcs[r].Dst; }
+  std::vector<cmParseGCDAFunction::Arc> const& Arcs;
+};
+
+//----------------------------------------------------------------------------
+static bool cmParseGCDANonZero(cmParseGCDACount count)
+{
+  return count != 0;
+}
+
+//----------------------------------------------------------------------------
+bool cmParseGCDACoverage::SolveFlowGraph(Function& fn)
+{
+  // Block 0 is the entry and block 1 the exit.  The counters are those
+  // of the arcs not on the spanning tree, block by block.
+  if(fn.Blocks.size() < 2)
+    {
+    return false;
+    }
+  size_t next = 0;
+  for(std::vector<Function::Block>::iterator bi = fn.Blocks.begin();
+      bi != fn.Blocks.end(); ++bi)
+    {
+    bi->Valid = false;
+    bi->Count = 0;
+    for(std::vector<size_t>::const_iterator ai = bi->Succ.begin();
+        ai != bi->Succ.end(); ++ai)
+      {
+      Function::Arc& arc = fn.Arcs[*ai];
+      if(!(arc.Flags & cmParseGCDAArcOnTree))
+        {
+        if(next >= fn.Counts.size())
+          {
+          this->Error = "Too few counters";
+          return false;
+          }
+        arc.Count = fn.Counts[next++];
+        arc.Valid = true;
+        }
+      }
+    }
+  if(next != fn.Counts.size())
+    {
+    this->Error = "Too many counters";
+    return false;
+    }
+
+  // Most functions of a program never run, so there is nothing to solve.
+  if(std::find_if(fn.Counts.begin(), fn.Counts.end(),
+                  cmParseGCDANonZero) == fn.Counts.end())
+    {
+    for(std::vector<Function::Block>::iterator bi = fn.Blocks.begin();
+        bi != fn.Blocks.end(); ++bi)
+      {
+      bi->Valid = true;
+      }
+    for(std::vector<Function::Arc>::iterator ai = fn.Arcs.begin();
+        ai != fn.Arcs.end(); ++ai)
+      {
+      ai->Count = 0;
+      ai->Valid = true;
+      }
+    return true;
+    }
+
+  // The spanning tree includes an arc from the exit to the entry that
+  // is not in the graph.  Add it while solving.
+  size_t exitArc = fn.Arcs.size();
+  Function::Arc virtualArc;
+  virtualArc.Src = 1;
+  virtualArc.Dst = 0;
+  virtualArc.Flags = cmParseGCDAArcOnTree;
+  virtualArc.Valid = false;
+  virtualArc.Throw = false;
+  virtualArc.Count = 0;
+  virtualArc.CycleCount = 0;
+  fn.Arcs.push_back(virtualArc);
+  fn.Blocks[1].Succ.push_back(exitArc);
+  fn.Blocks[0].Pred.push_back(exitArc);
+
+  // A block's count is known once all of its incoming or all of its
+  // outgoing arcs are known.  An arc is known once its block's count
+  // and all other arcs on that side are.
+  std::vector<size_t> work;
+  for(size_t b = 0; b < fn.Blocks.size(); ++b)
+    {
+    work.push_back(b);
+    }
+  while(!work.empty())
+    {
+    size_t b = work.back();
+    work.pop_back();
+    Function::Block& block = fn.Blocks[b];
+    for(int side = 0; side < 2; ++side)
+      {
+      std::vector<size_t> const& arcs = side? block.Pred : block.Succ;
+      cmParseGCDACount known = 0;
+      size_t unknown = 0;
+      size_t unknownArc = 0;
+      for(std::vector<size_t>::const_iterator ai = arcs.begin();
+          ai != arcs.end(); ++ai)
+        {
+        if(fn.Arcs[*ai].Valid)
+          {
+          known += fn.Arcs[*ai].Count;
+          }
+        else
+          {
+          ++unknown;
+          unknownArc = *ai;
+          }
+        }
+      if(!block.Valid && unknown == 0)
+        {
+        block.Count = known;
+        block.Valid = true;
+        work.push_back(b);
+        }
+      else if(block.Valid && unknown == 1)
+        {
+        Function::Arc& arc = fn.Arcs[unknownArc];
+        arc.Count = block.Count - known;
+        arc.Valid = true;
+        work.push_back(arc.Src);
+        work.push_back(arc.Dst);
+        }
+      }
+    }
+
+  fn.Arcs.pop_back();
+  fn.Blocks[1].Succ.pop_back();
+  fn.Blocks[0].Pred.pop_back();
+
+  // Like gcov, follow the arcs leaving a block in block order.
+  for(std::vector<Function::Block>::iterator bi = fn.Blocks.begin();
+      bi != fn.Blocks.end(); ++bi)
+    {
+    std::stable_sort(bi->Succ.begin(), bi->Succ.end(),
+                     cmParseGCDAArcDstLess(fn.Arcs));
+    }
+  for(std::vector<Function::Block>::const_iterator bi = fn.Blocks.begin();
+      bi != fn.Blocks.end(); ++bi)
+    {
+    if(!bi->Valid || bi->Count < 0)
+      {
+      this->Error = "Inconsistent counters";
+      return false;
+      }
+    }
+  for(std::vector<Function::Arc>::const_iterator ai = fn.Arcs.begin();
+      ai != fn.Arcs.end(); ++ai)
+    {
+    if(!ai->Valid || ai->Count < 0)
+      {
+      this->Error = "Inconsistent counters";
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmParseGCDACoverage::FindExceptionBlocks(Function& fn)
+{
+  // A fake arc leaving a block other than the entry is an exceptional
+  // exit from a call.  The other arcs of that block that do not fall
+  // through go to exception handlers.
+  bool hasCatch = false;
+  for(size_t b = 1; b < fn.Blocks.size(); ++b)
+    {
+    std::vector<size_t> const& succ = fn.Blocks[b].Succ;
+    bool callSite = false;
+    for(std::vector<size_t>::const_iterator ai = succ.begin();
+        ai != succ.end(); ++ai)
+      {
+      callSite = callSite || (fn.Arcs[*ai].Flags & cmParseGCDAArcFake);
+      }
+    for(std::vector<size_t>::const_iterator ai = succ.begin();
+        callSite && ai != succ.end(); ++ai)
+      {
+      Function::Arc& arc = fn.Arcs[*ai];
+      if(!(arc.Flags & (cmParseGCDAArcFake | cmParseGCDAArcFallThrough)))
+        {
+        arc.Throw = true;
+        hasCatch = true;
+        }
+      }
+    }
+
+  // Blocks that cannot be reached without an exception are exceptional.
+  for(std::vector<Function::Block>::iterator bi = fn.Blocks.begin();
+      bi != fn.Blocks.end(); ++bi)
+    {
+    bi->Exceptional = hasCatch;
+    }
+  if(!hasCatch)
+    {
+    return;
+    }
+  std::vector<size_t> queue(1, 0);
+  fn.Blocks[0].Exceptional = false;
+  while(!queue.empty())
+    {
+    size_t b = queue.back();
+    queue.pop_back();
+    std::vector<size_t> const& succ = fn.Blocks[b].Succ;
+    for(std::vector<size_t>::const_iterator ai = succ.begin();
+        ai != succ.end(); ++ai)
+      {
+      Function::Arc const& arc = fn.Arcs[*ai];
+      if(!(arc.Flags & cmParseGCDAArcFake) && !arc.Throw &&
+         fn.Blocks[arc.Dst].Exceptional)
+        {
+        fn.Blocks[arc.Dst].Exceptional = false;
+        queue.push_back(arc.Dst);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the elementary cycles through the start block among the blocks
+// of a line, as gcov does, and add the counts of their arcs.
+static bool cmParseGCDACircuit(cmParseGCDABlockRef v,
+  cmParseGCDABlockRef start,
+  cmParseGCDALine& line, std::vector<size_t>& path,
+  std::vector<cmParseGCDABlockRef>& blocked,
+  std::vector<std::vector<cmParseGCDABlockRef> >& blockLists,
+  cmParseGCDACount& count);
+
+static void cmParseGCDAUnblock(cmParseGCDABlockRef u,
+  std::vector<cmParseGCDABlockRef>& blocked,
+  std::vector<std::vector<cmParseGCDABlockRef> >& blockLists)
+{
+  std::vector<cmParseGCDABlockRef>::iterator it =
+    std::find(blocked.begin(), blocked.end(), u);
+  if(it == blocked.end())
+    {
+    return;
+    }
+  size_t index = it - blocked.begin();
+  blocked.erase(it);
+  std::vector<cmParseGCDABlockRef> toUnblock = blockLists[index];
+  blockLists.erase(blockLists.begin() + index);
+  for(std::vector<cmParseGCDABlockRef>::iterator ui = toUnblock.begin();
+      ui != toUnblock.end(); ++ui)
+    {
+    cmParseGCDAUnblock(*ui, blocked, blockLists);
+    }
+}
+
+static bool cmParseGCDAFollow(cmParseGCDAFunction::Arc const& arc,
+                              cmParseGCDABlockRef start,
+                              cmParseGCDALine const& line)
+{
+  cmParseGCDABlockRef w(start.first, arc.Dst);
+  return arc.Dst >= start.second && arc.CycleCount > 0 &&
+    std::find(line.Blocks.begin(), line.Blocks.end(), w) != line.Blocks.end();
+}
+
+static bool cmParseGCDACircuit(cmParseGCDABlockRef v,
+  cmParseGCDABlockRef start,
+  cmParseGCDALine& line, std::vector<size_t>& path,
+  std::vector<cmParseGCDABlockRef>& blocked,
+  std::vector<std::vector<cmParseGCDABlockRef> >& blockLists,
+  cmParseGCDACount& count)
+{
+  cmParseGCDAFunction& fn = *v.first;
+  bool found = false;
+  blocked.push_back(v);
+  blockLists.push_back(std::vector<cmParseGCDABlockRef>());
+  std::vector<size_t> const& succ = fn.Blocks[v.second].Succ;
+  for(std::vector<size_t>::const_iterator ai = succ.begin();
+      ai != succ.end(); ++ai)
+    {
+    if(!cmParseGCDAFollow(fn.Arcs[*ai], start, line))
+      {
+      continue;
+      }
+    cmParseGCDABlockRef w(v.first, fn.Arcs[*ai].Dst);
+    path.push_back(*ai);
+    if(w == start)
+      {
+      // Take the smallest count along the cycle out of all its arcs.
+      cmParseGCDACount cycle = fn.Arcs[path[0]].CycleCount;
+      for(std::vector<size_t>::const_iterator pi = path.begin();
+          pi != path.end(); ++pi)
+        {
+        cycle = std::min(cycle, fn.Arcs[*pi].CycleCount);
+        }
+      count += cycle;
+      for(std::vector<size_t>::const_iterator pi = path.begin();
+          pi != path.end(); ++pi)
+        {
+        fn.Arcs[*pi].CycleCount -= cycle;
+        }
+      found = true;
+      }
+    else if(std::find(blocked.begin(), blocked.end(), w) == blocked.end())
+      {
+      found = cmParseGCDACircuit(w, start, line, path, blocked, blockLists,
+                                 count) || found;
+      }
+    path.pop_back();
+    }
+  if(found)
+    {
+    cmParseGCDAUnblock(v, blocked, blockLists);
+    return true;
+    }
+  for(std::vector<size_t>::const_iterator ai = succ.begin();
+      ai != succ.end(); ++ai)
+    {
+    if(!cmParseGCDAFollow(fn.Arcs[*ai], start, line))
+      {
+      continue;
+      }
+    cmParseGCDABlockRef w(v.first, fn.Arcs[*ai].Dst);
+    size_t index = std::find(blocked.begin(), blocked.end(), w) -
+      blocked.begin();
+    if(index < blockLists.size())
+      {
+      std::vector<cmParseGCDABlockRef>& list = blockLists[index];
+      if(std::find(list.begin(), list.end(), v) == list.end())
+        {
+        list.push_back(v);
+        }
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Replace the sum of the block counts of a line by the number of times
+// the line was entered from other lines plus the number of times loops
+// within it went around.
+static void cmParseGCDAAccumulateLine(cmParseGCDALine& line)
+{
+  if(line.Blocks.empty())
+    {
+    return;
+    }
+  cmParseGCDACount count = 0;
+  bool executed = false;
+  for(std::vector<cmParseGCDABlockRef>::const_iterator bi =
+        line.Blocks.begin(); bi != line.Blocks.end(); ++bi)
+    {
+    cmParseGCDAFunction& fn = *bi->first;
+    cmParseGCDAFunction::Block const& block = fn.Blocks[bi->second];
+    for(std::vector<size_t>::const_iterator ai = block.Pred.begin();
+        ai != block.Pred.end(); ++ai)
+      {
+      cmParseGCDABlockRef src(bi->first, fn.Arcs[*ai].Src);
+      if(std::find(line.Blocks.begin(), line.Blocks.end(), src) ==
+         line.Blocks.end())
+        {
+        count += fn.Arcs[*ai].Count;
+        }
+      }
+    for(std::vector<size_t>::const_iterator ai = block.Succ.begin();
+        ai != block.Succ.end(); ++ai)
+      {
+      fn.Arcs[*ai].CycleCount = fn.Arcs[*ai].Count;
+      executed = executed || fn.Arcs[*ai].Count > 0;
+      }
+    }
+  // Loops can only have gone around lines that were executed.
+  for(std::vector<cmParseGCDABlockRef>::const_iterator bi =
+        line.Blocks.begin(); executed && bi != line.Blocks.end(); ++bi)
+    {
+    std::vector<size_t> path;
+    std::vector<cmParseGCDABlockRef> blocked;
+    std::vector<std::vector<cmParseGCDABlockRef> > blockLists;
+    cmParseGCDACircuit(*bi, *bi, line, path, blocked, blockLists, count);
+    }
+  line.Count = count;
+}
+
+//----------------------------------------------------------------------------
+// gcov marks lines that were not executed with "#####", or "=====" if
+// only exceptions lead to them.  Like the parser of its output, add the
+// count of a line and treat the latter as lines without code.
+static void cmParseGCDAAddLine(std::vector<int>& counts, unsigned int lineNo,
+                               cmParseGCDALine const& line)
+{
+  if(lineNo == 0 || !line.Exists || line.Count < 0 ||
+     (line.Count == 0 && !line.Unexceptional))
+    {
+    return;
+    }
+  if(counts.size() < lineNo)
+    {
+    counts.resize(lineNo, -1);
+    }
+  int& count = counts[lineNo - 1];
+  if(count < 0)
+    {
+    count = 0;
+    }
+  cmParseGCDACount sum = count + line.Count;
+  count = sum > INT_MAX? INT_MAX : static_cast<int>(sum);
+}
+
+//----------------------------------------------------------------------------
+void cmParseGCDACoverage::ComputeLines(FileLinesType& lines)
+{
+  // Functions starting on the same line of the same file form a group
+  // whose lines are counted separately and then added up.
+  std::map<std::pair<unsigned int, unsigned int>, int> starts;
+  for(std::vector<Function*>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    if(!(*fi)->Artificial)
+      {
+      ++starts[std::make_pair((*fi)->Source, (*fi)->StartLine)];
+      }
+    }
+
+  std::vector<std::map<unsigned int, cmParseGCDALine> >
+    sources(this->SourceFiles.size());
+  for(std::vector<Function*>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    Function& fn = **fi;
+    if(fn.Artificial || !fn.HasCounts)
+      {
+      continue;
+      }
+    fn.Group = starts[std::make_pair(fn.Source, fn.StartLine)] > 1;
+    if(fn.Group && fn.EndLine >= fn.StartLine)
+      {
+      fn.Lines.resize(fn.EndLine - fn.StartLine + 1);
+      }
+    for(size_t b = 0; b < fn.Blocks.size(); ++b)
+      {
+      Function::Block& block = fn.Blocks[b];
+      cmParseGCDALine* line = 0;
+      for(std::vector<Function::Location>::iterator li =
+            block.Locations.begin(); li != block.Locations.end(); ++li)
+        {
+        std::sort(li->Lines.begin(), li->Lines.end());
+        for(std::vector<unsigned int>::const_iterator ni = li->Lines.begin();
+            ni != li->Lines.end(); ++ni)
+          {
+          if(fn.IsGroupLine(li->Source, *ni) && !fn.Lines.empty())
+            {
+            line = &fn.Lines[*ni - fn.StartLine];
+            }
+          else
+            {
+            line = &sources[li->Source][*ni];
+            }
+          line->Exists = true;
+          if(!block.Exceptional)
+            {
+            line->Unexceptional = true;
+            }
+          line->Count += block.Count;
+          }
+        }
+      // Like gcov, leave out the first and the last block.
+      if(line && b != 0 && b + 1 != fn.Blocks.size())
+        {
+        line->Blocks.push_back(cmParseGCDABlockRef(&fn, b));
+        }
+      }
+    }
+
+  for(std::vector<Function*>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    for(std::vector<cmParseGCDALine>::iterator li = (*fi)->Lines.begin();
+        li != (*fi)->Lines.end(); ++li)
+      {
+      cmParseGCDAAccumulateLine(*li);
+      }
+    }
+  for(std::vector<std::map<unsigned int, cmParseGCDALine> >::iterator si =
+        sources.begin(); si != sources.end(); ++si)
+    {
+    for(std::map<unsigned int, cmParseGCDALine>::iterator li = si->begin();
+        li != si->end(); ++li)
+      {
+      cmParseGCDAAccumulateLine(li->second);
+      }
+    }
+  for(std::vector<Function*>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    Function& fn = **fi;
+    for(size_t i = 0; i < fn.Lines.size(); ++i)
+      {
+      if(fn.Lines[i].Exists)
+        {
+        cmParseGCDALine& line = sources[fn.Source][fn.StartLine + i];
+        line.Exists = true;
+        line.Count += fn.Lines[i].Count;
+        line.Unexceptional = line.Unexceptional || fn.Lines[i].Unexceptional;
+        }
+      }
+    }
+
+  // Each group function also lists its own lines after those of the
+  // source, so add them again as the parser of gcov output does.
+  for(size_t s = 0; s < sources.size(); ++s)
+    {
+    if(sources[s].empty())
+      {
+      continue;
+      }
+    std::vector<int>& counts = lines[this->SourceFiles[s]];
+    counts.assign(sources[s].rbegin()->first, -1);
+    for(std::map<unsigned int, cmParseGCDALine>::const_iterator li =
+          sources[s].begin(); li != sources[s].end(); ++li)
+      {
+      cmParseGCDAAddLine(counts, li->first, li->second);
+      }
+    }
+  for(std::vector<Function*>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    Function& fn = **fi;
+    for(size_t i = 0; i < fn.Lines.size(); ++i)
+      {
+      cmParseGCDAAddLine(lines[this->SourceFiles[fn.Source]],
+                         static_cast<unsigned int>(fn.StartLine + i),
+                         fn.Lines[i]);
+      }
+    }
+}
@@ -0,0 +1,91 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc.
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+
+#ifndef cmParseGCDACoverage_h
+#define cmParseGCDACoverage_h
+
+#include "cmStandardIncludes.h"
+
+struct cmParseGCDAFunction;
+
+/** \class cmParseGCDACoverage
+ * \brief Read gcc coverage data without running gcov
+ *
+ * This class reads a .gcda file and the .gcno file next to it and
+ * computes the line counts gcov would write to its .gcov files.  Only
+ * the format written by gcc 12 and later is understood.  Reading fails
+ * for other formats and for inconsistent files so that the caller can
+ * run gcov on them instead.
+ *
+ * When a cache directory is set the line counts computed for a .gcda
+ * file are stored there, one entry per .gcda file, together with hashes
+ * of the .gcda and .gcno contents.  They are read back the next time
+ * the same files are given.
+ */
+class cmParseGCDACoverage
+{
+public:
+  /** Line counts of each source file, indexed by line number minus
+      one.  Lines without code have a count of -1.  */
+  typedef std::map<cmStdString, std::vector<int> > FileLinesType;
+
+  cmParseGCDACoverage();
+  ~cmParseGCDACoverage();
+
+  /** Read a .gcda file and its .gcno file and store the line counts of
+      the source files they cover.  */
+  bool ReadGCDAFile(const char* gcdaFile, FileLinesType& lines);
+
+  /** Set the directory in which to cache the line counts of each
+      coverage file.  An empty name disables the cache.  */
+  void SetCacheDirectory(std::string const& dir)
+    { this->CacheDirectory = dir; }
+
+  /** Remove the cached counts of .gcda files that no longer exist.  */
+  void PruneCache();
+
+  /** Get whether the last file read was found in the cache.  */
+  bool GetCacheHit() const { return this->CacheHit; }
+
+  /** Get the reason the last file could not be read.  */
+  std::string const& GetError() const { return this->Error; }
+
+private:
+  class Reader;
+  typedef cmParseGCDAFunction Function;
+  std::vector<Function*> Functions;
+  std::vector<std::string> SourceFiles;
+  std::map<cmStdString, unsigned int> SourceIndex;
+  std::string Error;
+  std::string CacheDirectory;
+  bool CacheHit;
+
+  void Clear();
+  bool ReadFiles(const char* gcdaFile, const char* gcnoFile,
+                 FileLinesType& lines);
+  std::string GetCacheFile(std::string const& gcdaPath);
+  bool ReadCacheFile(std::string const& cacheFile,
+                     std::string const& gcdaPath, std::string const& hashes,
+                     FileLinesType& lines);
+  void WriteCacheFile(std::string const& cacheFile,
+                      std::string const& gcdaPath, std::string const& hashes,
+                      FileLinesType const& lines);
+  bool ReadNotes(const char* gcnoFile, unsigned int& stamp);
+  bool ReadData(const char* gcdaFile, unsigned int stamp);
+  bool SolveFlowGraph(Function& fn);
+  void FindExceptionBlocks(Function& fn);
+  void ComputeLines(FileLinesType& lines);
+  unsigned int GetSourceIndex(std::string const& file);
+  std::string Cwd;
+};
+
+#endif
@@ -13,6 +13,9 @@
 #include <cmProcess.h>
 #include <cmSystemTools.h>
 
+// Longest line of test output kept whole.
+static const std::vector<char>::size_type cmProcessMaxLineLength = 64 * 1024;
+
 cmProcess::cmProcess()
 {
   this->Process = 0;
@@ -68,7 +71,26 @@ bool cmProcess::StartProcess()
 }
 
 //----------------------------------------------------------------------------
-bool cmProcess::Buffer::GetLine(std::string& line)
+bool cmProcess::WaitForAny(std::vector<cmProcess*> const& processes,
+                           double timeout)
+{
+  std::vector<cmsysProcess*> kwsysProcesses;
+  for(std::vector<cmProcess*>::const_iterator i = processes.begin();
+      i != processes.end(); ++i)
+    {
+    kwsysProcesses.push_back((*i)->Process);
+    }
+  if(kwsysProcesses.empty())
+    {
+    return true;
+    }
+  return cmsysProcess_WaitForAny(&*kwsysProcesses.begin(),
+                                 static_cast<int>(kwsysProcesses.size()),
+                                 &timeout) != 0;
+}
+
+//----------------------------------------------------------------------------
+bool cmProcess::Buffer::GetLine(std::string& line, bool& complete)
 {
   // Scan for the next newline.
   for(size_type sz = this->size(); this->Last != sz; ++this->Last)
@@ -83,6 +105,7 @@ bool cmProcess::Buffer::GetLine(std::string& line)
         length --;
         }
       line.assign(text, length);
+      complete = true;
 
       // Start a new range for the next line.
       ++this->Last;
@@ -93,7 +116,16 @@ bool cmProcess::Buffer::GetLine(std::string& line)
       }
     }
 
-  // Available data have been exhausted without a newline.
+  // Available data have been exhausted without a newline.  Return a
+  // line that grows too long in pieces so the buffer stays bounded.
+  if(this->Last - this->First >= cmProcessMaxLineLength)
+    {
+    line.assign(&*this->begin() + this->First, this->Last - this->First);
+    complete = false;
+    this->First = this->Last = 0;
+    this->clear();
+    return true;
+    }
   if(this->First != 0)
     {
     // Move the partial line to the beginning of the buffer.
@@ -119,16 +151,17 @@ bool cmProcess::Buffer::GetLast(std::string& line)
 }
 
 //----------------------------------------------------------------------------
-int cmProcess::GetNextOutputLine(std::string& line, double timeout)
+int cmProcess::GetNextOutputLine(std::string& line, bool& complete,
+                                 double timeout)
 {
   for(;;)
     {
     // Look for lines already buffered.
-    if(this->StdOut.GetLine(line))
+    if(this->StdOut.GetLine(line, complete))
       {
       return cmsysProcess_Pipe_STDOUT;
       }
-    else if(this->StdErr.GetLine(line))
+    else if(this->StdErr.GetLine(line, complete))
       {
       return cmsysProcess_Pipe_STDERR;
       }
@@ -157,6 +190,7 @@ int cmProcess::GetNextOutputLine(std::string& line, double timeout)
     }
 
   // Look for partial last lines.
+  complete = true;
   if(this->StdOut.GetLast(line))
     {
     return cmsysProcess_Pipe_STDOUT;
@@ -51,8 +51,17 @@ public:
    *   cmsysProcess_Pipe_STDOUT  = Line came from stdout
    *   cmsysProcess_Pipe_STDOUT  = Line came from stderr
    *   cmsysProcess_Pipe_Timeout = Timeout expired while waiting
+   * A line too long to buffer is returned in pieces.  Only the last
+   * piece is complete.
    */
-  int GetNextOutputLine(std::string& line, double timeout);
+  int GetNextOutputLine(std::string& line, bool& complete, double timeout);
+  /**
+   * Block until any of the given processes may have output to read or
+   * may have terminated, but for no more than timeout.  Returns false
+   * if the timeout expired first.
+   */
+  static bool WaitForAny(std::vector<cmProcess*> const& processes,
+                         double timeout);
 private:
   double Timeout;
   double StartTime;
@@ -65,7 +74,7 @@ private:
     size_type Last;
   public:
     Buffer(): First(0), Last(0) {}
-    bool GetLine(std::string& line);
+    bool GetLine(std::string& line, bool& complete);
     bool GetLast(std::string& line);
   };
   Buffer StdErr;
@@ -12,9 +12,13 @@
 #include "cmArchiveWrite.h"
 
 #include "cmSystemTools.h"
+#include "cmCryptoHash.h"
+#include "cmWorkerPool.h"
 #include <cmsys/ios/iostream>
 #include <cmsys/Directory.hxx>
 #include <cm_libarchive.h>
+#include <cm_zlib.h>
+#include <cm_bzlib.h>
 
 //----------------------------------------------------------------------------
 class cmArchiveWrite::Entry
@@ -26,6 +30,165 @@ public:
   operator struct archive_entry*() { return this->Object; }
 };
 
+//----------------------------------------------------------------------------
+// Compress the uncompressed archive libarchive writes in blocks of a
+// fixed size, each on its own thread, and write the results in order.
+// Each block becomes a complete gzip member or bzip2 stream.
+class cmArchiveWrite::BlockCompressor
+{
+public:
+  BlockCompressor(std::ostream& os, Compress c, unsigned int threads):
+    Stream(os), Type(c), Threads(threads), Next(0), Written(false) {}
+  ~BlockCompressor();
+  bool Write(const char* data, size_t n);
+  bool Finish();
+private:
+  class Block;
+  bool CompressBlocks(size_t count);
+  std::ostream& Stream;
+  Compress Type;
+  unsigned int Threads;
+  std::vector<Block*> Blocks;
+  size_t Next;
+  bool Written;
+};
+
+//----------------------------------------------------------------------------
+class cmArchiveWrite::BlockCompressor::Block: public cmWorkerPool::Job
+{
+public:
+  // Large enough to lose little compression at the block boundaries.
+  static const size_t Size = 1024 * 1024;
+  Block(Compress c): Okay(false), Type(c) { this->In.reserve(Size); }
+  virtual void Run()
+    {
+    this->Okay = (this->Type == CompressGZip)? this->GZip() : this->BZip2();
+    this->In.clear();
+    }
+  std::vector<char> In;
+  std::vector<char> Out;
+  bool Okay;
+private:
+  Compress Type;
+  bool GZip();
+  bool BZip2();
+};
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::BlockCompressor::Block::GZip()
+{
+  z_stream s;
+  memset(&s, 0, sizeof(s));
+  // A window size above 15 selects the gzip wrapper.
+  if(deflateInit2(&s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                  Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+    return false;
+    }
+  // The bound of older zlib versions does not count the gzip wrapper.
+  uLong in = static_cast<uLong>(this->In.size());
+  this->Out.resize(deflateBound(&s, in) + 32);
+  s.next_in = in? reinterpret_cast<Bytef*>(&this->In[0]) : Z_NULL;
+  s.avail_in = static_cast<uInt>(in);
+  s.next_out = reinterpret_cast<Bytef*>(&this->Out[0]);
+  s.avail_out = static_cast<uInt>(this->Out.size());
+  int result = deflate(&s, Z_FINISH);
+  this->Out.resize(s.total_out);
+  deflateEnd(&s);
+  return result == Z_STREAM_END;
+}
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::BlockCompressor::Block::BZip2()
+{
+  // The worst case size documented by bzip2.
+  unsigned int in = static_cast<unsigned int>(this->In.size());
+  unsigned int out = in + in / 100 + 600;
+  this->Out.resize(out);
+  char empty = 0;
+  int result = BZ2_bzBuffToBuffCompress(&this->Out[0], &out,
+                                        in? &this->In[0] : &empty, in,
+                                        9, 0, 30);
+  this->Out.resize(out);
+  return result == BZ_OK;
+}
+
+//----------------------------------------------------------------------------
+cmArchiveWrite::BlockCompressor::~BlockCompressor()
+{
+  for(std::vector<Block*>::iterator i = this->Blocks.begin();
+      i != this->Blocks.end(); ++i)
+    {
+    delete *i;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::BlockCompressor::Write(const char* data, size_t n)
+{
+  while(n > 0)
+    {
+    if(this->Next == this->Blocks.size())
+      {
+      this->Blocks.push_back(new Block(this->Type));
+      }
+    std::vector<char>& in = this->Blocks[this->Next]->In;
+    size_t room = Block::Size - in.size();
+    size_t len = n < room? n : room;
+    in.insert(in.end(), data, data + len);
+    data += len;
+    n -= len;
+    // Keep every thread busy with two blocks at a time.
+    if(in.size() == Block::Size &&
+       ++this->Next == 2 * this->Threads &&
+       !this->CompressBlocks(this->Next))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::BlockCompressor::Finish()
+{
+  size_t count = this->Next;
+  if(count < this->Blocks.size() && !this->Blocks[count]->In.empty())
+    {
+    ++count;
+    }
+  if(count == 0 && !this->Written)
+    {
+    // Write an empty stream rather than nothing.
+    if(this->Blocks.empty())
+      {
+      this->Blocks.push_back(new Block(this->Type));
+      }
+    count = 1;
+    }
+  return this->CompressBlocks(count);
+}
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::BlockCompressor::CompressBlocks(size_t count)
+{
+  std::vector<cmWorkerPool::Job*> jobs(this->Blocks.begin(),
+                                       this->Blocks.begin() + count);
+  cmWorkerPool::RunJobs(jobs, this->Threads);
+  this->Next = 0;
+  this->Written = true;
+  for(size_t i = 0; i < count; ++i)
+    {
+    std::vector<char>& out = this->Blocks[i]->Out;
+    if(!this->Blocks[i]->Okay ||
+       !this->Stream.write(&out[0], static_cast<std::streamsize>(out.size())))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 struct cmArchiveWrite::Callback
 {
@@ -34,6 +197,11 @@ struct cmArchiveWrite::Callback
                             const void *b, size_t n)
     {
     cmArchiveWrite* self = static_cast<cmArchiveWrite*>(cd);
+    if(self->Blocks)
+      {
+      return static_cast<__LA_SSIZE_T>(
+        self->Blocks->Write(static_cast<const char*>(b), n)? n : -1);
+      }
     if(self->Stream.write(static_cast<const char*>(b),
                           static_cast<cmsys_ios::streamsize>(n)))
       {
@@ -47,12 +215,30 @@ struct cmArchiveWrite::Callback
 };
 
 //----------------------------------------------------------------------------
-cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c, Type t):
+cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c, Type t,
+                               unsigned int threads):
   Stream(os),
   Archive(archive_write_new()),
   Disk(archive_read_disk_new()),
-  Verbose(false)
+  Blocks(0),
+  Closed(false),
+  Verbose(false),
+  Uid(-1),
+  Gid(-1),
+  Checksum(0)
 {
+  if(threads == 0)
+    {
+    threads = cmWorkerPool::GetDefaultThreadCount();
+    }
+  if(threads > 1 && t == TypeTAR &&
+     (c == CompressGZip || c == CompressBZip2))
+    {
+    // Let libarchive write the archive uncompressed and compress it in
+    // blocks on several threads.
+    this->Blocks = new BlockCompressor(os, c, threads);
+    c = CompressNone;
+    }
   switch (c)
     {
     case CompressNone:
@@ -154,8 +340,44 @@ cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c, Type t):
 //----------------------------------------------------------------------------
 cmArchiveWrite::~cmArchiveWrite()
 {
+  this->Close();
   archive_read_finish(this->Disk);
   archive_write_finish(this->Archive);
+  delete this->Checksum;
+}
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::Close()
+{
+  if(this->Closed)
+    {
+    return this->Okay();
+    }
+  this->Closed = true;
+  if(archive_write_close(this->Archive) != ARCHIVE_OK && this->Okay())
+    {
+    this->Error = "archive_write_close: ";
+    this->Error += archive_error_string(this->Archive);
+    }
+  if(this->Blocks)
+    {
+    // Compress and write the last blocks.
+    if(!this->Blocks->Finish() && this->Okay())
+      {
+      this->Error = "Error compressing the end of the archive";
+      }
+    delete this->Blocks;
+    this->Blocks = 0;
+    }
+  return this->Okay();
+}
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::SetChecksumAlgorithm(const char* algo)
+{
+  delete this->Checksum;
+  this->Checksum = cmCryptoHash::New(algo).release();
+  return this->Checksum != 0;
 }
 
 //----------------------------------------------------------------------------
@@ -241,6 +463,16 @@ bool cmArchiveWrite::AddFile(const char* file,
   archive_entry_acl_clear(e);
   archive_entry_xattr_clear(e);
   archive_entry_set_fflags(e, 0, 0);
+  if(this->Uid >= 0 && this->Gid >= 0)
+    {
+    archive_entry_set_uid(e, this->Uid);
+    archive_entry_set_gid(e, this->Gid);
+    }
+  if(!this->Uname.empty() && !this->Gname.empty())
+    {
+    archive_entry_set_uname(e, this->Uname.c_str());
+    archive_entry_set_gname(e, this->Gname.c_str());
+    }
   if(archive_write_header(this->Archive, e) != ARCHIVE_OK)
     {
     this->Error = "archive_write_header: ";
@@ -251,17 +483,32 @@ bool cmArchiveWrite::AddFile(const char* file,
   // do not copy content of symlink
   if (!archive_entry_symlink(e))
     {
+    cmCryptoHash* hash = 0;
+    if(this->Checksum && archive_entry_filetype(e) == AE_IFREG)
+      {
+      hash = this->Checksum;
+      hash->Initialize();
+      }
     // Content.
     if(size_t size = static_cast<size_t>(archive_entry_size(e)))
       {
-      return this->AddData(file, size);
+      if(!this->AddData(file, size, hash))
+        {
+        return false;
+        }
+      }
+    if(hash)
+      {
+      this->Checksums.push_back(ChecksumList::value_type(dest,
+                                                         hash->Finalize()));
       }
     }
   return true;
 }
 
 //----------------------------------------------------------------------------
-bool cmArchiveWrite::AddData(const char* file, size_t size)
+bool cmArchiveWrite::AddData(const char* file, size_t size,
+                             cmCryptoHash* hash)
 {
   std::ifstream fin(file, std::ios::in | cmsys_ios_binary);
   if(!fin)
@@ -294,6 +541,11 @@ bool cmArchiveWrite::AddData(const char* file, size_t size)
       this->Error += archive_error_string(this->Archive);
       return false;
       }
+    if(hash)
+      {
+      hash->Append(reinterpret_cast<unsigned char const*>(buffer),
+                   static_cast<int>(nnext));
+      }
     nleft -= nnext;
     }
   if(nleft > 0)
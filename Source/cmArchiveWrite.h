@@ -18,6 +18,8 @@
 # error "cmArchiveWrite not allowed during bootstrap build!"
 #endif
 
+class cmCryptoHash;
+
 /** \class cmArchiveWrite
  * \brief Wrapper around libarchive for writing.
  *
@@ -45,8 +47,15 @@ public:
     TypeZIP
   };
 
-  /** Construct with output stream to which to write archive.  */
-  cmArchiveWrite(std::ostream& os, Compress c = CompressNone, Type = TypeTAR);
+  /**
+   * Construct with output stream to which to write archive.  A tar
+   * archive compressed with gzip or bzip2 is compressed on the given
+   * number of threads, or on as many as the machine has for 0, in
+   * independent blocks.  Tools that read these formats decompress the
+   * blocks as one stream.
+   */
+  cmArchiveWrite(std::ostream& os, Compress c = CompressNone,
+                 Type = TypeTAR, unsigned int threads = 1);
   ~cmArchiveWrite();
 
   /**
@@ -59,6 +68,14 @@ public:
    */
   bool Add(std::string path, size_t skip = 0, const char* prefix = 0);
 
+  /**
+   * Finish writing the archive.  Returns false, and sets the error, if
+   * the end of the archive could not be compressed or written.  The
+   * destructor closes an archive that was not closed but cannot report
+   * an error.
+   */
+  bool Close();
+
   /** Returns true if there has been no error.  */
   operator safe_bool() const
     { return this->Okay()? &cmArchiveWrite::safe_bool_true : 0; }
@@ -73,22 +90,55 @@ public:
   // std::cout.
   void SetVerbose(bool v) { this->Verbose = v; }
 
+  /** Record the given owner for every entry instead of the owner of
+      the file on disk.  */
+  void SetUIDAndGID(int uid, int gid)
+    {
+    this->Uid = uid;
+    this->Gid = gid;
+    }
+  void SetUNAMEAndGNAME(std::string const& uname, std::string const& gname)
+    {
+    this->Uname = uname;
+    this->Gname = gname;
+    }
+
+  /**
+   * Compute the checksum of the content of each regular file while it
+   * is added to the archive, using an algorithm cmCryptoHash::New
+   * knows.  Returns false if the algorithm is not known.
+   */
+  bool SetChecksumAlgorithm(const char* algo);
+
+  /** Name in the archive and checksum of each regular file added.  */
+  typedef std::vector<std::pair<std::string, std::string> > ChecksumList;
+  ChecksumList const& GetChecksums() const { return this->Checksums; }
+
 private:
   bool Okay() const { return this->Error.empty(); }
   bool AddPath(const char* path, size_t skip, const char* prefix);
   bool AddFile(const char* file, size_t skip, const char* prefix);
-  bool AddData(const char* file, size_t size);
+  bool AddData(const char* file, size_t size, cmCryptoHash* hash);
 
   struct Callback;
   friend struct Callback;
 
   class Entry;
+  class BlockCompressor;
 
   std::ostream& Stream;
   struct archive* Archive;
   struct archive* Disk;
+  BlockCompressor* Blocks;
+  bool Closed;
   bool Verbose;
   std::string Error;
+  int Uid;
+  int Gid;
+  std::string Uname;
+  std::string Gname;
+  cmCryptoHash* Checksum;
+  ChecksumList Checksums;
 };
 
 #endif
@@ -294,6 +294,7 @@ cmCTest::cmCTest()
 {
   this->LabelSummary           = true;
   this->ParallelLevel          = 1;
+  this->ParallelLevelSet       = false;
   this->ParallelLevelSetInCli  = false;
   this->SubmitIndex            = 0;
   this->Failover               = false;
@@ -396,6 +397,7 @@ cmCTest::~cmCTest()
 void cmCTest::SetParallelLevel(int level)
 {
   this->ParallelLevel = level < 1 ? 1 : level;
+  this->ParallelLevelSet = true;
 }
 
 //----------------------------------------------------------------------------
@@ -2187,6 +2189,35 @@ void cmCTest::HandleCommandLineArguments(size_t &i,
     this->GetHandler("memcheck")->
       SetPersistentOption("ExcludeRegularExpression", args[i].c_str());
     }
+
+  if(this->CheckArgument(arg, "--resource-spec-file") &&
+     i < args.size() - 1)
+    {
+    i++;
+    this->GetHandler("test")->
+      SetPersistentOption("ResourceSpecFile", args[i].c_str());
+    this->GetHandler("memcheck")->
+      SetPersistentOption("ResourceSpecFile", args[i].c_str());
+    }
+
+  if(this->CheckArgument(arg, "--test-output-dir") &&
+     i < args.size() - 1)
+    {
+    i++;
+    this->GetHandler("test")->
+      SetPersistentOption("TestOutputDirectory", args[i].c_str());
+    this->GetHandler("memcheck")->
+      SetPersistentOption("TestOutputDirectory", args[i].c_str());
+    }
+
+  if(this->CheckArgument(arg, "--shard") && i < args.size() - 1)
+    {
+    i++;
+    this->GetHandler("test")->
+      SetPersistentOption("Shard", args[i].c_str());
+    this->GetHandler("memcheck")->
+      SetPersistentOption("Shard", args[i].c_str());
+    }
 }
 
 //----------------------------------------------------------------------
@@ -2373,6 +2404,16 @@ int cmCTest::Run(std::vector<std::string> &args, std::string* output)
         }
       }
 
+    if(this->CheckArgument(arg, "--merge-test-xml") && i < args.size() - 2)
+      {
+      std::string mergeOutput = args[++i];
+      std::vector<cmStdString> inputs =
+        cmSystemTools::SplitString(args[++i].c_str(), ';');
+      cmCTestTestHandler* handler =
+        static_cast<cmCTestTestHandler*>(this->GetHandler("test"));
+      return handler->MergeTestXML(mergeOutput.c_str(), inputs)? 0 : 1;
+      }
+
     // --build-and-test options
     if(this->CheckArgument(arg, "--build-and-test") && i < args.size() - 1)
       {
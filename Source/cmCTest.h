@@ -151,6 +151,8 @@ public:
   // how many test to run at the same time
   int GetParallelLevel() { return this->ParallelLevel; }
   void SetParallelLevel(int);
+  // whether the number of tests to run at the same time was given
+  bool GetParallelLevelSet() { return this->ParallelLevelSet; }
 
   /**
    * Check if CTest file exists
@@ -485,6 +487,7 @@ private:
   int                     MaxTestNameWidth;
 
   int                     ParallelLevel;
+  bool                    ParallelLevelSet;
   bool                    ParallelLevelSetInCli;
 
   int                     CompatibilityMode;
@@ -17,6 +17,10 @@
 #include "cmExportTryCompileFileGenerator.h"
 #include <cmsys/Directory.hxx>
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmCryptoHash.h"
+#endif
+
 #include <assert.h>
 
 int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
@@ -227,6 +231,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
     }
 
   std::string outFileName = this->BinaryDirectory + "/CMakeLists.txt";
+  std::string cacheEntry;
   // which signature are we using? If we are using var srcfile bindir
   if (this->SrcFileSignature)
     {
@@ -439,19 +444,41 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
       }
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
+
+    // Imported targets are exported to the project from this build
+    // tree so their results are not cached.
+    if(targets.empty())
+      {
+      cacheEntry = this->GetResultCacheEntry(outFileName, sources,
+                                             cmakeFlags, testLangs,
+                                             targetName);
+      }
     }
 
   bool erroroc = cmSystemTools::GetErrorOccuredFlag();
   cmSystemTools::ResetErrorOccuredFlag();
   std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(sourceDirectory,
-                                       this->BinaryDirectory.c_str(),
-                                       projectName,
-                                       targetName,
-                                       this->SrcFileSignature,
-                                       &cmakeFlags,
-                                       &output);
+  int res = 0;
+  if(cacheEntry.empty() ||
+     this->Makefile->GetCMakeInstance()->GetDebugTryCompile() ||
+     !this->LoadCachedResult(cacheEntry, targetName, res, output))
+    {
+    // actually do the try compile now that everything is setup
+    res = this->Makefile->TryCompile(sourceDirectory,
+                                     this->BinaryDirectory.c_str(),
+                                     projectName,
+                                     targetName,
+                                     this->SrcFileSignature,
+                                     &cmakeFlags,
+                                     &output);
+    // A failure may be caused by a header or library missing outside
+    // the sources that is installed later, so only successes are kept.
+    if(!cacheEntry.empty() && res == 0 &&
+       !cmSystemTools::GetErrorOccuredFlag())
+      {
+      this->StoreCachedResult(cacheEntry, targetName, output);
+      }
+    }
   if ( erroroc )
     {
     cmSystemTools::SetErrorOccured();
@@ -618,3 +645,217 @@ void cmCoreTryCompile::FindOutputFile(const char* targetName)
   this->FindErrorMessage = emsg.str();
   return;
 }
+
+// Paths of the build tree and the random target name are replaced by
+// placeholders in what is hashed and stored so that entries can be
+// shared by build trees in different places.
+static void cmCoreTryCompileToCacheForm(std::string& str,
+                                        std::string const& binDir,
+                                        std::string const& homeDir,
+                                        const char* targetName)
+{
+  cmSystemTools::ReplaceString(str, binDir.c_str(),
+                               "<TRY_COMPILE_BINARY_DIR>");
+  cmSystemTools::ReplaceString(str, homeDir.c_str(), "<BINARY_DIR>");
+  cmSystemTools::ReplaceString(str, targetName, "<TARGET_NAME>");
+}
+
+static void cmCoreTryCompileFromCacheForm(std::string& str,
+                                          std::string const& binDir,
+                                          std::string const& homeDir,
+                                          const char* targetName)
+{
+  cmSystemTools::ReplaceString(str, "<TRY_COMPILE_BINARY_DIR>",
+                               binDir.c_str());
+  cmSystemTools::ReplaceString(str, "<BINARY_DIR>", homeDir.c_str());
+  cmSystemTools::ReplaceString(str, "<TARGET_NAME>", targetName);
+}
+
+std::string
+cmCoreTryCompile::GetResultCacheEntry(
+  std::string const& projectFile,
+  std::vector<std::string> const& sources,
+  std::vector<std::string> const& cmakeFlags,
+  std::set<std::string> const& langs,
+  const char* targetName)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  const char* cacheDir =
+    this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_CACHE_DIR");
+  cmake* cm = this->Makefile->GetCMakeInstance();
+  if(!cacheDir || !*cacheDir || cm->GetIsInTryCompile())
+    {
+    return "";
+    }
+  std::string homeDir = this->Makefile->GetHomeOutputDirectory();
+  cmCryptoHashMD5 md5;
+
+  // The version of CMake and the generator used.
+  std::string key = "version ";
+  key += cmVersion::GetCMakeVersion();
+  key += "\nroot ";
+  key += this->Makefile->GetSafeDefinition("CMAKE_ROOT");
+  key += "\ngenerator ";
+  key += this->Makefile->GetLocalGenerator()->GetGlobalGenerator()->GetName();
+  key += "\ntoolset ";
+  key += cm->GetGeneratorToolset();
+  key += "\nmake ";
+  key += this->Makefile->GetSafeDefinition("CMAKE_MAKE_PROGRAM");
+  key += "\nconfig ";
+  key += this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+  key += "\n";
+
+  // The project and how it is configured.  Its flags hold the include
+  // directories, link directories and link libraries.
+  std::string project;
+  {
+  std::ifstream fin(projectFile.c_str());
+  std::string line;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    project += line;
+    project += "\n";
+    }
+  }
+  key += "project\n";
+  key += project;
+  for(std::vector<std::string>::const_iterator fi = cmakeFlags.begin();
+      fi != cmakeFlags.end(); ++fi)
+    {
+    key += "flag ";
+    key += *fi;
+    key += "\n";
+    }
+  cmCoreTryCompileToCacheForm(key, this->BinaryDirectory, homeDir,
+                              targetName);
+
+  // The content of the sources.
+  for(std::vector<std::string>::const_iterator si = sources.begin();
+      si != sources.end(); ++si)
+    {
+    key += "source ";
+    key += md5.HashFile(si->c_str());
+    key += "\n";
+    }
+
+  // The platform and compilers as determined for this build tree.
+  // Compilers may be replaced in place so their time stamps are part
+  // of their identity.
+  std::string rootBin = homeDir + cmake::GetCMakeFilesDirectory();
+  rootBin += "/";
+  rootBin += cmVersion::GetCMakeVersion();
+  key += "system ";
+  key += md5.HashFile((rootBin + "/CMakeSystem.cmake").c_str());
+  key += "\n";
+  for(std::set<std::string>::const_iterator li = langs.begin();
+      li != langs.end(); ++li)
+    {
+    std::string compilerFile = rootBin + "/CMake" + *li + "Compiler.cmake";
+    std::string compilerVar = "CMAKE_" + *li + "_COMPILER";
+    const char* compiler = this->Makefile->GetDefinition(compilerVar.c_str());
+    cmOStringStream e;
+    e << "compiler " << *li << " " << md5.HashFile(compilerFile.c_str())
+      << " " << (compiler? compiler : "")
+      << " " << (compiler? cmSystemTools::ModifiedTime(compiler) : 0)
+      << "\n";
+    key += e.str();
+    }
+
+  std::string entry = cacheDir;
+  entry += "/";
+  entry += md5.HashString(key.c_str());
+  return entry;
+#else
+  (void)projectFile;
+  (void)sources;
+  (void)cmakeFlags;
+  (void)langs;
+  (void)targetName;
+  return "";
+#endif
+}
+
+bool cmCoreTryCompile::LoadCachedResult(std::string const& entry,
+                                        const char* targetName,
+                                        int& res, std::string& output)
+{
+  // The first line holds the result and the rest the output.
+  std::ifstream fin((entry + ".txt").c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if(!fin || !cmSystemTools::GetLineFromStream(fin, line) ||
+     atoi(line.c_str()) != 0)
+    {
+    return false;
+    }
+  cmOStringStream content;
+  content << fin.rdbuf();
+
+  // The try_compile leaves the executable it built.
+  std::string exe = entry + ".bin";
+  if(cmSystemTools::FileExists(exe.c_str()))
+    {
+    std::string dest = this->BinaryDirectory + "/" + targetName;
+    dest += this->Makefile->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
+    if(!cmSystemTools::CopyFileAlways(exe.c_str(), dest.c_str()))
+      {
+      return false;
+      }
+    }
+
+  res = 0;
+  output = content.str();
+  cmCoreTryCompileFromCacheForm(output, this->BinaryDirectory,
+                                this->Makefile->GetHomeOutputDirectory(),
+                                targetName);
+  return true;
+}
+
+void cmCoreTryCompile::StoreCachedResult(std::string const& entry,
+                                         const char* targetName,
+                                         std::string const& output)
+{
+  // Other build trees may use the cache at the same time, so write
+  // temporary files and move them in place.  The result goes last
+  // because it marks the entry as complete.
+  std::string dir = cmSystemTools::GetFilenamePath(entry);
+  if(!cmSystemTools::MakeDirectory(dir.c_str()))
+    {
+    return;
+    }
+  char tmpSuffix[64];
+  sprintf(tmpSuffix, ".tmp%u", cmSystemTools::RandomSeed());
+  this->FindOutputFile(targetName);
+  if(!this->OutputFile.empty())
+    {
+    std::string exe = entry + ".bin";
+    std::string tmp = exe + tmpSuffix;
+    if(!cmSystemTools::CopyFileAlways(this->OutputFile.c_str(),
+                                      tmp.c_str()) ||
+       !cmSystemTools::RenameFile(tmp.c_str(), exe.c_str()))
+      {
+      cmSystemTools::RemoveFile(tmp.c_str());
+      return;
+      }
+    }
+
+  std::string content = output;
+  cmCoreTryCompileToCacheForm(content, this->BinaryDirectory,
+                              this->Makefile->GetHomeOutputDirectory(),
+                              targetName);
+  std::string txt = entry + ".txt";
+  std::string tmp = txt + tmpSuffix;
+  {
+  std::ofstream fout(tmp.c_str(), std::ios::out | std::ios::binary);
+  fout << "0\n" << content;
+  if(!fout)
+    {
+    fout.close();
+    cmSystemTools::RemoveFile(tmp.c_str());
+    return;
+    }
+  }
+  if(!cmSystemTools::RenameFile(tmp.c_str(), txt.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmp.c_str());
+    }
+}
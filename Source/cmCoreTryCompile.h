@@ -46,6 +46,31 @@ public:
    */
   void FindOutputFile(const char* targetName);
 
+  /**
+   * Return the path of the entry in the try_compile result cache named
+   * by CMAKE_TRY_COMPILE_CACHE_DIR for the project written to
+   * projectFile, or an empty string if results are not cached.  The
+   * entry name hashes everything the result depends on that does not
+   * change with the location of the build tree.
+   */
+  std::string GetResultCacheEntry(std::string const& projectFile,
+                                  std::vector<std::string> const& sources,
+                                  std::vector<std::string> const& cmakeFlags,
+                                  std::set<std::string> const& langs,
+                                  const char* targetName);
+
+  /**
+   * Load the result and output of a try_compile from a cache entry and
+   * put its executable where FindOutputFile looks for it.  Return false
+   * if the entry does not exist or does not hold a success.
+   */
+  bool LoadCachedResult(std::string const& entry, const char* targetName,
+                        int& res, std::string& output);
+
+  /** Store the output of a successful try_compile in a cache entry.  */
+  void StoreCachedResult(std::string const& entry, const char* targetName,
+                         std::string const& output);
+
 
   cmTypeMacro(cmCoreTryCompile, cmCommand);
 
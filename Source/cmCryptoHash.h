@@ -23,7 +23,9 @@ public:
   static cmsys::auto_ptr<cmCryptoHash> New(const char* algo);
   std::string HashString(const char* input);
   std::string HashFile(const char* file);
-protected:
+
+  /** Hash data given in pieces: Initialize, Append each piece, and
+      Finalize to get the hex digest.  */
   virtual void Initialize()=0;
   virtual void Append(unsigned char const*, int)=0;
   virtual std::string Finalize()=0;
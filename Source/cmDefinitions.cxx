@@ -28,18 +28,16 @@ void cmDefinitions::Reset(cmDefinitions* parent)
 
 //----------------------------------------------------------------------------
 cmDefinitions::Def const&
-cmDefinitions::GetInternal(const char* key)
+cmDefinitions::GetInternal(const char* key) const
 {
-  MapType::const_iterator i = this->Map.find(key);
-  if(i != this->Map.end())
+  cmStdString k = key;
+  for(cmDefinitions const* defs = this; defs; defs = defs->Up)
     {
-    return i->second;
-    }
-  else if(cmDefinitions* up = this->Up)
-    {
-    // Query the parent scope and store the result locally.
-    Def def = up->GetInternal(key);
-    return this->Map.insert(MapType::value_type(key, def)).first->second;
+    MapType::const_iterator i = defs->Map.find(k);
+    if(i != defs->Map.end())
+      {
+      return i->second;
+      }
     }
   return this->NoDef;
 }
@@ -71,7 +69,7 @@ cmDefinitions::SetInternal(const char* key, Def const& def)
 }
 
 //----------------------------------------------------------------------------
-const char* cmDefinitions::Get(const char* key)
+const char* cmDefinitions::Get(const char* key) const
 {
   Def const& def = this->GetInternal(key);
   return def.Exists? def.c_str() : 0;
@@ -84,6 +82,16 @@ const char* cmDefinitions::Set(const char* key, const char* value)
   return def.Exists? def.c_str() : 0;
 }
 
+//----------------------------------------------------------------------------
+void cmDefinitions::Localize(const char* key)
+{
+  if(this->Up && this->Map.find(key) == this->Map.end())
+    {
+    Def def = this->Up->GetInternal(key);
+    this->Map.insert(MapType::value_type(key, def));
+    }
+}
+
 //----------------------------------------------------------------------------
 std::set<cmStdString> cmDefinitions::LocalKeys() const
 {
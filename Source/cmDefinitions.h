@@ -13,13 +13,17 @@
 #define cmDefinitions_h
 
 #include "cmStandardIncludes.h"
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include <cmsys/hash_map.hxx>
+#endif
 
 /** \class cmDefinitions
  * \brief Store a scope of variable definitions for CMake language.
  *
  * This stores the state of variable definitions (set or unset) for
  * one scope.  Sets are always local.  Gets search parent scopes
- * transitively and save results locally.
+ * transitively without modifying any scope, so a lookup costs one
+ * hash probe per scope and never copies values.
  */
 class cmDefinitions
 {
@@ -33,13 +37,17 @@ public:
   /** Returns the parent scope, if any.  */
   cmDefinitions* GetParent() const { return this->Up; }
 
-  /** Get the value associated with a key; null if none.
-      Store the result locally if it came from a parent.  */
-  const char* Get(const char* key);
+  /** Get the value associated with a key; null if none.  */
+  const char* Get(const char* key) const;
 
   /** Set (or unset if null) a value associated with a key.  */
   const char* Set(const char* key, const char* value);
 
+  /** Copy the value of a key visible from parent scopes into this
+      scope, unless it is already set or unset locally.  This isolates
+      the local view of the key from later changes to a parent.  */
+  void Localize(const char* key);
+
   /** Get the set of all local keys.  */
   std::set<cmStdString> LocalKeys() const;
 
@@ -65,11 +73,16 @@ private:
   cmDefinitions* Up;
 
   // Local definitions, set or unset.
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  typedef cmsys::hash_map<cmStdString, Def,
+                          cmsys::hash<std::string> > MapType;
+#else
   typedef std::map<cmStdString, Def> MapType;
+#endif
   MapType Map;
 
   // Internal query and update methods.
-  Def const& GetInternal(const char* key);
+  Def const& GetInternal(const char* key) const;
   Def const& SetInternal(const char* key, Def const& def);
 
   // Implementation of Closure() method.
@@ -65,6 +65,7 @@ bool cmDepends::Write(std::ostream &makeDepends,
                                         cmLocalGenerator::MAKEFILE);
     dependencies[obj].insert(src);
     }
+  this->PrepareDependencies(dependencies);
   for(std::map<std::string, std::set<std::string> >::const_iterator
       it = dependencies.begin(); it != dependencies.end(); ++it)
     {
@@ -80,6 +81,12 @@ bool cmDepends::Write(std::ostream &makeDepends,
   return this->Finalize(makeDepends, internalDepends);
 }
 
+//----------------------------------------------------------------------------
+void cmDepends::PrepareDependencies(
+  std::map<std::string, std::set<std::string> > const&)
+{
+}
+
 //----------------------------------------------------------------------------
 bool cmDepends::Finalize(std::ostream&,
                          std::ostream&)
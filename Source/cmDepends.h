@@ -81,6 +81,12 @@ protected:
                                  std::ostream& makeDepends,
                                  std::ostream& internalDepends);
 
+  // Called by Write with the sources of all object files before their
+  // dependencies are written one by one.  Subclasses may use it to do
+  // the work for all object files at once.
+  virtual void PrepareDependencies(
+    std::map<std::string, std::set<std::string> > const& objects);
+
   // Check dependencies for the target file in the given stream.
   // Return false if dependencies must be regenerated and true
   // otherwise.
@@ -15,8 +15,14 @@
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmCryptoHash.h"
+# include "cmDirectoryLock.h"
+#endif
 
 #include <ctype.h> // isspace
+#include <string.h> // memchr
+#include <time.h>
 
 
 #define INCLUDE_REGEX_LINE \
@@ -26,10 +32,12 @@
 #define INCLUDE_REGEX_SCAN_MARKER "#IncludeRegexScan: "
 #define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
 #define INCLUDE_REGEX_TRANSFORM_MARKER "#IncludeRegexTransform: "
+#define INCLUDE_SCAN_DATABASE_MARKER "#IncludeScanDatabase: 2"
 
 //----------------------------------------------------------------------------
 cmDependsC::cmDependsC()
 : ValidDeps(0)
+, CacheChanged(false)
 {
 }
 
@@ -40,6 +48,7 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
                    const std::map<std::string, DependencyVector>* validDeps)
 : cmDepends(lg, targetDir)
 , ValidDeps(validDeps)
+, CacheChanged(false)
 {
   cmMakefile* mf = lg->GetMakefile();
 
@@ -77,24 +86,62 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
 
   this->SetupTransforms();
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Share one scan database among all targets in the build tree that
+  // scan with the same rules, so each header is scanned once per
+  // change rather than once per target including it.
+  std::string rules = this->IncludeRegexLineString;
+  rules += "\n";
+  rules += this->IncludeRegexScanString;
+  rules += "\n";
+  rules += this->IncludeRegexComplainString;
+  rules += "\n";
+  rules += this->IncludeRegexTransformString;
+  cmCryptoHashMD5 md5;
+  this->CacheFileName = mf->GetHomeOutputDirectory();
+  this->CacheFileName += cmake::GetCMakeFilesDirectory();
+  this->CacheFileName += "/CMakeIncludeScan-";
+  this->CacheFileName += md5.HashString(rules.c_str());
+  this->CacheFileName += ".db";
+#else
   this->CacheFileName = this->TargetDirectory;
   this->CacheFileName += "/";
   this->CacheFileName += lang;
   this->CacheFileName += ".includecache";
+#endif
 
-  this->ReadCacheFile();
+  this->ReadCacheFile(this->FileCache);
 }
 
 //----------------------------------------------------------------------------
 cmDependsC::~cmDependsC()
 {
   this->WriteCacheFile();
+  ClearCache(this->FileCache);
+}
 
-  for (std::map<cmStdString, cmIncludeLines*>::iterator it=
-         this->FileCache.begin(); it!=this->FileCache.end(); ++it)
+//----------------------------------------------------------------------------
+void cmDependsC::ClearCache(FileCacheType& cache)
+{
+  for (FileCacheType::iterator it=cache.begin(); it!=cache.end(); ++it)
     {
     delete it->second;
     }
+  cache.clear();
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::CacheEntryIsCurrent(const cmStdString& fullName,
+                                     cmIncludeLines const& entry) const
+{
+  // Entries scanned or checked by this instance are current.
+  if (entry.Used)
+    {
+    return true;
+    }
+  return (entry.ModifiedTime != 0 &&
+          entry.ModifiedTime == cmSystemTools::ModifiedTime(fullName.c_str())
+          && entry.Size == cmSystemTools::FileLength(fullName.c_str()));
 }
 
 //----------------------------------------------------------------------------
@@ -135,169 +182,285 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
 
   if (!haveDeps)
     {
-    // Walk the dependency graph starting with the source file.
-    int srcFiles = (int)sources.size();
-    this->Encountered.clear();
-
-    for(std::set<std::string>::const_iterator srcIt = sources.begin();
-        srcIt != sources.end(); ++srcIt)
+    bool okay;
+    std::string missing;
+    std::map<std::string, PreparedEntry>::iterator pi =
+      this->Prepared.find(obj);
+    if (pi != this->Prepared.end())
+      {
+      // The walk was done by PrepareDependencies.
+      okay = pi->second.Okay;
+      dependencies.swap(pi->second.Dependencies);
+      missing = pi->second.Missing;
+      this->Prepared.erase(pi);
+      }
+    else
+      {
+      WalkState state(*this);
+      okay = this->ScanSources(sources, state, dependencies, missing);
+      }
+    if (!okay)
       {
-      UnscannedEntry root;
-      root.FileName = *srcIt;
-      this->Unscanned.push(root);
-      this->Encountered.insert(*srcIt);
+      cmSystemTools::Error("Cannot find file \"", missing.c_str(), "\".");
+      return false;
       }
+    }
 
-    std::set<cmStdString> scanned;
+  // Write the dependencies to the output stream.  Makefile rules
+  // written by the original local generator for this directory
+  // convert the dependencies to paths relative to the home output
+  // directory.  We must do the same here.
+  internalDepends << obj << std::endl;
+  for(std::set<cmStdString>::const_iterator i=dependencies.begin();
+      i != dependencies.end(); ++i)
+    {
+    makeDepends << obj << ": " <<
+      this->LocalGenerator->Convert(i->c_str(),
+                                    cmLocalGenerator::HOME_OUTPUT,
+                                    cmLocalGenerator::MAKEFILE)
+                << std::endl;
+    internalDepends << " " << i->c_str() << std::endl;
+    }
+  makeDepends << std::endl;
+
+  return true;
+}
 
-    // Use reserve to allocate enough memory for tempPathStr
-    // so that during the loops no memory is allocated or freed
-    std::string tempPathStr;
-    tempPathStr.reserve(4*1024);
+//----------------------------------------------------------------------------
+// Walk the include graph of one object file on a worker thread.
+class cmDependsCWalkJob: public cmWorkerPool::Job
+{
+public:
+  cmDependsCWalkJob(cmDependsC* depends,
+                    std::set<std::string> const& sources,
+                    cmDependsC::PreparedEntry& result):
+    Depends(depends), Sources(sources), Result(result) {}
+  virtual void Run()
+    {
+    cmDependsC::WalkState state(*this->Depends);
+    this->Result.Okay =
+      this->Depends->ScanSources(this->Sources, state,
+                                 this->Result.Dependencies,
+                                 this->Result.Missing);
+    }
+private:
+  cmDependsC* Depends;
+  std::set<std::string> const& Sources;
+  cmDependsC::PreparedEntry& Result;
+};
+
+//----------------------------------------------------------------------------
+void cmDependsC::PrepareDependencies(
+  std::map<std::string, std::set<std::string> > const& objects)
+{
+  // Include transformations share one regular expression, so walk
+  // serially when there are any.
+  unsigned int threads = 1;
+  if(this->TransformRules.empty())
+    {
+    threads = cmWorkerPool::GetDefaultThreadCount();
+    }
+  if(threads < 2)
+    {
+    return;
+    }
 
-    while(!this->Unscanned.empty())
+  // Walk the include graphs of all object files whose dependencies
+  // are not known to be valid.  WriteDependencies then writes the
+  // results in the usual order, so the output does not depend on the
+  // order in which the walks finish.
+  std::vector<cmWorkerPool::Job*> jobs;
+  for(std::map<std::string, std::set<std::string> >::const_iterator
+        it = objects.begin(); it != objects.end(); ++it)
+    {
+    if(it->second.empty() || it->second.begin()->empty() ||
+       (this->ValidDeps != 0 &&
+        this->ValidDeps->find(it->first) != this->ValidDeps->end()))
       {
-      // Get the next file to scan.
-      UnscannedEntry current = this->Unscanned.front();
-      this->Unscanned.pop();
+      continue;
+      }
+    PreparedEntry& result = this->Prepared[it->first];
+    jobs.push_back(new cmDependsCWalkJob(this, it->second, result));
+    }
+  cmWorkerPool::RunJobs(jobs, threads);
+  for(std::vector<cmWorkerPool::Job*>::iterator ji = jobs.begin();
+      ji != jobs.end(); ++ji)
+    {
+    delete *ji;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::ScanSources(const std::set<std::string>& sources,
+                             WalkState& state,
+                             std::set<cmStdString>& dependencies,
+                             std::string& missing)
+{
+  // Walk the dependency graph starting with the source file.
+  int srcFiles = (int)sources.size();
+
+  for(std::set<std::string>::const_iterator srcIt = sources.begin();
+      srcIt != sources.end(); ++srcIt)
+    {
+    UnscannedEntry root;
+    root.FileName = *srcIt;
+    state.Unscanned.push(root);
+    state.Encountered.insert(*srcIt);
+    }
+
+  std::set<cmStdString> scanned;
 
-      // If not a full path, find the file in the include path.
-      std::string fullName;
-      if((srcFiles>0)
-         || cmSystemTools::FileIsFullPath(current.FileName.c_str()))
+  // Use reserve to allocate enough memory for tempPathStr
+  // so that during the loops no memory is allocated or freed
+  std::string tempPathStr;
+  tempPathStr.reserve(4*1024);
+
+  while(!state.Unscanned.empty())
+    {
+    // Get the next file to scan.
+    UnscannedEntry current = state.Unscanned.front();
+    state.Unscanned.pop();
+
+    // If not a full path, find the file in the include path.
+    std::string fullName;
+    if((srcFiles>0)
+       || cmSystemTools::FileIsFullPath(current.FileName.c_str()))
+      {
+      if(cmSystemTools::FileExists(current.FileName.c_str(), true))
         {
-        if(cmSystemTools::FileExists(current.FileName.c_str(), true))
-          {
-          fullName = current.FileName;
-          }
+        fullName = current.FileName;
         }
-      else if(!current.QuotedLocation.empty() &&
-              cmSystemTools::FileExists(current.QuotedLocation.c_str(), true))
+      }
+    else if(!current.QuotedLocation.empty() &&
+            cmSystemTools::FileExists(current.QuotedLocation.c_str(), true))
+      {
+      // The include statement producing this entry was a double-quote
+      // include and the included file is present in the directory of
+      // the source containing the include statement.
+      fullName = current.QuotedLocation;
+      }
+    else
+      {
+      bool cached = false;
+      {
+      cmWorkerPool::Lock lock(this->CacheMutex);
+      std::map<cmStdString, cmStdString>::iterator
+        headerLocationIt=this->HeaderLocationCache.find(current.FileName);
+      if (headerLocationIt!=this->HeaderLocationCache.end())
         {
-        // The include statement producing this entry was a double-quote
-        // include and the included file is present in the directory of
-        // the source containing the include statement.
-        fullName = current.QuotedLocation;
+        fullName=headerLocationIt->second;
+        cached = true;
         }
-      else
+      }
+      if (!cached) for(std::vector<std::string>::const_iterator i =
+            this->IncludePath.begin(); i != this->IncludePath.end(); ++i)
         {
-        std::map<cmStdString, cmStdString>::iterator
-          headerLocationIt=this->HeaderLocationCache.find(current.FileName);
-        if (headerLocationIt!=this->HeaderLocationCache.end())
-          {
-          fullName=headerLocationIt->second;
-          }
-        else for(std::vector<std::string>::const_iterator i =
-              this->IncludePath.begin(); i != this->IncludePath.end(); ++i)
-          {
-          // Construct the name of the file as if it were in the current
-          // include directory.  Avoid using a leading "./".
+        // Construct the name of the file as if it were in the current
+        // include directory.  Avoid using a leading "./".
 
-          tempPathStr =
-            cmSystemTools::CollapseCombinedPath(*i, current.FileName);
+        tempPathStr =
+          cmSystemTools::CollapseCombinedPath(*i, current.FileName);
 
-          // Look for the file in this location.
-          if(cmSystemTools::FileExists(tempPathStr.c_str(), true))
-            {
-            fullName = tempPathStr;
-            HeaderLocationCache[current.FileName]=fullName;
-            break;
-            }
+        // Look for the file in this location.
+        if(cmSystemTools::FileExists(tempPathStr.c_str(), true))
+          {
+          fullName = tempPathStr;
+          cmWorkerPool::Lock lock(this->CacheMutex);
+          this->HeaderLocationCache[current.FileName]=fullName;
+          break;
           }
         }
+      }
+
+    // Complain if the file cannot be found and matches the complain
+    // regex.
+    if(fullName.empty() &&
+      state.IncludeRegexComplain.find(current.FileName.c_str()))
+      {
+      missing = current.FileName;
+      return false;
+      }
 
-      // Complain if the file cannot be found and matches the complain
-      // regex.
-      if(fullName.empty() &&
-        this->IncludeRegexComplain.find(current.FileName.c_str()))
+    // Scan the file if it was found and has not been scanned already.
+    if(!fullName.empty() && (scanned.find(fullName) == scanned.end()))
+      {
+      // Record scanned files.
+      scanned.insert(fullName);
+
+      // Check whether this file is already in the cache
+      bool cached = false;
+      {
+      cmWorkerPool::Lock lock(this->CacheMutex);
+      FileCacheType::iterator fileIt=this->FileCache.find(fullName);
+      if (fileIt!=this->FileCache.end() &&
+          !this->CacheEntryIsCurrent(fullName, *fileIt->second))
         {
-        cmSystemTools::Error("Cannot find file \"",
-                            current.FileName.c_str(), "\".");
-        return false;
+        // The file changed since it was scanned.
+        delete fileIt->second;
+        this->FileCache.erase(fileIt);
+        fileIt=this->FileCache.end();
         }
-
-      // Scan the file if it was found and has not been scanned already.
-      if(!fullName.empty() && (scanned.find(fullName) == scanned.end()))
+      if (fileIt!=this->FileCache.end())
         {
-        // Record scanned files.
-        scanned.insert(fullName);
-
-        // Check whether this file is already in the cache
-        std::map<cmStdString, cmIncludeLines*>::iterator fileIt=
-          this->FileCache.find(fullName);
-        if (fileIt!=this->FileCache.end())
+        cached = true;
+        fileIt->second->Used=true;
+        dependencies.insert(fullName);
+        for (std::vector<UnscannedEntry>::const_iterator incIt=
+              fileIt->second->UnscannedEntries.begin();
+            incIt!=fileIt->second->UnscannedEntries.end(); ++incIt)
           {
-          fileIt->second->Used=true;
-          dependencies.insert(fullName);
-          for (std::vector<UnscannedEntry>::const_iterator incIt=
-                fileIt->second->UnscannedEntries.begin();
-              incIt!=fileIt->second->UnscannedEntries.end(); ++incIt)
+          if (state.Encountered.find(incIt->FileName) ==
+              state.Encountered.end())
             {
-            if (this->Encountered.find(incIt->FileName) ==
-                this->Encountered.end())
-              {
-              this->Encountered.insert(incIt->FileName);
-              this->Unscanned.push(*incIt);
-              }
+            state.Encountered.insert(incIt->FileName);
+            state.Unscanned.push(*incIt);
             }
           }
-        else
+        }
+      }
+      if (!cached)
+        {
+        // Try to scan the file.  Just leave it out if we cannot find
+        // it.
+        std::ifstream fin(fullName.c_str());
+        if(fin)
           {
+          // Add this file as a dependency.
+          dependencies.insert(fullName);
 
-          // Try to scan the file.  Just leave it out if we cannot find
-          // it.
-          std::ifstream fin(fullName.c_str());
-          if(fin)
-            {
-            // Add this file as a dependency.
-            dependencies.insert(fullName);
-
-            // Scan this file for new dependencies.  Pass the directory
-            // containing the file to handle double-quote includes.
-            std::string dir = cmSystemTools::GetFilenamePath(fullName);
-            this->Scan(fin, dir.c_str(), fullName);
-            }
+          // Scan this file for new dependencies.  Pass the directory
+          // containing the file to handle double-quote includes.
+          std::string dir = cmSystemTools::GetFilenamePath(fullName);
+          this->Scan(fin, dir.c_str(), fullName, state);
           }
         }
-
-      srcFiles--;
       }
-    }
 
-  // Write the dependencies to the output stream.  Makefile rules
-  // written by the original local generator for this directory
-  // convert the dependencies to paths relative to the home output
-  // directory.  We must do the same here.
-  internalDepends << obj << std::endl;
-  for(std::set<cmStdString>::const_iterator i=dependencies.begin();
-      i != dependencies.end(); ++i)
-    {
-    makeDepends << obj << ": " <<
-      this->LocalGenerator->Convert(i->c_str(),
-                                    cmLocalGenerator::HOME_OUTPUT,
-                                    cmLocalGenerator::MAKEFILE)
-                << std::endl;
-    internalDepends << " " << i->c_str() << std::endl;
+    srcFiles--;
     }
-  makeDepends << std::endl;
-
   return true;
 }
 
 //----------------------------------------------------------------------------
-void cmDependsC::ReadCacheFile()
+bool cmDependsC::ReadCacheFile(FileCacheType& cache) const
 {
   if(this->CacheFileName.size() == 0)
     {
-    return;
+    return false;
     }
   std::ifstream fin(this->CacheFileName.c_str());
   if(!fin)
     {
-    return;
+    return false;
     }
 
   std::string line;
+  if(!cmSystemTools::GetLineFromStream(fin, line) ||
+     line != INCLUDE_SCAN_DATABASE_MARKER)
+    {
+    return false;
+    }
+
   cmIncludeLines* cacheEntry=0;
   bool haveFileName=false;
 
@@ -313,47 +476,60 @@ void cmDependsC::ReadCacheFile()
     if (haveFileName==false)
       {
       haveFileName=true;
-      int newer=0;
-      cmFileTimeComparison comp;
-      bool res=comp.FileTimeCompare(this->CacheFileName.c_str(),
-                                    line.c_str(), &newer);
-
-      if ((res==true) && (newer==1)) //cache is newer than the parsed file
+      if (line[0] != '#')
         {
+        // The next line has the modification time and size of the
+        // file when it was scanned.  They are checked when the entry
+        // is first used.
+        std::string stamp;
+        long mtime = 0;
+        unsigned long size = 0;
+        if (!cmSystemTools::GetLineFromStream(fin, stamp) ||
+            sscanf(stamp.c_str(), "%ld %lu", &mtime, &size) != 2)
+          {
+          return false;
+          }
         cacheEntry=new cmIncludeLines;
-        this->FileCache[line]=cacheEntry;
+        cacheEntry->ModifiedTime=mtime;
+        cacheEntry->Size=size;
+        FileCacheType::iterator i = cache.find(line);
+        if (i != cache.end())
+          {
+          delete i->second;
+          i->second = cacheEntry;
+          }
+        else
+          {
+          cache[line]=cacheEntry;
+          }
         }
-      // file doesn't exist, check that the regular expressions
-      // haven't changed
-      else if (res==false)
+      // check that the regular expressions haven't changed
+      else if (line.find(INCLUDE_REGEX_LINE_MARKER) == 0)
         {
-        if (line.find(INCLUDE_REGEX_LINE_MARKER) == 0)
+        if (line != this->IncludeRegexLineString)
           {
-          if (line != this->IncludeRegexLineString)
-            {
-            return;
-            }
+          return false;
           }
-        else if (line.find(INCLUDE_REGEX_SCAN_MARKER) == 0)
+        }
+      else if (line.find(INCLUDE_REGEX_SCAN_MARKER) == 0)
+        {
+        if (line != this->IncludeRegexScanString)
           {
-          if (line != this->IncludeRegexScanString)
-            {
-            return;
-            }
+          return false;
           }
-        else if (line.find(INCLUDE_REGEX_COMPLAIN_MARKER) == 0)
+        }
+      else if (line.find(INCLUDE_REGEX_COMPLAIN_MARKER) == 0)
+        {
+        if (line != this->IncludeRegexComplainString)
           {
-          if (line != this->IncludeRegexComplainString)
-            {
-            return;
-            }
+          return false;
           }
-        else if (line.find(INCLUDE_REGEX_TRANSFORM_MARKER) == 0)
+        }
+      else if (line.find(INCLUDE_REGEX_TRANSFORM_MARKER) == 0)
+        {
+        if (line != this->IncludeRegexTransformString)
           {
-          if (line != this->IncludeRegexTransformString)
-            {
-            return;
-            }
+          return false;
           }
         }
       }
@@ -371,33 +547,79 @@ void cmDependsC::ReadCacheFile()
         }
       }
     }
+  return true;
 }
 
 //----------------------------------------------------------------------------
 void cmDependsC::WriteCacheFile() const
 {
-  if(this->CacheFileName.size() == 0)
+  if(this->CacheFileName.size() == 0 || !this->CacheChanged)
     {
     return;
     }
-  std::ofstream cacheOut(this->CacheFileName.c_str());
-  if(!cacheOut)
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // The database is shared by all targets scanned with the same rules
+  // and make may scan several of them at once.  Merge and replace it
+  // while holding a lock so that no process drops the entries another
+  // one added meanwhile.  If the lock cannot be created the database is
+  // still written.
+  cmDirectoryLock lock(this->CacheFileName + ".lock");
+  lock.Acquire();
+#endif
+
+  // Other processes may have updated the database since we read it.
+  // Start from its current content and add the entries we scanned or
+  // checked.  Entries we read but never used are taken from disk.
+  FileCacheType onDisk;
+  if(!this->ReadCacheFile(onDisk))
     {
-    return;
+    ClearCache(onDisk);
     }
-
-  cacheOut << this->IncludeRegexLineString << "\n\n";
-  cacheOut << this->IncludeRegexScanString << "\n\n";
-  cacheOut << this->IncludeRegexComplainString << "\n\n";
-  cacheOut << this->IncludeRegexTransformString << "\n\n";
-
-  for (std::map<cmStdString, cmIncludeLines*>::const_iterator fileIt=
-         this->FileCache.begin();
+  std::map<cmStdString, cmIncludeLines const*> entries;
+  for (FileCacheType::const_iterator fileIt=onDisk.begin();
+       fileIt!=onDisk.end(); ++fileIt)
+    {
+    entries[fileIt->first] = fileIt->second;
+    }
+  for (FileCacheType::const_iterator fileIt=this->FileCache.begin();
        fileIt!=this->FileCache.end(); ++fileIt)
     {
     if (fileIt->second->Used)
       {
+      if (fileIt->second->ModifiedTime != 0)
+        {
+        entries[fileIt->first] = fileIt->second;
+        }
+      else
+        {
+        entries.erase(fileIt->first);
+        }
+      }
+    }
+
+  // Write a private file and rename it into place so that concurrent
+  // readers never see a partial database.
+  cmOStringStream tmpName;
+  tmpName << this->CacheFileName << ".tmp" << cmSystemTools::RandomSeed();
+  std::string tmp = tmpName.str();
+  bool written = false;
+  {
+  std::ofstream cacheOut(tmp.c_str());
+  if(cacheOut)
+    {
+    cacheOut << INCLUDE_SCAN_DATABASE_MARKER << "\n";
+    cacheOut << this->IncludeRegexLineString << "\n\n";
+    cacheOut << this->IncludeRegexScanString << "\n\n";
+    cacheOut << this->IncludeRegexComplainString << "\n\n";
+    cacheOut << this->IncludeRegexTransformString << "\n\n";
+
+    for (std::map<cmStdString, cmIncludeLines const*>::const_iterator
+           fileIt=entries.begin(); fileIt!=entries.end(); ++fileIt)
+      {
       cacheOut<<fileIt->first.c_str()<<std::endl;
+      cacheOut<<fileIt->second->ModifiedTime<<" "
+              <<fileIt->second->Size<<std::endl;
 
       for (std::vector<UnscannedEntry>::const_iterator
              incIt=fileIt->second->UnscannedEntries.begin();
@@ -415,64 +637,227 @@ void cmDependsC::WriteCacheFile() const
         }
       cacheOut<<std::endl;
       }
-   }
+    written = cacheOut? true : false;
+    }
+  }
+  if(!written ||
+     !cmSystemTools::RenameFile(tmp.c_str(), this->CacheFileName.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmp.c_str());
+    }
+  ClearCache(onDisk);
 }
 
 //----------------------------------------------------------------------------
 void cmDependsC::Scan(std::istream& is, const char* directory,
-  const cmStdString& fullName)
+                      const cmStdString& fullName, WalkState& state)
 {
   cmIncludeLines* newCacheEntry=new cmIncludeLines;
   newCacheEntry->Used=true;
-  this->FileCache[fullName]=newCacheEntry;
 
-  // Read one line at a time.
-  std::string line;
-  while(cmSystemTools::GetLineFromStream(is, line))
+  // Record the file time stamp for checking the entry later.  A file
+  // modified during the current second may still change without a
+  // visible time stamp change, so such an entry is not stored.
+  long mtime = cmSystemTools::ModifiedTime(fullName.c_str());
+  if(mtime < static_cast<long>(time(0)))
+    {
+    newCacheEntry->ModifiedTime = mtime;
+    newCacheEntry->Size = cmSystemTools::FileLength(fullName.c_str());
+    }
+
+  std::vector<IncludeDirective> includes;
+  if(this->TransformRules.empty())
     {
-    // Transform the line content first.
-    if(!this->TransformRules.empty())
+    // Read the whole file and find the directives without splitting
+    // it into lines first.
+    std::string buffer;
+    char buf[16384];
+    while(is)
+      {
+      is.read(buf, sizeof(buf));
+      buffer.append(buf, static_cast<std::string::size_type>(is.gcount()));
+      }
+    const char* data = buffer.c_str();
+    FindIncludes(data, data + buffer.size(), includes);
+    }
+  else
+    {
+    // Transformations are defined on whole lines, so use the line
+    // matching regular expression.
+    std::string line;
+    while(cmSystemTools::GetLineFromStream(is, line))
       {
       this->TransformLine(line);
+      if(this->IncludeRegexLine.find(line.c_str()))
+        {
+        IncludeDirective inc;
+        inc.FileName = this->IncludeRegexLine.match(2);
+        inc.Quoted = this->IncludeRegexLine.match(3) == "\"";
+        includes.push_back(inc);
+        }
       }
+    }
 
-    // Match include directives.
-    if(this->IncludeRegexLine.find(line.c_str()))
+  for(std::vector<IncludeDirective>::const_iterator ii = includes.begin();
+      ii != includes.end(); ++ii)
+    {
+    // Get the file being included.
+    UnscannedEntry entry;
+    entry.FileName = ii->FileName;
+    cmSystemTools::ConvertToUnixSlashes(entry.FileName);
+    if(ii->Quoted &&
+       !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
       {
-      // Get the file being included.
-      UnscannedEntry entry;
-      entry.FileName = this->IncludeRegexLine.match(2);
-      cmSystemTools::ConvertToUnixSlashes(entry.FileName);
-      if(this->IncludeRegexLine.match(3) == "\"" &&
-         !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
+      // This was a double-quoted include with a relative path.  We
+      // must check for the file in the directory containing the
+      // file we are scanning.
+      entry.QuotedLocation =
+        cmSystemTools::CollapseCombinedPath(directory, entry.FileName);
+      }
+
+    // Queue the file if it has not yet been encountered and it
+    // matches the regular expression for recursive scanning.  Note
+    // that this check does not account for the possibility of two
+    // headers with the same name in different directories when one
+    // is included by double-quotes and the other by angle brackets.
+    // It also does not work properly if two header files with the same
+    // name exist in different directories, and both are included from a
+    // file their own directory by simply using "filename.h" (#12619)
+    // This kind of problem will be fixed when a more
+    // preprocessor-like implementation of this scanner is created.
+    if (state.IncludeRegexScan.find(entry.FileName.c_str()))
+      {
+      newCacheEntry->UnscannedEntries.push_back(entry);
+      if(state.Encountered.find(entry.FileName) == state.Encountered.end())
         {
-        // This was a double-quoted include with a relative path.  We
-        // must check for the file in the directory containing the
-        // file we are scanning.
-        entry.QuotedLocation =
-          cmSystemTools::CollapseCombinedPath(directory, entry.FileName);
+        state.Encountered.insert(entry.FileName);
+        state.Unscanned.push(entry);
         }
+      }
+    }
+
+  // Publish the complete entry.  Another walk may have scanned the
+  // same file meanwhile; the results are the same.
+  cmWorkerPool::Lock lock(this->CacheMutex);
+  cmIncludeLines*& cacheEntry = this->FileCache[fullName];
+  delete cacheEntry;
+  cacheEntry = newCacheEntry;
+  this->CacheChanged=true;
+}
 
-      // Queue the file if it has not yet been encountered and it
-      // matches the regular expression for recursive scanning.  Note
-      // that this check does not account for the possibility of two
-      // headers with the same name in different directories when one
-      // is included by double-quotes and the other by angle brackets.
-      // It also does not work properly if two header files with the same
-      // name exist in different directories, and both are included from a
-      // file their own directory by simply using "filename.h" (#12619)
-      // This kind of problem will be fixed when a more
-      // preprocessor-like implementation of this scanner is created.
-      if (this->IncludeRegexScan.find(entry.FileName.c_str()))
+//----------------------------------------------------------------------------
+// Skip blanks, comments and escaped newlines inside a directive.
+static const char* cmDependsCSkipSpace(const char* c, const char* end)
+{
+  while(c < end)
+    {
+    if(*c == ' ' || *c == '\t')
+      {
+      ++c;
+      }
+    else if(*c == '\\' && c+1 < end && c[1] == '\n')
+      {
+      c += 2;
+      }
+    else if(*c == '\\' && c+2 < end && c[1] == '\r' && c[2] == '\n')
+      {
+      c += 3;
+      }
+    else if(*c == '/' && c+1 < end && c[1] == '*')
+      {
+      // A block comment acts as a single blank.
+      const char* e = c + 2;
+      while(e+1 < end && !(e[0] == '*' && e[1] == '/'))
         {
-        newCacheEntry->UnscannedEntries.push_back(entry);
-        if(this->Encountered.find(entry.FileName) == this->Encountered.end())
-          {
-          this->Encountered.insert(entry.FileName);
-          this->Unscanned.push(entry);
-          }
+        ++e;
         }
+      if(e+1 >= end)
+        {
+        return end;
+        }
+      c = e + 2;
+      }
+    else
+      {
+      break;
+      }
+    }
+  return c;
+}
+
+//----------------------------------------------------------------------------
+// Match a keyword at the given position.
+static bool cmDependsCMatchWord(const char* c, const char* end,
+                                const char* word, size_t len)
+{
+  return static_cast<size_t>(end - c) >= len && memcmp(c, word, len) == 0;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::FindIncludes(const char* begin, const char* end,
+                              std::vector<IncludeDirective>& includes)
+{
+  // This accepts every line the INCLUDE_REGEX_LINE expression accepts
+  // and also directives continued over escaped newlines or containing
+  // block comments between tokens.
+  const char* c = begin;
+  while(c < end)
+    {
+    // Jump to the next '#'.
+    const char* hash =
+      static_cast<const char*>(memchr(c, '#', static_cast<size_t>(end - c)));
+    if(!hash)
+      {
+      break;
+      }
+    c = hash + 1;
+
+    // Only blanks may precede the '#' on its line.
+    const char* b = hash;
+    while(b > begin && (b[-1] == ' ' || b[-1] == '\t'))
+      {
+      --b;
+      }
+    if(b > begin && b[-1] != '\n')
+      {
+      continue;
+      }
+
+    // Match the directive name.
+    const char* d = cmDependsCSkipSpace(c, end);
+    if(cmDependsCMatchWord(d, end, "include", 7))
+      {
+      d += 7;
+      }
+    else if(cmDependsCMatchWord(d, end, "import", 6))
+      {
+      d += 6;
+      }
+    else
+      {
+      continue;
+      }
+
+    // Match the file name and its delimiters.
+    d = cmDependsCSkipSpace(d, end);
+    if(d == end || (*d != '<' && *d != '"'))
+      {
+      continue;
+      }
+    const char* name = ++d;
+    while(d < end && *d != '"' && *d != '>' && *d != '\n' && *d != '\0')
+      {
+      ++d;
+      }
+    if(d == end || d == name || (*d != '"' && *d != '>'))
+      {
+      continue;
       }
+    IncludeDirective inc;
+    inc.FileName.assign(name, d);
+    inc.Quoted = *d == '"';
+    includes.push_back(inc);
+    c = d + 1;
     }
 }
 
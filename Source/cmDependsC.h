@@ -13,6 +13,7 @@
 #define cmDependsC_h
 
 #include "cmDepends.h"
+#include "cmWorkerPool.h"
 #include <cmsys/RegularExpression.hxx>
 #include <queue>
 
@@ -31,16 +32,27 @@ public:
   /** Virtual destructor to cleanup subclasses properly.  */
   virtual ~cmDependsC();
 
+  /** An #include or #import directive found in a file.  */
+  struct IncludeDirective
+  {
+    std::string FileName;
+    bool Quoted;
+  };
+
+  /** Find the include directives in a buffer holding a whole file.
+      This is a hand-written equivalent of the line matching regular
+      expression used when include transformations are defined.  */
+  static void FindIncludes(const char* begin, const char* end,
+                           std::vector<IncludeDirective>& includes);
+
 protected:
   // Implement writing/checking methods required by superclass.
   virtual bool WriteDependencies(const std::set<std::string>& sources,
                                  const std::string&           obj,
                                  std::ostream& makeDepends,
                                  std::ostream& internalDepends);
-
-  // Method to scan a single file.
-  void Scan(std::istream& is, const char* directory,
-    const cmStdString& fullName);
+  virtual void PrepareDependencies(
+    std::map<std::string, std::set<std::string> > const& objects);
 
   // Regular expression to identify C preprocessor include directives.
   cmsys::RegularExpression IncludeRegexLine;
@@ -72,22 +84,72 @@ public:
 
   struct cmIncludeLines
   {
-    cmIncludeLines(): Used(false) {}
+    cmIncludeLines(): Used(false), ModifiedTime(0), Size(0) {}
     std::vector<UnscannedEntry> UnscannedEntries;
     bool Used;
+
+    // Modification time and size of the file when it was scanned.
+    // A zero time means the entry must not be stored.
+    long ModifiedTime;
+    unsigned long Size;
   };
+  typedef std::map<cmStdString, cmIncludeLines*> FileCacheType;
 protected:
   const std::map<std::string, DependencyVector>* ValidDeps;
-  std::set<cmStdString> Encountered;
-  std::queue<UnscannedEntry> Unscanned;
 
-  std::map<cmStdString, cmIncludeLines *> FileCache;
+  // State of one dependency graph walk.  The walks for different
+  // object files may run concurrently, so each one matches with its
+  // own copies of the regular expressions.
+  struct WalkState
+  {
+    WalkState(cmDependsC const& self):
+      IncludeRegexScan(self.IncludeRegexScan),
+      IncludeRegexComplain(self.IncludeRegexComplain) {}
+    cmsys::RegularExpression IncludeRegexScan;
+    cmsys::RegularExpression IncludeRegexComplain;
+    std::set<cmStdString> Encountered;
+    std::queue<UnscannedEntry> Unscanned;
+  };
+
+  // Walk the include graph from the given sources and collect the
+  // files found.  Returns false with the name of a missing file that
+  // matches the complain regex.
+  bool ScanSources(const std::set<std::string>& sources, WalkState& state,
+                   std::set<cmStdString>& dependencies,
+                   std::string& missing);
+
+  // Method to scan a single file.
+  void Scan(std::istream& is, const char* directory,
+            const cmStdString& fullName, WalkState& state);
+
+  // Results of walks done ahead of time by PrepareDependencies.
+  struct PreparedEntry
+  {
+    PreparedEntry(): Okay(true) {}
+    bool Okay;
+    std::set<cmStdString> Dependencies;
+    std::string Missing;
+  };
+  std::map<std::string, PreparedEntry> Prepared;
+  friend class cmDependsCWalkJob;
+
+  // The caches are shared by concurrent walks and guarded by this.
+  cmWorkerPool::Mutex CacheMutex;
+  FileCacheType FileCache;
   std::map<cmStdString, cmStdString> HeaderLocationCache;
 
+  // The scan results are stored in a database shared by all targets
+  // in the build tree that use the same scanning rules.  It is read
+  // on construction and updated on destruction if any file had to be
+  // scanned.
   cmStdString CacheFileName;
+  bool CacheChanged;
 
   void WriteCacheFile() const;
-  void ReadCacheFile();
+  bool ReadCacheFile(FileCacheType& cache) const;
+  static void ClearCache(FileCacheType& cache);
+  bool CacheEntryIsCurrent(const cmStdString& fullName,
+                           cmIncludeLines const& entry) const;
 private:
   cmDependsC(cmDependsC const&); // Purposely not implemented.
   void operator=(cmDependsC const&); // Purposely not implemented.
@@ -0,0 +1,508 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmDirectoryFingerprint.h"
+
+#include "cmCryptoHash.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmSourceFile.h"
+#include "cmTarget.h"
+#include "cmVersion.h"
+#include "cmake.h"
+
+//----------------------------------------------------------------------------
+// Order targets by name and then by directory so that the digest does
+// not depend on where targets happen to live in memory.
+struct cmDirectoryFingerprintTargetCompare
+{
+  bool operator()(cmTarget* l, cmTarget* r) const
+    {
+    if(int c = strcmp(l->GetName(), r->GetName()))
+      {
+      return c < 0;
+      }
+    return strcmp(l->GetMakefile()->GetStartOutputDirectory(),
+                  r->GetMakefile()->GetStartOutputDirectory()) < 0;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Find the targets that generator expressions in the text name, such
+// as "b" in $<TARGET_FILE:b> or $<TARGET_PROPERTY:b,prop>.  Returns
+// false if a name is itself computed by an expression.
+static bool cmDirectoryFingerprintNamedTargets(std::string const& text,
+                                               cmMakefile* mf,
+                                               std::vector<cmTarget*>& named)
+{
+  std::string::size_type pos = 0;
+  while((pos = text.find("$<TARGET_", pos)) != std::string::npos)
+    {
+    pos += 2;
+    std::string::size_type colon = text.find_first_of(":>", pos);
+    if(colon == std::string::npos || text[colon] != ':')
+      {
+      continue;
+      }
+    std::string identifier = text.substr(pos, colon - pos);
+    bool property = identifier == "TARGET_PROPERTY";
+    if(!property && identifier.find("FILE") == std::string::npos)
+      {
+      continue;
+      }
+    std::string::size_type end = text.find_first_of(",>$", colon + 1);
+    if(end == std::string::npos)
+      {
+      continue;
+      }
+    if(text[end] == '$')
+      {
+      return false;
+      }
+    if(property && text[end] == '>')
+      {
+      // $<TARGET_PROPERTY:prop> reads the target being generated.
+      continue;
+      }
+    std::string name = text.substr(colon + 1, end - colon - 1);
+    if(cmTarget* target = mf->FindTargetToUse(name.c_str()))
+      {
+      named.push_back(target);
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+cmDirectoryFingerprint::cmDirectoryFingerprint(cmGlobalGenerator* gg):
+  GlobalGenerator(gg)
+{
+  // The CMake doing the generating.
+  std::string data;
+  AddValue(data, "version", cmVersion::GetCMakeVersion());
+  cmMakefile* mf = gg->GetLocalGenerators()[0]->GetMakefile();
+  if(const char* command = mf->PeekDefinition("CMAKE_COMMAND"))
+    {
+    cmOStringStream mtime;
+    mtime << cmSystemTools::ModifiedTime(command);
+    AddValue(data, "command", mtime.str());
+    }
+  AddValue(data, "generator", gg->GetName());
+  AddProperties(data, "global", gg->GetCMakeInstance()->GetProperties());
+  this->GlobalDigest = Digest(data);
+}
+
+//----------------------------------------------------------------------------
+std::string cmDirectoryFingerprint::Compute(cmLocalGenerator* lg)
+{
+  cmMakefile* mf = lg->GetMakefile();
+  std::string data = this->GlobalDigest;
+
+  // This directory and the imported targets it may see.
+  data += this->GetDirectoryDigest(mf);
+  for(cmLocalGenerator* parent = lg->GetParent();
+      parent; parent = parent->GetParent())
+    {
+    std::vector<cmTarget*> const& imported =
+      parent->GetMakefile()->GetOwnedImportedTargets();
+    for(std::vector<cmTarget*>::const_iterator ti = imported.begin();
+        ti != imported.end(); ++ti)
+      {
+      data += this->GetInterfaceDigest(*ti);
+      }
+    }
+
+  // The targets built here, in full.
+  std::set<cmTarget*> local;
+  std::vector<cmTarget*> queue;
+  std::vector<cmTarget*> next;
+  cmTargets& targets = mf->GetTargets();
+  for(cmTargets::iterator ti = targets.begin(); ti != targets.end(); ++ti)
+    {
+    std::string targetData;
+    this->AddTarget(targetData, &ti->second);
+    if(!cmDirectoryFingerprintNamedTargets(targetData, mf, next))
+      {
+      return "";
+      }
+    data += targetData;
+    local.insert(&ti->second);
+    queue.push_back(&ti->second);
+    }
+
+  // Everything they depend on.  Object libraries are not target
+  // dependencies but their objects are listed by their users.  The
+  // targets that generator expressions name are not dependencies
+  // either but their properties and files may be read.
+  std::set<cmTarget*, cmDirectoryFingerprintTargetCompare> depends;
+  for(;;)
+    {
+    for(std::vector<cmTarget*>::iterator ni = next.begin();
+        ni != next.end(); ++ni)
+      {
+      if(local.find(*ni) == local.end() && depends.insert(*ni).second)
+        {
+        queue.push_back(*ni);
+        }
+      }
+    next.clear();
+    if(queue.empty())
+      {
+      break;
+      }
+    cmTarget* target = queue.back();
+    queue.pop_back();
+    cmTargetDependSet const& direct =
+      this->GlobalGenerator->GetTargetDirectDepends(*target);
+    for(cmTargetDependSet::const_iterator di = direct.begin();
+        di != direct.end(); ++di)
+      {
+      next.push_back(*di);
+      }
+    std::vector<std::string> const& objLibs = target->GetObjectLibraries();
+    for(std::vector<std::string>::const_iterator oi = objLibs.begin();
+        oi != objLibs.end(); ++oi)
+      {
+      if(cmTarget* objLib =
+         target->GetMakefile()->FindTargetToUse(oi->c_str()))
+        {
+        next.push_back(objLib);
+        }
+      }
+    this->GetInterfaceDigest(target);
+    if(this->ComputedNames.find(target) != this->ComputedNames.end())
+      {
+      return "";
+      }
+    std::vector<cmTarget*> const& named = this->NamedTargets[target];
+    next.insert(next.end(), named.begin(), named.end());
+    }
+  for(std::set<cmTarget*, cmDirectoryFingerprintTargetCompare>::iterator
+        ti = depends.begin(); ti != depends.end(); ++ti)
+    {
+    data += this->GetInterfaceDigest(*ti);
+    data += this->GetDirectoryDigest((*ti)->GetMakefile());
+    this->AddLinkedImportedTargets(data, *ti);
+    }
+
+  return Digest(data);
+}
+
+//----------------------------------------------------------------------------
+std::string const& cmDirectoryFingerprint::GetDirectoryDigest(cmMakefile* mf)
+{
+  std::map<cmMakefile*, std::string>::iterator i =
+    this->DirectoryDigests.find(mf);
+  if(i != this->DirectoryDigests.end())
+    {
+    return i->second;
+    }
+
+  std::string data;
+  AddValue(data, "directory", mf->GetStartOutputDirectory());
+  AddValue(data, "source", mf->GetStartDirectory());
+
+  // Variables and cache entries.  Their values are read without
+  // notifying variable watches, which must not see generate-time
+  // reads they did not ask for.
+  std::vector<std::string> vars = mf->GetDefinitions();
+  for(std::vector<std::string>::const_iterator vi = vars.begin();
+      vi != vars.end(); ++vi)
+    {
+    AddValue(data, "var", *vi);
+    AddValue(data, "=", mf->PeekDefinition(vi->c_str()));
+    }
+
+  AddProperties(data, "property", mf->GetProperties());
+  const char* const special[] = {"INCLUDE_DIRECTORIES", "COMPILE_OPTIONS",
+                                 "COMPILE_DEFINITIONS", "DEFINITIONS",
+                                 "LINK_DIRECTORIES", 0};
+  for(const char* const* pi = special; *pi; ++pi)
+    {
+    AddValue(data, *pi, mf->GetProperty(*pi));
+    }
+  AddValue(data, "include_regex", mf->GetIncludeRegularExpression());
+  AddValue(data, "complain_regex", mf->GetComplainRegularExpression());
+
+  for(int p = 0; p < static_cast<int>(cmPolicies::CMPCOUNT); ++p)
+    {
+    cmOStringStream e;
+    e << mf->GetPolicyStatus(static_cast<cmPolicies::PolicyID>(p));
+    AddValue(data, "policy", e.str());
+    }
+
+  std::vector<std::string> const& listFiles = mf->GetListFiles();
+  for(std::vector<std::string>::const_iterator li = listFiles.begin();
+      li != listFiles.end(); ++li)
+    {
+    AddValue(data, "listfile", *li);
+    }
+
+  std::vector<cmTarget*> const& imported = mf->GetOwnedImportedTargets();
+  for(std::vector<cmTarget*>::const_iterator ti = imported.begin();
+      ti != imported.end(); ++ti)
+    {
+    data += this->GetInterfaceDigest(*ti);
+    }
+
+  return this->DirectoryDigests[mf] = Digest(data);
+}
+
+//----------------------------------------------------------------------------
+std::string const&
+cmDirectoryFingerprint::GetInterfaceDigest(cmTarget* target)
+{
+  std::map<cmTarget*, std::string>::iterator i =
+    this->InterfaceDigests.find(target);
+  if(i != this->InterfaceDigests.end())
+    {
+    return i->second;
+    }
+
+  std::string data;
+  AddValue(data, "target", target->GetName());
+  AddValue(data, "in", target->GetMakefile()->GetStartOutputDirectory());
+  AddValue(data, "type", cmTarget::GetTargetTypeName(target->GetType()));
+  AddValue(data, "imported", target->IsImported()? "1" : "0");
+
+  AddProperties(data, "property", target->GetProperties());
+  const char* const special[] = {"INCLUDE_DIRECTORIES", "COMPILE_OPTIONS",
+                                 "COMPILE_DEFINITIONS", 0};
+  for(const char* const* pi = special; *pi; ++pi)
+    {
+    AddValue(data, *pi, target->GetProperty(*pi));
+    }
+
+#define CM_FINGERPRINT_TARGET_POLICY(POLICY) \
+  { \
+  cmOStringStream e; \
+  e << target->GetPolicyStatus ## POLICY (); \
+  AddValue(data, #POLICY, e.str()); \
+  }
+  CM_FOR_EACH_TARGET_POLICY(CM_FINGERPRINT_TARGET_POLICY)
+#undef CM_FINGERPRINT_TARGET_POLICY
+
+  cmTarget::LinkLibraryVectorType const& libs =
+    target->GetOriginalLinkLibraries();
+  for(cmTarget::LinkLibraryVectorType::const_iterator li = libs.begin();
+      li != libs.end(); ++li)
+    {
+    cmOStringStream e;
+    e << li->second;
+    AddValue(data, "link", li->first);
+    AddValue(data, "link_type", e.str());
+    }
+
+  if(!target->IsImported())
+    {
+    // The link language of dependents follows the source languages.
+    std::set<cmStdString> languages;
+    target->GetLanguages(languages);
+    for(std::set<cmStdString>::const_iterator li = languages.begin();
+        li != languages.end(); ++li)
+      {
+      AddValue(data, "language", *li);
+      }
+
+    // Users of object libraries list their objects.
+    if(target->GetType() == cmTarget::OBJECT_LIBRARY)
+      {
+      std::vector<cmSourceFile*> const& sources = target->GetSourceFiles();
+      for(std::vector<cmSourceFile*>::const_iterator si = sources.begin();
+          si != sources.end(); ++si)
+        {
+        AddSourceFile(data, *si);
+        }
+      }
+    }
+
+  if(!cmDirectoryFingerprintNamedTargets(data, target->GetMakefile(),
+                                         this->NamedTargets[target]))
+    {
+    this->ComputedNames.insert(target);
+    }
+  return this->InterfaceDigests[target] = Digest(data);
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryFingerprint::AddTarget(std::string& data, cmTarget* target)
+{
+  data += this->GetInterfaceDigest(target);
+  this->AddLinkedImportedTargets(data, target);
+
+  if(target->GetType() != cmTarget::OBJECT_LIBRARY)
+    {
+    std::vector<cmSourceFile*> const& sources = target->GetSourceFiles();
+    for(std::vector<cmSourceFile*>::const_iterator si = sources.begin();
+        si != sources.end(); ++si)
+      {
+      AddSourceFile(data, *si);
+      }
+    }
+
+  std::vector<std::string> const& objLibs = target->GetObjectLibraries();
+  for(std::vector<std::string>::const_iterator oi = objLibs.begin();
+      oi != objLibs.end(); ++oi)
+    {
+    AddValue(data, "object_library", *oi);
+    }
+
+  std::set<cmStdString> const& utilities = target->GetUtilities();
+  for(std::set<cmStdString>::const_iterator ui = utilities.begin();
+      ui != utilities.end(); ++ui)
+    {
+    AddValue(data, "utility", *ui);
+    }
+
+  std::vector<std::string> const& dirs = target->GetLinkDirectories();
+  for(std::vector<std::string>::const_iterator di = dirs.begin();
+      di != dirs.end(); ++di)
+    {
+    AddValue(data, "link_directory", *di);
+    }
+
+  std::vector<cmCustomCommand>* const commands[] = {
+    &target->GetPreBuildCommands(),
+    &target->GetPreLinkCommands(),
+    &target->GetPostBuildCommands()
+  };
+  for(int i = 0; i < 3; ++i)
+    {
+    AddValue(data, "commands", "");
+    for(std::vector<cmCustomCommand>::const_iterator
+          ci = commands[i]->begin(); ci != commands[i]->end(); ++ci)
+      {
+      AddCustomCommand(data, *ci);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryFingerprint::AddLinkedImportedTargets(std::string& data,
+                                                      cmTarget* target)
+{
+  // Imported targets are not target dependencies.  Include those the
+  // link libraries name as seen from the directory of the target.
+  cmTarget::LinkLibraryVectorType const& libs =
+    target->GetOriginalLinkLibraries();
+  for(cmTarget::LinkLibraryVectorType::const_iterator li = libs.begin();
+      li != libs.end(); ++li)
+    {
+    cmTarget* lib =
+      target->GetMakefile()->FindTargetToUse(li->first.c_str());
+    if(lib && lib->IsImported())
+      {
+      data += this->GetInterfaceDigest(lib);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string cmDirectoryFingerprint::Digest(std::string const& data)
+{
+  cmCryptoHashMD5 md5;
+  return md5.HashString(data.c_str());
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryFingerprint::AddValue(std::string& data, const char* key,
+                                      const char* value)
+{
+  // Prefix each value with its length to keep the values apart.
+  data += key;
+  if(value)
+    {
+    char length[32];
+    sprintf(length, " %lu ", static_cast<unsigned long>(strlen(value)));
+    data += length;
+    data += value;
+    }
+  else
+    {
+    data += " -";
+    }
+  data += "\n";
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryFingerprint::AddValue(std::string& data, const char* key,
+                                      std::string const& value)
+{
+  AddValue(data, key, value.c_str());
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryFingerprint::AddProperties(std::string& data,
+                                           const char* key,
+                                           cmPropertyMap& properties)
+{
+  for(cmPropertyMap::const_iterator pi = properties.begin();
+      pi != properties.end(); ++pi)
+    {
+    AddValue(data, key, pi->first);
+    AddValue(data, "=", pi->second.GetValue());
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryFingerprint::AddSourceFile(std::string& data,
+                                           cmSourceFile* sf)
+{
+  AddValue(data, "source", sf->GetFullPath());
+  AddValue(data, "language", sf->GetLanguage());
+  AddProperties(data, "property", sf->GetProperties());
+  if(cmCustomCommand const* cc = sf->GetCustomCommand())
+    {
+    AddCustomCommand(data, *cc);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryFingerprint::AddCustomCommand(std::string& data,
+                                              cmCustomCommand const& cc)
+{
+  std::vector<std::string> const& outputs = cc.GetOutputs();
+  for(std::vector<std::string>::const_iterator oi = outputs.begin();
+      oi != outputs.end(); ++oi)
+    {
+    AddValue(data, "output", *oi);
+    }
+  std::vector<std::string> const& depends = cc.GetDepends();
+  for(std::vector<std::string>::const_iterator di = depends.begin();
+      di != depends.end(); ++di)
+    {
+    AddValue(data, "depend", *di);
+    }
+  cmCustomCommandLines const& lines = cc.GetCommandLines();
+  for(cmCustomCommandLines::const_iterator li = lines.begin();
+      li != lines.end(); ++li)
+    {
+    AddValue(data, "command", "");
+    for(cmCustomCommandLine::const_iterator ai = li->begin();
+        ai != li->end(); ++ai)
+      {
+      AddValue(data, "arg", *ai);
+      }
+    }
+  cmCustomCommand::ImplicitDependsList const& implicit =
+    cc.GetImplicitDepends();
+  for(cmCustomCommand::ImplicitDependsList::const_iterator
+        ii = implicit.begin(); ii != implicit.end(); ++ii)
+    {
+    AddValue(data, "implicit", ii->first);
+    AddValue(data, "=", ii->second);
+    }
+  AddValue(data, "comment", cc.GetComment());
+  AddValue(data, "working_directory", cc.GetWorkingDirectory());
+  AddValue(data, "escape", cc.GetEscapeOldStyle()? "old" : "new");
+  AddValue(data, "make_vars", cc.GetEscapeAllowMakeVars()? "1" : "0");
+}
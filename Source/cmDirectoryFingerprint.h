@@ -0,0 +1,75 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmDirectoryFingerprint_h
+#define cmDirectoryFingerprint_h
+
+#include "cmStandardIncludes.h"
+
+class cmCustomCommand;
+class cmGlobalGenerator;
+class cmLocalGenerator;
+class cmMakefile;
+class cmPropertyMap;
+class cmSourceFile;
+class cmTarget;
+
+/** \class cmDirectoryFingerprint
+ * \brief Digest the inputs of the files generated for a directory.
+ *
+ * The digest covers the final state of the directory after configure:
+ * its variables and cache entries, properties, policies and targets
+ * with their sources, custom commands and link libraries.  It also
+ * covers the targets those depend on or name in generator expressions,
+ * directly or indirectly, by the parts that can show up in the files
+ * of a dependent: their properties, link libraries and languages, and
+ * the state of the directory defining them.  A directory with the same digest in two
+ * runs of the same CMake generates the same files in both.
+ *
+ * Digests must be computed before any directory is generated because
+ * generating fills in target state lazily.  One instance computes
+ * those of all directories and shares the parts they have in common.
+ */
+class cmDirectoryFingerprint
+{
+public:
+  cmDirectoryFingerprint(cmGlobalGenerator* gg);
+
+  /** Compute the digest for a directory as a string of hex digits.
+      Returns an empty string if generator expressions compute the
+      names of targets they read, which the digest cannot follow.  */
+  std::string Compute(cmLocalGenerator* lg);
+
+private:
+  cmGlobalGenerator* GlobalGenerator;
+  std::string GlobalDigest;
+  std::map<cmMakefile*, std::string> DirectoryDigests;
+  std::map<cmTarget*, std::string> InterfaceDigests;
+  std::map<cmTarget*, std::vector<cmTarget*> > NamedTargets;
+  std::set<cmTarget*> ComputedNames;
+
+  std::string const& GetDirectoryDigest(cmMakefile* mf);
+  std::string const& GetInterfaceDigest(cmTarget* target);
+  void AddTarget(std::string& data, cmTarget* target);
+  void AddLinkedImportedTargets(std::string& data, cmTarget* target);
+  static std::string Digest(std::string const& data);
+  static void AddValue(std::string& data, const char* key,
+                       const char* value);
+  static void AddValue(std::string& data, const char* key,
+                       std::string const& value);
+  static void AddProperties(std::string& data, const char* key,
+                            cmPropertyMap& properties);
+  static void AddSourceFile(std::string& data, cmSourceFile* sf);
+  static void AddCustomCommand(std::string& data,
+                               cmCustomCommand const& cc);
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmDirectoryLock.h"
+
+#include "cmSystemTools.h"
+
+#include <sys/stat.h>
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# include <windows.h>
+# include <direct.h>
+#else
+# include <errno.h>
+# include <signal.h>
+# include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+static unsigned long cmDirectoryLockCurrentProcess()
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  return static_cast<unsigned long>(GetCurrentProcessId());
+#else
+  return static_cast<unsigned long>(getpid());
+#endif
+}
+
+//----------------------------------------------------------------------------
+cmDirectoryLock::cmDirectoryLock(std::string const& path): Path(path)
+{
+  this->Held = false;
+}
+
+//----------------------------------------------------------------------------
+cmDirectoryLock::~cmDirectoryLock()
+{
+  this->Release();
+}
+
+//----------------------------------------------------------------------------
+bool cmDirectoryLock::TryAcquire()
+{
+  if(this->Held)
+    {
+    return true;
+    }
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  this->Held = _mkdir(this->Path.c_str()) == 0;
+#else
+  this->Held = mkdir(this->Path.c_str(), 0777) == 0;
+#endif
+  if(this->Held)
+    {
+    std::ofstream fout((this->Path + "/pid").c_str());
+    fout << cmDirectoryLockCurrentProcess() << "\n";
+    }
+  return this->Held;
+}
+
+//----------------------------------------------------------------------------
+bool cmDirectoryLock::Acquire()
+{
+  // The holder records itself right after taking the lock, so consider
+  // it gone only if it is not known for a while.
+  int ownerless = 0;
+  while(!this->TryAcquire())
+    {
+    if(!this->Exists())
+      {
+      // The lock vanished or cannot be created.  Try once more to tell.
+      if(this->TryAcquire())
+        {
+        break;
+        }
+      if(!this->Exists())
+        {
+        return false;
+        }
+      }
+    if(this->OwnerRuns())
+      {
+      ownerless = 0;
+      }
+    else if(++ownerless > 50)
+      {
+      cmSystemTools::RemoveADirectory(this->Path.c_str());
+      ownerless = 0;
+      continue;
+      }
+    cmSystemTools::Delay(10);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmDirectoryLock::Release()
+{
+  if(this->Held)
+    {
+    cmSystemTools::RemoveADirectory(this->Path.c_str());
+    this->Held = false;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmDirectoryLock::Exists() const
+{
+  return cmSystemTools::FileIsDirectory(this->Path.c_str());
+}
+
+//----------------------------------------------------------------------------
+bool cmDirectoryLock::OwnerRuns() const
+{
+  std::ifstream fin((this->Path + "/pid").c_str());
+  unsigned long pid = 0;
+  if(!(fin >> pid) || pid == 0)
+    {
+    return false;
+    }
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+  if(!process)
+    {
+    return false;
+    }
+  bool running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+  CloseHandle(process);
+  return running;
+#else
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
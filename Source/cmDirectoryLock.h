@@ -0,0 +1,62 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmDirectoryLock_h
+#define cmDirectoryLock_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmDirectoryLock
+ * \brief Lock shared files between processes with a directory.
+ *
+ * Creating a directory is atomic, so the process that creates the lock
+ * directory holds the lock.  The holder records its process id in the
+ * directory so that others can tell whether it still runs.
+ */
+class cmDirectoryLock
+{
+public:
+  /** Refer to the lock directory at the given path.  */
+  cmDirectoryLock(std::string const& path);
+
+  /** Release the lock if it is held.  */
+  ~cmDirectoryLock();
+
+  /** Try once to take the lock.  Returns true if it is now held.  */
+  bool TryAcquire();
+
+  /** Wait until the lock is held.  A lock whose holder stopped running
+      is removed.  Returns false if the lock directory cannot be
+      created at all.  */
+  bool Acquire();
+
+  /** Remove the lock directory if it is held.  */
+  void Release();
+
+  /** Whether this object holds the lock.  */
+  bool IsHeld() const { return this->Held; }
+
+  /** Whether the lock directory exists.  */
+  bool Exists() const;
+
+  /** Whether the process recorded in the lock directory still runs.  */
+  bool OwnerRuns() const;
+
+  std::string const& GetPath() const { return this->Path; }
+
+private:
+  std::string Path;
+  bool Held;
+  cmDirectoryLock(cmDirectoryLock const&); // Purposely not implemented.
+  void operator=(cmDirectoryLock const&); // Purposely not implemented.
+};
+
+#endif
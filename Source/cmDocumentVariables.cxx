@@ -567,6 +567,20 @@ void cmDocumentVariables::DefineVariables(cmake* cm)
      false,
      "Variables That Change Behavior");
 
+    cm->DefineProperty
+    ("CMAKE_INSTALL_DATABASE",  cmProperty::VARIABLE,
+     "File in which the install script records what it installed.",
+     "For every file installed the database holds its size, time, "
+     "permissions and MD5 hash along with the time of the file it was "
+     "installed from.  Installing again skips the files whose source "
+     "and destination did not change since without reading them, and "
+     "does not copy a source rebuilt with the same contents.  It "
+     "defaults to install_database.txt in the top of the build tree.  "
+     "Set it to an empty string when running cmake_install.cmake to "
+     "install without the database.",
+     false,
+     "Variables That Change Behavior");
+
     cm->DefineProperty
     ("CMAKE_FIND_LIBRARY_PREFIXES",  cmProperty::VARIABLE,
      "Prefixes to prepend when looking for libraries.",
@@ -675,6 +689,42 @@ void cmDocumentVariables::DefineVariables(cmake* cm)
      ,false,
      "Variables That Change Behavior");
 
+  cm->DefineProperty
+    ("CMAKE_PARALLEL_GENERATE", cmProperty::VARIABLE,
+     "Write the build files of directories on several threads.",
+     "By default the build system is generated on one thread.  "
+     "If CMAKE_PARALLEL_GENERATE is set to TRUE the Makefile generators "
+     "write the build files of different directories concurrently on "
+     "one thread per processor.  A positive number selects the number "
+     "of threads.  "
+     "The generated files are the same either way.  Computations that "
+     "are shared between directories, such as link dependencies, are "
+     "still done one at a time.  "
+     "The setting is ignored by other generators, on Windows, and when "
+     "generation has to be done in order: with --warn-unused-vars, "
+     "with the REPORT_UNDEFINED_PROPERTIES global property, when "
+     "CMAKE_EXPORT_COMPILE_COMMANDS is enabled, or when Mac OS X bundles "
+     "or frameworks are built."
+     ,false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_SKIP_INCREMENTAL_GENERATE", cmProperty::VARIABLE,
+     "Write the build files of every directory again on each run.",
+     "By default the Makefile generators keep the build files of a "
+     "directory whose inputs did not change since the last run, and "
+     "record a fingerprint of those inputs in "
+     "CMakeFiles/CMakeDirectoryFingerprint.txt.  "
+     "If CMAKE_SKIP_INCREMENTAL_GENERATE is set to TRUE, in a directory "
+     "or in the cache, the build files of the directory are written "
+     "every time.  "
+     "Directories whose generation reported any message, the top "
+     "directory, try_compile projects, directories with "
+     "CMAKE_EXPORT_COMPILE_COMMANDS enabled and directories building "
+     "Mac OS X bundles or frameworks are always written."
+     ,false,
+     "Variables That Change Behavior");
+
   cm->DefineProperty
     ("CMAKE_MODULE_PATH", cmProperty::VARIABLE,
      "List of directories to search for CMake modules.",
@@ -1530,6 +1580,25 @@ void cmDocumentVariables::DefineVariables(cmake* cm)
      "Therefore a specific build configuration must be chosen even "
      "if the generated build system supports multiple configurations.",false,
      "Variables that Control the Build");
+  cm->DefineProperty
+    ("CMAKE_TRY_COMPILE_CACHE_DIR", cmProperty::VARIABLE,
+     "Directory where try_compile and try_run keep their results.",
+     "When set, the output and executable of each successful "
+     "try_compile and try_run using the srcfile signature are stored in "
+     "this directory.  Later calls that would build the same project "
+     "again, in this or any other build tree, load them instead.  "
+     "Failures are not stored, so a call that failed builds again.  "
+     "Entries are named by a hash of the generated project, the content "
+     "of the sources, the flags, definitions and link libraries given, "
+     "the compilers and the platform as determined for the build tree.  "
+     "Headers and libraries found outside of the sources are not "
+     "covered, so the directory should be emptied when the system they "
+     "come from changes or loses some of them.  "
+     "Calls linking IMPORTED targets and calls made with "
+     "--debug-trycompile always build.  "
+     "The directory may be shared by build trees configured at the same "
+     "time.",false,
+     "Variables that Control the Build");
   cm->DefineProperty
     ("CMAKE_LINK_INTERFACE_LIBRARIES", cmProperty::VARIABLE,
      "Default value for LINK_INTERFACE_LIBRARIES of targets.",
@@ -15,6 +15,8 @@
 #include "cmHexFileConverter.h"
 #include "cmInstallType.h"
 #include "cmFileTimeComparison.h"
+#include "cmInstallDatabase.h"
+#include "cmWorkerPool.h"
 #include "cmCryptoHash.h"
 
 #include "cmTimestamp.h"
@@ -135,6 +137,10 @@ bool cmFileCommand
     {
     return this->HandleInstallCommand(args);
     }
+  else if ( subCommand == "INSTALL_DATABASE" )
+    {
+    return this->HandleInstallDatabaseCommand(args);
+    }
   else if ( subCommand == "DIFFERENT" )
     {
     return this->HandleDifferentCommand(args);
@@ -947,6 +953,130 @@ cmFileCommand::HandleDifferentCommand(std::vector<std::string> const& args)
   return true;
 }
 
+//----------------------------------------------------------------------------
+// Install one regular file.  Jobs run on worker threads once the
+// cmFileCopier has walked all its inputs, so they only record what
+// happened for the copier to report afterwards in walk order.
+class cmFileCopierJob: public cmWorkerPool::Job
+{
+public:
+  cmFileCopierJob(std::string const& from, std::string const& to,
+                  mode_t permissions, bool always,
+                  cmInstallDatabase* database):
+    From(from), To(to), Permissions(permissions), Always(always),
+    Database(database), Copy(true), Failure(FailNone) {}
+  virtual void Run();
+
+  std::string From;
+  std::string To;
+  mode_t Permissions;
+  bool Always;
+  cmInstallDatabase* Database;
+  bool Copy;
+  enum { FailNone, FailCopy, FailTime, FailPermissions } Failure;
+};
+
+//----------------------------------------------------------------------------
+void cmFileCopierJob::Run()
+{
+  // Look up what a previous install wrote to the destination.  It is
+  // known only if it was installed from the same source and has not
+  // changed since.
+  cmInstallDatabase::FileInfo from;
+  cmInstallDatabase::FileInfo to;
+  cmInstallDatabase::Entry entry;
+  bool known = (this->Database &&
+                cmInstallDatabase::Stat(this->From.c_str(), from) &&
+                cmInstallDatabase::Stat(this->To.c_str(), to) &&
+                this->Database->Lookup(this->To, entry) &&
+                entry.Type == 'f' && entry.Source == this->From &&
+                entry.Info.Size == to.Size &&
+                entry.Info.MTime == to.MTime && entry.Info.Mode == to.Mode);
+
+  if(!this->Always)
+    {
+    if(known)
+      {
+      // Copy only if the source changed since it was installed, and
+      // not if it was rebuilt with the same contents.
+      this->Copy = (from.Size != to.Size ||
+                    (from.MTime != entry.SourceMTime &&
+                     (entry.Hash.empty() ||
+                      cmInstallDatabase::HashFile(this->From.c_str()) !=
+                      entry.Hash)));
+      }
+    else
+      {
+      // If both files exist with the same time do not copy.
+      cmFileTimeComparison fileTimes;
+      this->Copy = fileTimes.FileTimesDiffer(this->From.c_str(),
+                                             this->To.c_str());
+      }
+    }
+
+  if(this->Copy)
+    {
+    if(!cmSystemTools::CloneFile(this->From.c_str(), this->To.c_str()))
+      {
+      this->Failure = FailCopy;
+      return;
+      }
+
+    // Set the file modification time of the destination file.
+    if(!this->Always)
+      {
+      // Add write permission so we can set the file time.
+      // Permissions are set unconditionally below anyway.
+      mode_t perm = 0;
+      if(cmSystemTools::GetPermissions(this->To.c_str(), perm))
+        {
+        cmSystemTools::SetPermissions(this->To.c_str(),
+                                      perm | mode_owner_write);
+        }
+      if(!cmSystemTools::CopyFileTime(this->From.c_str(), this->To.c_str()))
+        {
+        this->Failure = FailTime;
+        return;
+        }
+      }
+    }
+
+  // Set permissions of the destination file.  An up-to-date file that
+  // already has them is left alone so that it is not written at all.
+  mode_t permissions = this->Permissions;
+  if(!permissions)
+    {
+    // No permissions were explicitly provided but the user requested
+    // that the source file permissions be used.
+    cmSystemTools::GetPermissions(this->From.c_str(), permissions);
+    }
+  mode_t current = 0;
+  if(permissions &&
+     (this->Copy ||
+      !cmSystemTools::GetPermissions(this->To.c_str(), current) ||
+      (current & 07777) != (permissions & 07777)) &&
+     !cmSystemTools::SetPermissions(this->To.c_str(), permissions))
+    {
+    this->Failure = FailPermissions;
+    return;
+    }
+
+  // Record the installed file.
+  if(this->Database &&
+     cmInstallDatabase::Stat(this->To.c_str(), entry.Info) &&
+     (known || cmInstallDatabase::Stat(this->From.c_str(), from)))
+    {
+    entry.Type = 'f';
+    entry.Source = this->From;
+    entry.SourceMTime = from.MTime;
+    if(!known || this->Copy)
+      {
+      entry.Hash = cmInstallDatabase::HashFile(this->To.c_str());
+      }
+    this->Database->Store(this->To, entry);
+    }
+}
+
 //----------------------------------------------------------------------------
 // File installation helper class.
 struct cmFileCopier
@@ -956,6 +1086,7 @@ struct cmFileCopier
     Makefile(command->GetMakefile()),
     Name(name),
     Always(false),
+    Database(0),
     MatchlessFiles(true),
     FilePermissions(0),
     DirPermissions(0),
@@ -966,7 +1097,14 @@ struct cmFileCopier
     Doing(DoingNone)
     {
     }
-  virtual ~cmFileCopier() {}
+  virtual ~cmFileCopier()
+    {
+    for(std::vector<cmFileCopierJob*>::iterator ji =
+          this->PendingFiles.begin(); ji != this->PendingFiles.end(); ++ji)
+      {
+      delete *ji;
+      }
+    }
 
   bool Run(std::vector<std::string> const& args);
 protected:
@@ -977,6 +1115,18 @@ protected:
   bool Always;
   cmFileTimeComparison FileTimes;
 
+  // Database of installed files, if any.
+  cmInstallDatabase* Database;
+  void Record(const char* file, char type)
+    {
+    cmInstallDatabase::Entry entry;
+    if(this->Database && cmInstallDatabase::Stat(file, entry.Info))
+      {
+      entry.Type = type;
+      this->Database->Store(file, entry);
+      }
+    }
+
   // Whether to install a file not matching any expression.
   bool MatchlessFiles;
 
@@ -1095,6 +1245,40 @@ protected:
     return false;
     }
 
+  // Regular files are installed in one batch on several threads once
+  // all inputs have been walked.  Reports are queued meanwhile so that
+  // they still appear in walk order, and directory permissions that
+  // would keep files out are set last.
+  struct PendingReport
+  {
+    std::string File;
+    Type FileType;
+    bool Copy;
+    cmFileCopierJob* Job;
+  };
+  std::vector<cmFileCopierJob*> PendingFiles;
+  std::set<cmStdString> PendingDestinations;
+  std::vector<PendingReport> PendingReports;
+  std::vector<std::pair<std::string, mode_t> > PendingPermissions;
+  void QueueReport(const char* file, Type type, bool copy,
+                   cmFileCopierJob* job = 0)
+    {
+    PendingReport r;
+    r.File = file;
+    r.FileType = type;
+    r.Copy = copy;
+    r.Job = job;
+    this->PendingReports.push_back(r);
+    }
+  bool InstallPendingFiles(bool setError = true);
+  bool InstallPendingFilesBefore(const char* toFile)
+    {
+    // A destination given twice is written in order.
+    return (!this->PendingDestinations.insert(toFile).second?
+            this->InstallPendingFiles() &&
+            this->PendingDestinations.insert(toFile).second : true);
+    }
+
   MatchRule* CurrentMatchRule;
   bool UseGivenPermissionsFile;
   bool UseGivenPermissionsDir;
@@ -1448,10 +1632,87 @@ bool cmFileCopier::Run(std::vector<std::string> const& args)
 
     if(!this->Install(fromFile.c_str(), toFile.c_str()))
       {
+      // Finish what was walked so far, as when installing file by file,
+      // but keep the error that stopped the walk.
+      this->InstallPendingFiles(false);
       return false;
       }
     }
-  return true;
+  return this->InstallPendingFiles();
+}
+
+//----------------------------------------------------------------------------
+bool cmFileCopier::InstallPendingFiles(bool setError)
+{
+  std::vector<cmWorkerPool::Job*> jobs(this->PendingFiles.begin(),
+                                       this->PendingFiles.end());
+  unsigned int threads = cmWorkerPool::GetDefaultThreadCount();
+  if(threads > jobs.size())
+    {
+    threads = static_cast<unsigned int>(jobs.size());
+    }
+  cmWorkerPool::RunJobs(jobs, threads);
+
+  bool okay = true;
+  for(std::vector<PendingReport>::const_iterator ri =
+        this->PendingReports.begin();
+      okay && ri != this->PendingReports.end(); ++ri)
+    {
+    cmFileCopierJob* job = ri->Job;
+    this->ReportCopy(ri->File.c_str(), ri->FileType,
+                     job? job->Copy : ri->Copy);
+    if(!job || job->Failure == cmFileCopierJob::FailNone)
+      {
+      continue;
+      }
+    cmOStringStream e;
+    switch(job->Failure)
+      {
+      case cmFileCopierJob::FailCopy:
+        e << this->Name << " cannot copy file \"" << job->From
+          << "\" to \"" << job->To << "\".";
+        break;
+      case cmFileCopierJob::FailTime:
+        e << this->Name << " cannot set modification time on \""
+          << job->To << "\"";
+        break;
+      default:
+        e << this->Name << " cannot set permissions on \""
+          << job->To << "\"";
+        break;
+      }
+    if(setError)
+      {
+      this->FileCommand->SetError(e.str().c_str());
+      }
+    okay = false;
+    }
+
+  // Set the requested permissions of the destination directories.
+  for(std::vector<std::pair<std::string, mode_t> >::const_iterator pi =
+        this->PendingPermissions.begin();
+      okay && pi != this->PendingPermissions.end(); ++pi)
+    {
+    if(setError)
+      {
+      okay = this->SetPermissions(pi->first.c_str(), pi->second);
+      }
+    else if(pi->second)
+      {
+      okay = cmSystemTools::SetPermissions(pi->first.c_str(), pi->second);
+      }
+    }
+
+  for(std::vector<cmFileCopierJob*>::iterator ji =
+        this->PendingFiles.begin(); ji != this->PendingFiles.end(); ++ji)
+    {
+    delete *ji;
+    }
+  this->PendingFiles.clear();
+  this->PendingDestinations.clear();
+  this->PendingReports.clear();
+  this->PendingPermissions.clear();
+  return okay;
 }
 
 //----------------------------------------------------------------------------
@@ -1523,7 +1784,11 @@ bool cmFileCopier::InstallSymlink(const char* fromFile, const char* toFile)
     }
 
   // Inform the user about this file installation.
-  this->ReportCopy(toFile, TypeLink, copy);
+  if(!this->InstallPendingFilesBefore(toFile))
+    {
+    return false;
+    }
+  this->QueueReport(toFile, TypeLink, copy);
 
   if(copy)
     {
@@ -1541,6 +1806,7 @@ bool cmFileCopier::InstallSymlink(const char* fromFile, const char* toFile)
       }
     }
 
+  this->Record(toFile, 'l');
   return true;
 }
 
@@ -1548,60 +1814,21 @@ bool cmFileCopier::InstallSymlink(const char* fromFile, const char* toFile)
 bool cmFileCopier::InstallFile(const char* fromFile, const char* toFile,
                                MatchProperties const& match_properties)
 {
-  // Determine whether we will copy the file.
-  bool copy = true;
-  if(!this->Always)
-    {
-    // If both files exist with the same time do not copy.
-    if(!this->FileTimes.FileTimesDiffer(fromFile, toFile))
-      {
-      copy = false;
-      }
-    }
-
-  // Inform the user about this file installation.
-  this->ReportCopy(toFile, TypeFile, copy);
-
-  // Copy the file.
-  if(copy && !cmSystemTools::CopyAFile(fromFile, toFile, true))
+  // Copy the file, set its time and its permissions with the others.
+  if(!this->InstallPendingFilesBefore(toFile))
     {
-    cmOStringStream e;
-    e << this->Name << " cannot copy file \"" << fromFile
-      << "\" to \"" << toFile << "\".";
-    this->FileCommand->SetError(e.str().c_str());
     return false;
     }
-
-  // Set the file modification time of the destination file.
-  if(copy && !this->Always)
-    {
-    // Add write permission so we can set the file time.
-    // Permissions are set unconditionally below anyway.
-    mode_t perm = 0;
-    if(cmSystemTools::GetPermissions(toFile, perm))
-      {
-      cmSystemTools::SetPermissions(toFile, perm | mode_owner_write);
-      }
-    if (!cmSystemTools::CopyFileTime(fromFile, toFile))
-      {
-      cmOStringStream e;
-      e << this->Name << " cannot set modification time on \""
-        << toFile << "\"";
-      this->FileCommand->SetError(e.str().c_str());
-      return false;
-      }
-    }
-
-  // Set permissions of the destination file.
   mode_t permissions = (match_properties.Permissions?
                         match_properties.Permissions : this->FilePermissions);
-  if(!permissions)
-    {
-    // No permissions were explicitly provided but the user requested
-    // that the source file permissions be used.
-    cmSystemTools::GetPermissions(fromFile, permissions);
-    }
-  return this->SetPermissions(toFile, permissions);
+  cmFileCopierJob* job =
+    new cmFileCopierJob(fromFile, toFile, permissions, this->Always,
+                        this->Database);
+  this->PendingFiles.push_back(job);
+
+  // Inform the user about this file installation.
+  this->QueueReport(toFile, TypeFile, true, job);
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -1610,7 +1837,7 @@ bool cmFileCopier::InstallDirectory(const char* source,
                                     MatchProperties const& match_properties)
 {
   // Inform the user about this directory installation.
-  this->ReportCopy(destination, TypeDir, true);
+  this->QueueReport(destination, TypeDir, true);
 
   // Make sure the destination directory exists.
   if(!cmSystemTools::MakeDirectory(destination))
@@ -1621,6 +1848,7 @@ bool cmFileCopier::InstallDirectory(const char* source,
     this->FileCommand->SetError(e.str().c_str());
     return false;
     }
+  this->Record(destination, 'd');
 
   // Compute the requested permissions for the destination directory.
   mode_t permissions = (match_properties.Permissions?
@@ -1683,8 +1911,14 @@ bool cmFileCopier::InstallDirectory(const char* source,
       }
     }
 
-  // Set the requested permissions of the destination directory.
-  return this->SetPermissions(destination, permissions_after);
+  // Set the requested permissions of the destination directory once
+  // the files in it are installed.
+  if(permissions_after)
+    {
+    this->PendingPermissions.push_back(
+      std::pair<std::string, mode_t>(destination, permissions_after));
+    }
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -1711,6 +1945,13 @@ struct cmFileInstaller: public cmFileCopier
     // Get the current manifest.
     this->Manifest =
       this->Makefile->GetSafeDefinition("CMAKE_INSTALL_MANIFEST_FILES");
+    // Use the database of installed files, if any.
+    const char* database =
+      this->Makefile->GetDefinition("CMAKE_INSTALL_DATABASE");
+    if(database && *database)
+      {
+      this->Database = cmInstallDatabase::Get(database);
+      }
     }
   ~cmFileInstaller()
     {
@@ -2317,6 +2558,26 @@ bool cmFileCommand::HandleInstallCommand(std::vector<std::string> const& args)
   return installer.Run(args);
 }
 
+//----------------------------------------------------------------------------
+bool
+cmFileCommand::HandleInstallDatabaseCommand(
+  std::vector<std::string> const& args)
+{
+  if(args.size() != 2)
+    {
+    this->SetError("INSTALL_DATABASE must be given exactly one file.");
+    return false;
+    }
+  if(!cmInstallDatabase::Get(args[1])->Save())
+    {
+    cmOStringStream e;
+    e << "INSTALL_DATABASE cannot write \"" << args[1] << "\".";
+    this->SetError(e.str().c_str());
+    return false;
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool cmFileCommand::HandleRelativePathCommand(
   std::vector<std::string> const& args)
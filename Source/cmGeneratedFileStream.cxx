@@ -15,6 +15,48 @@
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 # include <cm_zlib.h>
+
+// Stream buffer writing to a gzip file.
+class cmGeneratedFileStreamGzip: public std::streambuf
+{
+public:
+  cmGeneratedFileStreamGzip(gzFile gf): File(gf)
+    {
+    this->setp(this->Buffer, this->Buffer + sizeof(this->Buffer));
+    }
+  bool Close()
+    {
+    bool okay = this->sync() == 0;
+    return gzclose(this->File) == Z_OK && okay;
+    }
+protected:
+  virtual int_type overflow(int_type c)
+    {
+    if(this->sync() != 0)
+      {
+      return traits_type::eof();
+      }
+    if(!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+      *this->pptr() = traits_type::to_char_type(c);
+      this->pbump(1);
+      }
+    return traits_type::not_eof(c);
+    }
+  virtual int sync()
+    {
+    int n = static_cast<int>(this->pptr() - this->pbase());
+    if(n > 0 && gzwrite(this->File, this->pbase(), n) != n)
+      {
+      return -1;
+      }
+    this->setp(this->Buffer, this->Buffer + sizeof(this->Buffer));
+    return 0;
+    }
+private:
+  gzFile File;
+  char Buffer[16384];
+};
 #endif
 
 //----------------------------------------------------------------------------
@@ -46,6 +88,10 @@ cmGeneratedFileStream::~cmGeneratedFileStream()
   // Finally the base destructor will be called to replace the
   // destination file.
   this->Okay = (*this)?true:false;
+  if(this->Gzip)
+    {
+    this->Okay = this->CloseCompression() && this->Okay;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -84,7 +130,14 @@ cmGeneratedFileStream::Close()
   this->Okay = (*this)?true:false;
 
   // Close the temporary output file.
-  this->Stream::close();
+  if(this->Gzip)
+    {
+    this->Okay = this->CloseCompression() && this->Okay;
+    }
+  else
+    {
+    this->Stream::close();
+    }
 
   // Remove the temporary file (possibly by renaming to the real file).
   return this->cmGeneratedFileStreamBase::Close();
@@ -99,7 +152,44 @@ void cmGeneratedFileStream::SetCopyIfDifferent(bool copy_if_different)
 //----------------------------------------------------------------------------
 void cmGeneratedFileStream::SetCompression(bool compression)
 {
+  if(this->Gzip)
+    {
+    // The temporary file is already compressed.
+    return;
+    }
   this->Compress = compression;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Compress the output as it is written instead of compressing the
+  // whole temporary file when it is closed.
+  if(compression && this->is_open() && this->tellp() == 0)
+    {
+    this->Stream::close();
+    gzFile gf = gzopen(this->TempName.c_str(), "wb");
+    if(gf)
+      {
+      this->Gzip = new cmGeneratedFileStreamGzip(gf);
+      this->TempCompressed = true;
+      this->std::ios::rdbuf(this->Gzip);
+      }
+    else
+      {
+      this->Stream::open(this->TempName.c_str(), std::ios::out);
+      }
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmGeneratedFileStream::CloseCompression()
+{
+  bool okay = false;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  okay = this->Gzip->Close();
+  this->std::ios::rdbuf(this->Stream::rdbuf());
+  delete this->Gzip;
+  this->Gzip = 0;
+#endif
+  return okay;
 }
 
 //----------------------------------------------------------------------------
@@ -115,7 +205,9 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase():
   CopyIfDifferent(false),
   Okay(false),
   Compress(false),
-  CompressExtraExtension(true)
+  CompressExtraExtension(true),
+  Gzip(0),
+  TempCompressed(false)
 {
 }
 
@@ -126,7 +218,9 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase(const char* name):
   CopyIfDifferent(false),
   Okay(false),
   Compress(false),
-  CompressExtraExtension(true)
+  CompressExtraExtension(true),
+  Gzip(0),
+  TempCompressed(false)
 {
   this->Open(name);
 }
@@ -151,6 +245,8 @@ void cmGeneratedFileStreamBase::Open(const char* name)
   this->TempName += ".tmp";
 #endif
 
+  this->TempCompressed = false;
+
   // Make sure the temporary file that will be used is not present.
   cmSystemTools::RemoveFile(this->TempName.c_str());
 
@@ -178,7 +274,7 @@ bool cmGeneratedFileStreamBase::Close()
     {
     // The destination is to be replaced.  Rename the temporary to the
     // destination atomically.
-    if ( this->Compress )
+    if ( this->Compress && !this->TempCompressed )
       {
       std::string gzname = this->TempName + ".temp.gz";
       if ( this->CompressFile(this->TempName.c_str(), gzname.c_str()) )
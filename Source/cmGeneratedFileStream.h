@@ -18,6 +18,8 @@
 # pragma set woff 1375 /* base class destructor not virtual */
 #endif
 
+class cmGeneratedFileStreamGzip;
+
 // This is the first base class of cmGeneratedFileStream.  It will be
 // created before and destroyed after the ofstream portion and can
 // therefore be used to manage the temporary file.
@@ -64,6 +66,13 @@ protected:
 
   // Whether the destionation file is compressed
   bool CompressExtraExtension;
+
+  // The buffer compressing the output into the temporary file, if the
+  // output is compressed as it is written.
+  cmGeneratedFileStreamGzip* Gzip;
+
+  // Whether the temporary file was written compressed.
+  bool TempCompressed;
 };
 
 /** \class cmGeneratedFileStream
@@ -126,7 +135,9 @@ public:
   void SetCopyIfDifferent(bool copy_if_different);
 
   /**
-   * Set whether compression is done.
+   * Set whether compression is done.  If nothing has been written to
+   * the open stream yet the output is compressed as it is written.
+   * Otherwise it is compressed when the stream is closed.
    */
   void SetCompression(bool compression);
 
@@ -142,6 +153,7 @@ public:
   void SetName(const char* fname);
 
 private:
+  bool CloseCompression();
   cmGeneratedFileStream(cmGeneratedFileStream const&); // not implemented
 };
 
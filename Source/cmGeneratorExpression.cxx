@@ -21,6 +21,7 @@
 #include "cmGeneratorExpressionLexer.h"
 #include "cmGeneratorExpressionParser.h"
 #include "cmGeneratorExpressionDAGChecker.h"
+#include "cmWorkerPool.h"
 
 //----------------------------------------------------------------------------
 cmGeneratorExpression::cmGeneratorExpression(
@@ -76,6 +77,9 @@ const char *cmCompiledGeneratorExpression::Evaluate(
     return this->Input.c_str();
     }
 
+  // Evaluation reads and computes target state lazily.
+  cmWorkerPool::ModelLock lock;
+
   this->Output = "";
 
   std::vector<cmGeneratorExpressionEvaluator*>::const_iterator it
@@ -27,10 +27,12 @@
 #include "cmGeneratorTarget.h"
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorExpressionEvaluationFile.h"
+#include "cmWorkerPool.h"
 
 #include <cmsys/Directory.hxx>
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmDirectoryFingerprint.h"
 # include <cmsys/MD5.h>
 #endif
 
@@ -1038,17 +1040,37 @@ void cmGlobalGenerator::Generate()
       }
     }
 
-  // Generate project files
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Fingerprint the inputs of each directory before generating fills
+  // in target state lazily.
+  {
+  cmDirectoryFingerprint fingerprint(this);
   for (i = 0; i < this->LocalGenerators.size(); ++i)
     {
-    this->LocalGenerators[i]->GetMakefile()->SetGeneratingBuildSystem();
-    this->SetCurrentLocalGenerator(this->LocalGenerators[i]);
-    this->LocalGenerators[i]->Generate();
-    this->LocalGenerators[i]->GenerateInstallRules();
-    this->LocalGenerators[i]->GenerateTestFiles();
-    this->CMakeInstance->UpdateProgress("Generating",
-      (static_cast<float>(i)+1.0f)/
-       static_cast<float>(this->LocalGenerators.size()));
+    this->LocalGenerators[i]->ComputeInputFingerprint(fingerprint);
+    }
+  }
+#endif
+
+  // Generate project files
+  unsigned int threads = this->GetGenerateThreads();
+  if(threads > 1)
+    {
+    this->GenerateInParallel(threads);
+    }
+  else
+    {
+    for (i = 0; i < this->LocalGenerators.size(); ++i)
+      {
+      this->LocalGenerators[i]->GetMakefile()->SetGeneratingBuildSystem();
+      this->SetCurrentLocalGenerator(this->LocalGenerators[i]);
+      this->LocalGenerators[i]->Generate();
+      this->LocalGenerators[i]->GenerateInstallRules();
+      this->LocalGenerators[i]->GenerateTestFiles();
+      this->CMakeInstance->UpdateProgress("Generating",
+        (static_cast<float>(i)+1.0f)/
+         static_cast<float>(this->LocalGenerators.size()));
+      }
     }
   this->SetCurrentLocalGenerator(0);
 
@@ -1065,6 +1087,124 @@ void cmGlobalGenerator::Generate()
   this->CMakeInstance->UpdateProgress("Generating done", -1);
 }
 
+//----------------------------------------------------------------------------
+unsigned int cmGlobalGenerator::GetGenerateThreads()
+{
+  if(this->LocalGenerators.size() < 2 || !this->CanGenerateInParallel())
+    {
+    return 1;
+    }
+  cmMakefile* root = this->LocalGenerators[0]->GetMakefile();
+  const char* value = root->GetDefinition("CMAKE_PARALLEL_GENERATE");
+  if(!value || cmSystemTools::IsOff(value))
+    {
+    return 1;
+    }
+  unsigned int threads = 1;
+  char* end;
+  long count = strtol(value, &end, 10);
+  if(end != value && *end == '\0')
+    {
+    threads = count > 0? static_cast<unsigned int>(count) : 1;
+    }
+  else if(cmSystemTools::IsOn(value))
+    {
+    threads = cmWorkerPool::GetDefaultThreadCount();
+    }
+
+  // Some features record what happens in the order it happens or run
+  // CMake code while generating.  Keep to one thread for them.
+#ifdef CMAKE_STRICT
+  threads = 1;
+#endif
+  if(this->CMakeInstance->GetWarnUnused() ||
+     this->CMakeInstance->GetProperty("REPORT_UNDEFINED_PROPERTIES"))
+    {
+    threads = 1;
+    }
+  for(unsigned int i = 0; threads > 1 && i < this->LocalGenerators.size();
+      ++i)
+    {
+    cmMakefile* mf = this->LocalGenerators[i]->GetMakefile();
+    if(mf->IsOn("CMAKE_EXPORT_COMPILE_COMMANDS"))
+      {
+      threads = 1;
+      }
+    cmTargets& targets = mf->GetTargets();
+    for(cmTargets::iterator ti = targets.begin(); ti != targets.end(); ++ti)
+      {
+      // Info.plist files are configured in a scope of the makefile.
+      if(ti->second.IsAppBundleOnApple() ||
+         ti->second.IsFrameworkOnApple() ||
+         ti->second.IsCFBundleOnApple())
+        {
+        threads = 1;
+        }
+      }
+    }
+  return threads;
+}
+
+//----------------------------------------------------------------------------
+class cmGlobalGeneratorGenerateJob: public cmWorkerPool::Job
+{
+public:
+  cmGlobalGeneratorGenerateJob(cmLocalGenerator* lg): LG(lg) {}
+  virtual void Run() { this->LG->Generate(); }
+private:
+  cmLocalGenerator* LG;
+};
+
+//----------------------------------------------------------------------------
+void cmGlobalGenerator::GenerateInParallel(unsigned int threads)
+{
+  unsigned int i;
+  for (i = 0; i < this->LocalGenerators.size(); ++i)
+    {
+    this->LocalGenerators[i]->GetMakefile()->SetGeneratingBuildSystem();
+    }
+
+  // The top directory writes rules that refer to all the others, so
+  // generate it first just as it is done on one thread.
+  this->SetCurrentLocalGenerator(this->LocalGenerators[0]);
+  this->LocalGenerators[0]->Generate();
+  this->SetCurrentLocalGenerator(0);
+
+  // Set up the path conversions of all directories up front.  They
+  // are computed on first use and used by other directories too.
+  std::vector<cmWorkerPool::Job*> jobs;
+  for (i = 1; i < this->LocalGenerators.size(); ++i)
+    {
+    cmLocalGenerator* lg = this->LocalGenerators[i];
+    lg->Convert(lg->GetMakefile()->GetHomeOutputDirectory(),
+                cmLocalGenerator::START_OUTPUT);
+    jobs.push_back(new cmGlobalGeneratorGenerateJob(lg));
+    }
+
+  // Write the build files of the other directories concurrently.
+  // Shared state that is computed on demand is guarded by the model
+  // lock for the duration.
+  cmWorkerPool::ModelLock::Enable(true);
+  cmWorkerPool::RunJobs(jobs, threads);
+  cmWorkerPool::ModelLock::Enable(false);
+  for(std::vector<cmWorkerPool::Job*>::iterator ji = jobs.begin();
+      ji != jobs.end(); ++ji)
+    {
+    delete *ji;
+    }
+
+  // Install and test files are written in order as usual.
+  for (i = 0; i < this->LocalGenerators.size(); ++i)
+    {
+    this->SetCurrentLocalGenerator(this->LocalGenerators[i]);
+    this->LocalGenerators[i]->GenerateInstallRules();
+    this->LocalGenerators[i]->GenerateTestFiles();
+    this->CMakeInstance->UpdateProgress("Generating",
+      (static_cast<float>(i)+1.0f)/
+       static_cast<float>(this->LocalGenerators.size()));
+    }
+}
+
 //----------------------------------------------------------------------------
 bool cmGlobalGenerator::ComputeTargetDepends()
 {
@@ -2460,6 +2600,7 @@ cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
                                   cmLocalGenerator::HOME_OUTPUT);
 
   // Associate the hash with this output.
+  cmWorkerPool::ModelLock lock;
   this->RuleHashes[fname] = hash;
 #else
   (void)outputs;
@@ -2467,6 +2608,49 @@ cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
 #endif
 }
 
+//----------------------------------------------------------------------------
+bool cmGlobalGenerator::GetRuleHash(const std::vector<std::string>& outputs,
+                                    std::string& fname, std::string& hash)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(outputs.empty())
+    {
+    return false;
+    }
+  cmLocalGenerator* lg = this->GetLocalGenerators()[0];
+  fname = lg->Convert(outputs[0].c_str(), cmLocalGenerator::HOME_OUTPUT);
+
+  cmWorkerPool::ModelLock lock;
+  std::map<cmStdString, RuleHash>::const_iterator rhi =
+    this->RuleHashes.find(fname);
+  if(rhi == this->RuleHashes.end())
+    {
+    return false;
+    }
+  hash.assign(rhi->second.Data, 32);
+  return true;
+#else
+  (void)outputs;
+  (void)fname;
+  (void)hash;
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmGlobalGenerator::AddRuleHash(std::string const& fname,
+                                    std::string const& hash)
+{
+  if(hash.size() != 32)
+    {
+    return;
+    }
+  RuleHash rh;
+  strncpy(rh.Data, hash.c_str(), 32);
+  cmWorkerPool::ModelLock lock;
+  this->RuleHashes[fname] = rh;
+}
+
 //----------------------------------------------------------------------------
 void cmGlobalGenerator::CheckRuleHashes()
 {
@@ -266,6 +266,14 @@ public:
   void AddRuleHash(const std::vector<std::string>& outputs,
                    std::string const& content);
 
+  /** Get the hash recorded for the rule with the given outputs along
+      with the name it is stored under, and add such a hash again.
+      Generators reusing files from a previous run use these to keep
+      the hashes of the rules in them.  */
+  bool GetRuleHash(const std::vector<std::string>& outputs,
+                   std::string& fname, std::string& hash);
+  void AddRuleHash(std::string const& fname, std::string const& hash);
+
   /** Return whether the given binary directory is unused.  */
   bool BinaryDirectoryIsNew(const char* dir)
     {
@@ -308,6 +316,12 @@ protected:
 
   virtual bool ComputeTargetDepends();
 
+  // Whether the local generators of this generator may write their
+  // build files concurrently.
+  virtual bool CanGenerateInParallel() const { return false; }
+  unsigned int GetGenerateThreads();
+  void GenerateInParallel(unsigned int threads);
+
   virtual bool CheckALLOW_DUPLICATE_CUSTOM_TARGETS();
 
   bool CheckTargets();
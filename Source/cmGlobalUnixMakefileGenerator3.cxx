@@ -18,6 +18,7 @@
 #include "cmSourceFile.h"
 #include "cmTarget.h"
 #include "cmGeneratorTarget.h"
+#include "cmWorkerPool.h"
 
 cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3()
 {
@@ -908,9 +909,20 @@ void
 cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   cmMakefileTargetGenerator* tg)
 {
-  TargetProgress& tp = this->ProgressMap[tg->GetTarget()];
-  tp.NumberOfActions = tg->GetNumberOfProgressActions();
-  tp.VariableFile = tg->GetProgressFileNameFull();
+  this->RecordTargetProgress(tg->GetTarget(),
+                             tg->GetNumberOfProgressActions(),
+                             tg->GetProgressFileNameFull());
+}
+
+//----------------------------------------------------------------------------
+void
+cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
+  cmTarget* target, unsigned long actions, std::string const& variableFile)
+{
+  cmWorkerPool::ModelLock lock;
+  TargetProgress& tp = this->ProgressMap[target];
+  tp.NumberOfActions = actions;
+  tp.VariableFile = variableFile;
 }
 
 //----------------------------------------------------------------------------
@@ -114,6 +114,8 @@ public:
 
   /** Record per-target progress information.  */
   void RecordTargetProgress(cmMakefileTargetGenerator* tg);
+  void RecordTargetProgress(cmTarget* target, unsigned long actions,
+                            std::string const& variableFile);
 
   void AddCXXCompileCommand(const std::string &sourceFile,
                             const std::string &workingDirectory,
@@ -154,6 +156,14 @@ protected:
 
   virtual bool CheckALLOW_DUPLICATE_CUSTOM_TARGETS() { return true; }
 
+  // Each directory writes its own files.  On Windows path lookups
+  // fill a cache that is not thread safe.
+#if defined(_WIN32)
+  virtual bool CanGenerateInParallel() const { return false; }
+#else
+  virtual bool CanGenerateInParallel() const { return true; }
+#endif
+
   // Some make programs (Borland) do not keep a rule if there are no
   // dependencies or commands.  This is a problem for creating rules
   // that might not do anything but might have other dependencies
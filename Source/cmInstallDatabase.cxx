@@ -0,0 +1,281 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmInstallDatabase.h"
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmCryptoHash.h"
+#endif
+#include "cmGeneratedFileStream.h"
+#include "cmSystemTools.h"
+
+#include <cmsys/Directory.hxx>
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#define cmInstallDatabase_HEADER "# CMake install database 3"
+
+//----------------------------------------------------------------------------
+// Times in nanoseconds do not fit a double or a long everywhere, so
+// numbers are written and read as 64-bit integers digit by digit.
+static std::string cmInstallDatabaseFormat(long long value)
+{
+  char digits[24];
+  char* c = digits + sizeof(digits);
+  *--c = 0;
+  unsigned long long u = static_cast<unsigned long long>(value);
+  if(value < 0)
+    {
+    u = 0 - u;
+    }
+  do
+    {
+    *--c = static_cast<char>('0' + u % 10);
+    u /= 10;
+    } while(u);
+  if(value < 0)
+    {
+    *--c = '-';
+    }
+  return c;
+}
+
+//----------------------------------------------------------------------------
+static const char* cmInstallDatabaseParse(const char* c, long long& value)
+{
+  while(*c == ' ')
+    {
+    ++c;
+    }
+  bool negative = *c == '-';
+  if(negative)
+    {
+    ++c;
+    }
+  unsigned long long u = 0;
+  for(; *c >= '0' && *c <= '9'; ++c)
+    {
+    u = u * 10 + static_cast<unsigned long long>(*c - '0');
+    }
+  value = static_cast<long long>(negative? 0 - u : u);
+  return c;
+}
+
+//----------------------------------------------------------------------------
+// Databases loaded by this process, deleted at exit.
+class cmInstallDatabaseRegistry
+{
+public:
+  ~cmInstallDatabaseRegistry()
+    {
+    for(std::map<cmStdString, cmInstallDatabase*>::iterator i =
+          this->Databases.begin(); i != this->Databases.end(); ++i)
+      {
+      delete i->second;
+      }
+    }
+  std::map<cmStdString, cmInstallDatabase*> Databases;
+};
+static cmInstallDatabaseRegistry cmInstallDatabaseLoaded;
+
+//----------------------------------------------------------------------------
+cmInstallDatabase* cmInstallDatabase::Get(std::string const& file)
+{
+  cmInstallDatabase*& db = cmInstallDatabaseLoaded.Databases[file];
+  if(!db)
+    {
+    db = new cmInstallDatabase(file);
+    db->Load();
+    }
+  return db;
+}
+
+//----------------------------------------------------------------------------
+cmInstallDatabase::cmInstallDatabase(std::string const& file): File(file)
+{
+}
+
+//----------------------------------------------------------------------------
+void cmInstallDatabase::Load()
+{
+  std::ifstream fin(this->File.c_str());
+  std::string line;
+  if(!fin || !cmSystemTools::GetLineFromStream(fin, line) ||
+     line != cmInstallDatabase_HEADER)
+    {
+    return;
+    }
+  // Each destination has a line with its type, octal mode, size, time,
+  // source time, hash and path, and a line with the path of its source.
+  std::string source;
+  while(cmSystemTools::GetLineFromStream(fin, line) &&
+        cmSystemTools::GetLineFromStream(fin, source))
+    {
+    const char* c = line.c_str();
+    char* end;
+    Entry entry;
+    entry.Type = *c++;
+    entry.Info.Mode = static_cast<mode_t>(strtoul(c, &end, 8));
+    long long size;
+    c = cmInstallDatabaseParse(end, size);
+    entry.Info.Size = static_cast<unsigned long long>(size);
+    c = cmInstallDatabaseParse(c, entry.Info.MTime);
+    c = cmInstallDatabaseParse(c, entry.SourceMTime);
+    std::string rest = c;
+    std::string::size_type hashStart = rest.find_first_not_of(' ');
+    std::string::size_type hashEnd = rest.find(' ', hashStart);
+    if(hashStart == std::string::npos || hashEnd == std::string::npos)
+      {
+      continue;
+      }
+    entry.Hash = rest.substr(hashStart, hashEnd - hashStart);
+    if(entry.Hash == "-")
+      {
+      entry.Hash = "";
+      }
+    entry.Source = source;
+    this->Entries[rest.substr(hashEnd + 1)] = entry;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmInstallDatabase::Lookup(std::string const& path, Entry& entry)
+{
+  cmWorkerPool::Lock lock(this->EntriesMutex);
+  std::map<cmStdString, Entry>::const_iterator i = this->Entries.find(path);
+  if(i == this->Entries.end())
+    {
+    return false;
+    }
+  entry = i->second;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmInstallDatabase::Store(std::string const& path, Entry const& entry)
+{
+  cmWorkerPool::Lock lock(this->EntriesMutex);
+  Entry& e = this->Entries[path];
+  e = entry;
+  e.Seen = true;
+}
+
+//----------------------------------------------------------------------------
+bool cmInstallDatabase::Save()
+{
+  cmWorkerPool::Lock lock(this->EntriesMutex);
+  cmGeneratedFileStream fout(this->File.c_str());
+  fout.SetCopyIfDifferent(true);
+  fout << cmInstallDatabase_HEADER << "\n";
+  for(std::map<cmStdString, Entry>::const_iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    Entry const& e = i->second;
+    if(i->first.find('\n') != std::string::npos ||
+       e.Source.find('\n') != std::string::npos)
+      {
+      continue;
+      }
+    char mode[32];
+    sprintf(mode, "%c %o ", e.Type, static_cast<unsigned int>(e.Info.Mode));
+    fout << mode
+         << cmInstallDatabaseFormat(static_cast<long long>(e.Info.Size))
+         << " " << cmInstallDatabaseFormat(e.Info.MTime)
+         << " " << cmInstallDatabaseFormat(e.SourceMTime)
+         << " " << (e.Hash.empty()? "-" : e.Hash.c_str())
+         << " " << i->first << "\n"
+         << e.Source << "\n";
+    }
+  // Close reports whether the file changed, not whether it was written.
+  bool okay = fout? true : false;
+  fout.Close();
+  return okay;
+}
+
+//----------------------------------------------------------------------------
+void cmInstallDatabase::Prune(std::string const& dir)
+{
+  cmWorkerPool::Lock lock(this->EntriesMutex);
+  std::string prefix = dir + "/";
+  std::vector<std::string> directories;
+  std::map<cmStdString, Entry>::iterator i =
+    this->Entries.lower_bound(prefix);
+  while(i != this->Entries.end() &&
+        i->first.compare(0, prefix.size(), prefix) == 0)
+    {
+    if(i->second.Seen)
+      {
+      ++i;
+      continue;
+      }
+    if(i->second.Type == 'd')
+      {
+      directories.push_back(i->first);
+      }
+    else
+      {
+      cmSystemTools::RemoveFile(i->first.c_str());
+      }
+    this->Entries.erase(i++);
+    }
+
+  // Remove directories deepest first, and only if they are empty.
+  for(std::vector<std::string>::reverse_iterator di = directories.rbegin();
+      di != directories.rend(); ++di)
+    {
+    cmsys::Directory d;
+    if(d.Load(di->c_str()) && d.GetNumberOfFiles() <= 2)
+      {
+      cmSystemTools::RemoveADirectory(di->c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmInstallDatabase::Stat(const char* file, FileInfo& info)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  struct _stat64 st;
+  if(_stat64(file, &st) != 0)
+    {
+    return false;
+    }
+  info.MTime = static_cast<long long>(st.st_mtime) * 1000000000;
+#else
+  struct stat st;
+  if(lstat(file, &st) != 0)
+    {
+    return false;
+    }
+# if cmsys_STAT_HAS_ST_MTIM
+  info.MTime = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000 +
+    st.st_mtim.tv_nsec;
+# else
+  info.MTime = static_cast<long long>(st.st_mtime) * 1000000000;
+# endif
+#endif
+  info.Size = static_cast<unsigned long long>(st.st_size);
+  info.Mode = static_cast<mode_t>(st.st_mode);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string cmInstallDatabase::HashFile(const char* file)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmCryptoHashMD5 md5;
+  return md5.HashFile(file);
+#else
+  (void)file;
+  return "";
+#endif
+}
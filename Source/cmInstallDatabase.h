@@ -0,0 +1,90 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmInstallDatabase_h
+#define cmInstallDatabase_h
+
+#include "cmStandardIncludes.h"
+
+#include "cmWorkerPool.h"
+
+/** \class cmInstallDatabase
+ * \brief Remember what an install wrote to skip unchanged files later.
+ *
+ * For each file installed the database records its size, modification
+ * time, permissions and MD5 hash, and the path and modification time of
+ * the file it was installed from.  A later install of the same source
+ * to the same destination is skipped when both still match, without
+ * reading either file.  A source rebuilt with the same contents is
+ * recognized by its hash and also not copied again.
+ *
+ * The database is loaded once per process and kept in memory until
+ * saved, so every file(INSTALL) of an install script shares it.  Its
+ * methods may be called from cmWorkerPool jobs.
+ */
+class cmInstallDatabase
+{
+public:
+  /** What a file looked like.  Times are in nanoseconds.  */
+  struct FileInfo
+  {
+    FileInfo(): Size(0), MTime(0), Mode(0) {}
+    unsigned long long Size;
+    long long MTime;
+    mode_t Mode;
+  };
+
+  /** What was installed at a destination.  */
+  struct Entry
+  {
+    Entry(): Type('f'), SourceMTime(0), Seen(false) {}
+    char Type; // 'f' file, 'l' symlink or 'd' directory
+    FileInfo Info;
+    std::string Source; // the file installed, empty if not a file
+    long long SourceMTime;
+    std::string Hash;
+    bool Seen;
+  };
+
+  /** Get the database stored in a file, loading it on first use.  */
+  static cmInstallDatabase* Get(std::string const& file);
+
+  /** Look up a destination.  Returns false if it is not known.  */
+  bool Lookup(std::string const& path, Entry& entry);
+
+  /** Record a destination as installed by this process.  */
+  void Store(std::string const& path, Entry const& entry);
+
+  /** Write the database to its file.  */
+  bool Save();
+
+  /** Remove the files and directories below a directory that the
+      database knows but that this process did not install, and forget
+      them.  */
+  void Prune(std::string const& dir);
+
+  /** Stat a file without following symlinks.  */
+  static bool Stat(const char* file, FileInfo& info);
+
+  /** Compute the hash stored for a file.  Empty when the hash is not
+      available, as in the bootstrap build.  */
+  static std::string HashFile(const char* file);
+
+private:
+  cmInstallDatabase(std::string const& file);
+  void Load();
+
+  std::string File;
+  std::map<cmStdString, Entry> Entries;
+  cmWorkerPool::Mutex EntriesMutex;
+};
+
+#endif
@@ -15,9 +15,14 @@
 #include "cmSystemTools.h"
 #include "cmMakefile.h"
 #include "cmVersion.h"
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmCryptoHash.h"
+#endif
 
 #include <cmsys/RegularExpression.hxx>
 
+#include <sys/stat.h>
+
 #ifdef __BORLANDC__
 # pragma warn -8060 /* possibly incorrect assignment */
 #endif
@@ -37,13 +42,14 @@ struct cmListFileParser
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
   enum { SeparationOkay, SeparationWarning } Separation;
+  bool IssuedWarning;
 };
 
 //----------------------------------------------------------------------------
 cmListFileParser::cmListFileParser(cmListFile* lf, cmMakefile* mf,
                                    const char* filename):
   ListFile(lf), Makefile(mf), FileName(filename),
-  Lexer(cmListFileLexer_New())
+  Lexer(cmListFileLexer_New()), IssuedWarning(false)
 {
 }
 
@@ -119,6 +125,441 @@ bool cmListFileParser::ParseFile()
   return true;
 }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+//----------------------------------------------------------------------------
+// Look up the functions parsed from a list file so that the lexer runs
+// only for files whose content has not been seen before.  Files read
+// earlier in the same cmake run are found in the cmListFileCache owned
+// by the cmake instance.  Otherwise the functions may be stored in the
+// build tree by an earlier configure run.  Each list file gets its own
+// cache file named after the hash of its path.  The entry records the
+// path, modification time, size and content hash of the file it was
+// parsed from.  An entry is valid if the file still has the same time
+// and size, or else the same content.  A file may be rewritten within
+// the resolution of its modification time without changing it, so the
+// time is recorded only for files that were old enough when read.
+// Files read soon after they were written are hashed every time.
+class cmListFileParseCache
+{
+public:
+  cmListFileParseCache(cmMakefile* mf, const char* filename);
+  bool Load(cmListFile* lf);
+  void Save(cmListFile const& lf);
+private:
+  typedef cmListFileCache::Stamp Stamp;
+  const char* FileName;
+  cmListFileCache* Memory;
+  std::string CacheFile;
+  Stamp FileStamp;
+  std::string ContentHash;
+  std::string const& GetContentHash();
+  bool ReadCacheFile(cmListFile* lf, bool& rewrite);
+  void WriteCacheFile(cmListFile const& lf);
+  static bool GetStamp(const char* file, Stamp& stamp);
+
+  // Raw buffer decoding.
+  struct Reader
+  {
+    const char* Cur;
+    const char* End;
+    bool ReadUInt(unsigned long& v);
+    bool ReadUInt64(unsigned long long& v);
+    bool ReadString(std::string& s);
+  };
+  static void WriteUInt(std::string& out, unsigned long v);
+  static void WriteUInt64(std::string& out, unsigned long long v);
+  static void WriteString(std::string& out, std::string const& s);
+  static std::string Magic();
+};
+
+//----------------------------------------------------------------------------
+cmListFileParseCache::cmListFileParseCache(cmMakefile* mf,
+                                           const char* filename):
+  FileName(filename), Memory(0)
+{
+  cmake* cm = mf? mf->GetCMakeInstance() : 0;
+  if(!cm)
+    {
+    return;
+    }
+  this->Memory = cm->GetListFileCache();
+
+  // Store files only while configuring a real build tree.  Script
+  // mode, try_compile projects and ctest scripts do not own a build
+  // tree worth populating.
+  if(cm->GetWorkingMode() != cmake::NORMAL_MODE ||
+     cm->GetIsInTryCompile() || !cm->GetGlobalGenerator())
+    {
+    return;
+    }
+  const char* home = cm->GetHomeOutputDirectory();
+  if(!home || !*home)
+    {
+    return;
+    }
+  cmCryptoHashMD5 md5;
+  this->CacheFile = home;
+  this->CacheFile += cmake::GetCMakeFilesDirectory();
+  this->CacheFile += "/ListFileParseCache/";
+  this->CacheFile += md5.HashString(filename);
+  this->CacheFile += ".bin";
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileParseCache::GetStamp(const char* file, Stamp& stamp)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  struct _stat64 st;
+  if(_stat64(file, &st) != 0)
+    {
+    return false;
+    }
+  stamp.MTime = static_cast<long long>(st.st_mtime) * 1000000000;
+#else
+  struct stat st;
+  if(stat(file, &st) != 0)
+    {
+    return false;
+    }
+# if cmsys_STAT_HAS_ST_MTIM
+  stamp.MTime = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000 +
+    st.st_mtim.tv_nsec;
+# else
+  stamp.MTime = static_cast<long long>(st.st_mtime) * 1000000000;
+# endif
+#endif
+  stamp.Size = static_cast<unsigned long long>(st.st_size);
+
+  // A file written less than two seconds ago may be written again
+  // without a change of its time on file systems that store it with a
+  // coarse resolution.  Do not trust the time of such a file.
+  double now = cmSystemTools::GetTime();
+  if(static_cast<double>(stamp.MTime) / 1e9 > now - 2)
+    {
+    stamp.MTime = 0;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string const& cmListFileParseCache::GetContentHash()
+{
+  if(this->ContentHash.empty())
+    {
+    this->ContentHash = cmCryptoHashMD5().HashFile(this->FileName);
+    if(this->Memory)
+      {
+      this->Memory->CountHashed();
+      }
+    }
+  return this->ContentHash;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileParseCache::Load(cmListFile* lf)
+{
+  if(!this->Memory && this->CacheFile.empty())
+    {
+    return false;
+    }
+  if(!GetStamp(this->FileName, this->FileStamp))
+    {
+    return false;
+    }
+
+  // Use an entry with the same time and size without reading the file.
+  // The time of a file written recently tells nothing, so look for one
+  // with the same content instead.
+  if(this->Memory)
+    {
+    if(!this->FileStamp.MTime && this->GetContentHash().empty())
+      {
+      return false;
+      }
+    if(this->Memory->Find(this->FileName, this->FileStamp,
+                          this->ContentHash, lf))
+      {
+      return true;
+      }
+    }
+  bool rewrite = false;
+  if(this->ReadCacheFile(lf, rewrite))
+    {
+    if(rewrite)
+      {
+      // Record the time of a file that is old enough now so that the
+      // next run need not hash it.
+      this->WriteCacheFile(*lf);
+      }
+    if(this->Memory)
+      {
+      this->Memory->Insert(this->FileName, this->FileStamp,
+                           this->ContentHash, *lf);
+      }
+    return true;
+    }
+
+  // Hash the file before it is parsed for Save.
+  this->GetContentHash();
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileParseCache::Save(cmListFile const& lf)
+{
+  // The hash was computed by Load before the file was parsed.
+  if(this->ContentHash.empty())
+    {
+    return;
+    }
+  if(this->Memory)
+    {
+    this->Memory->Insert(this->FileName, this->FileStamp,
+                         this->ContentHash, lf);
+    }
+  this->WriteCacheFile(lf);
+}
+
+//----------------------------------------------------------------------------
+std::string cmListFileParseCache::Magic()
+{
+  // Entries written by another version of CMake are never used.
+  std::string magic = "CMLFPC2 ";
+  magic += cmVersion::GetCMakeVersion();
+  return magic;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileParseCache::WriteUInt(std::string& out, unsigned long v)
+{
+  char buf[4];
+  buf[0] = static_cast<char>(v & 0xFF);
+  buf[1] = static_cast<char>((v >> 8) & 0xFF);
+  buf[2] = static_cast<char>((v >> 16) & 0xFF);
+  buf[3] = static_cast<char>((v >> 24) & 0xFF);
+  out.append(buf, 4);
+}
+
+//----------------------------------------------------------------------------
+void cmListFileParseCache::WriteUInt64(std::string& out,
+                                       unsigned long long v)
+{
+  WriteUInt(out, static_cast<unsigned long>(v & 0xFFFFFFFF));
+  WriteUInt(out, static_cast<unsigned long>(v >> 32));
+}
+
+//----------------------------------------------------------------------------
+void cmListFileParseCache::WriteString(std::string& out,
+                                       std::string const& s)
+{
+  WriteUInt(out, static_cast<unsigned long>(s.size()));
+  out += s;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileParseCache::Reader::ReadUInt(unsigned long& v)
+{
+  if(this->End - this->Cur < 4)
+    {
+    return false;
+    }
+  unsigned char const* c =
+    reinterpret_cast<unsigned char const*>(this->Cur);
+  v = (static_cast<unsigned long>(c[0]) |
+       static_cast<unsigned long>(c[1]) << 8 |
+       static_cast<unsigned long>(c[2]) << 16 |
+       static_cast<unsigned long>(c[3]) << 24);
+  this->Cur += 4;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileParseCache::Reader::ReadUInt64(unsigned long long& v)
+{
+  unsigned long low;
+  unsigned long high;
+  if(!this->ReadUInt(low) || !this->ReadUInt(high))
+    {
+    return false;
+    }
+  v = static_cast<unsigned long long>(high) << 32 | low;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileParseCache::Reader::ReadString(std::string& s)
+{
+  unsigned long n;
+  if(!this->ReadUInt(n) ||
+     static_cast<unsigned long>(this->End - this->Cur) < n)
+    {
+    return false;
+    }
+  s.assign(this->Cur, n);
+  this->Cur += n;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileParseCache::ReadCacheFile(cmListFile* lf, bool& rewrite)
+{
+  if(this->CacheFile.empty())
+    {
+    return false;
+    }
+
+  // Read the whole entry at once and decode it from memory.
+  std::vector<char> data;
+  {
+  std::ifstream fin(this->CacheFile.c_str(),
+                    std::ios::in | cmsys_ios_binary);
+  if(!fin)
+    {
+    return false;
+    }
+  char buf[16384];
+  while(fin)
+    {
+    fin.read(buf, sizeof(buf));
+    data.insert(data.end(), buf, buf + fin.gcount());
+    }
+  }
+  if(data.empty())
+    {
+    return false;
+    }
+  Reader r;
+  r.Cur = &*data.begin();
+  r.End = r.Cur + data.size();
+
+  std::string magic;
+  std::string path;
+  std::string hash;
+  unsigned long long mtime;
+  Stamp stamp;
+  unsigned long nfuncs;
+  if(!r.ReadString(magic) || magic != Magic() ||
+     !r.ReadString(path) || path != this->FileName ||
+     !r.ReadUInt64(mtime) || !r.ReadUInt64(stamp.Size) ||
+     !r.ReadString(hash))
+    {
+    return false;
+    }
+  stamp.MTime = static_cast<long long>(mtime);
+  if(stamp.Matches(this->FileStamp))
+    {
+    this->ContentHash = hash;
+    }
+  else if(hash != this->GetContentHash())
+    {
+    return false;
+    }
+  else
+    {
+    rewrite = this->FileStamp.MTime != 0;
+    }
+  if(!r.ReadUInt(nfuncs) ||
+     static_cast<unsigned long>(r.End - r.Cur) < nfuncs)
+    {
+    return false;
+    }
+
+  std::vector<cmListFileFunction> functions(nfuncs);
+  for(std::vector<cmListFileFunction>::iterator fi = functions.begin();
+      fi != functions.end(); ++fi)
+    {
+    unsigned long line;
+    unsigned long nargs;
+    if(!r.ReadString(fi->Name) || !r.ReadUInt(line) || !r.ReadUInt(nargs) ||
+       static_cast<unsigned long>(r.End - r.Cur) < nargs)
+      {
+      return false;
+      }
+    fi->FilePath = this->FileName;
+    fi->Line = static_cast<long>(line);
+    fi->Arguments.resize(nargs);
+    for(std::vector<cmListFileArgument>::iterator ai =
+          fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+      {
+      unsigned long delim;
+      if(!r.ReadString(ai->Value) || !r.ReadUInt(delim) ||
+         !r.ReadUInt(line))
+        {
+        return false;
+        }
+      ai->Delim = delim? cmListFileArgument::Quoted :
+        cmListFileArgument::Unquoted;
+      ai->FilePath = this->FileName;
+      ai->Line = static_cast<long>(line);
+      }
+    }
+  if(r.Cur != r.End)
+    {
+    return false;
+    }
+  lf->Functions.swap(functions);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileParseCache::WriteCacheFile(cmListFile const& lf)
+{
+  if(this->CacheFile.empty())
+    {
+    return;
+    }
+  std::string out;
+  WriteString(out, Magic());
+  WriteString(out, this->FileName);
+  WriteUInt64(out, static_cast<unsigned long long>(this->FileStamp.MTime));
+  WriteUInt64(out, this->FileStamp.Size);
+  WriteString(out, this->ContentHash);
+  WriteUInt(out, static_cast<unsigned long>(lf.Functions.size()));
+  for(std::vector<cmListFileFunction>::const_iterator fi =
+        lf.Functions.begin(); fi != lf.Functions.end(); ++fi)
+    {
+    WriteString(out, fi->Name);
+    WriteUInt(out, static_cast<unsigned long>(fi->Line));
+    WriteUInt(out, static_cast<unsigned long>(fi->Arguments.size()));
+    for(std::vector<cmListFileArgument>::const_iterator ai =
+          fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+      {
+      WriteString(out, ai->Value);
+      WriteUInt(out, ai->Delim == cmListFileArgument::Quoted? 1 : 0);
+      WriteUInt(out, static_cast<unsigned long>(ai->Line));
+      }
+    }
+
+  // Write to a temporary file and rename it into place so that a
+  // concurrent or interrupted run never sees a partial entry.
+  std::string dir = cmSystemTools::GetFilenamePath(this->CacheFile);
+  if(!cmSystemTools::MakeDirectory(dir.c_str()))
+    {
+    return;
+    }
+  std::string tmp = this->CacheFile;
+  tmp += ".tmp";
+  {
+  std::ofstream fout(tmp.c_str(), std::ios::out | cmsys_ios_binary);
+  if(!fout)
+    {
+    return;
+    }
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  if(!fout)
+    {
+    fout.close();
+    cmSystemTools::RemoveFile(tmp.c_str());
+    return;
+    }
+  }
+  if(!cmSystemTools::RenameFile(tmp.c_str(), this->CacheFile.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmp.c_str());
+    }
+}
+#endif
+
 //----------------------------------------------------------------------------
 bool cmListFile::ParseFile(const char* filename,
                            bool topLevel,
@@ -132,9 +573,21 @@ bool cmListFile::ParseFile(const char* filename,
   bool parseError = false;
   this->ModifiedTime = cmSystemTools::ModifiedTime(filename);
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmListFileParseCache parseCache(mf, filename);
+  if(!parseCache.Load(this))
+#endif
   {
   cmListFileParser parser(this, mf, filename);
   parseError = !parser.ParseFile();
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Warnings are issued only while lexing, so cache only files that
+  // produce none.  A cached file must behave exactly like a parsed one.
+  if(!parseError && !parser.IssuedWarning)
+    {
+    parseCache.Save(*this);
+    }
+#endif
   }
 
   if(parseError)
@@ -361,6 +814,7 @@ void cmListFileParser::AddArgument(cmListFileLexer_Token* token,
           << "  " << a.Value << "\n"
           << "as an opening long bracket.  Double-quote the argument.";
         this->Makefile->IssueMessage(cmake::AUTHOR_WARNING, m.str().c_str());
+        this->IssuedWarning = true;
         }
       }
     }
@@ -374,6 +828,48 @@ void cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     << token->column << "\n"
     << "Argument not separated from preceding token by whitespace.";
   this->Makefile->IssueMessage(cmake::AUTHOR_WARNING, m.str().c_str());
+  this->IssuedWarning = true;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileCache::Find(const char* path, Stamp const& stamp,
+                           std::string const& hash, cmListFile* lf)
+{
+  EntryMap::const_iterator i = this->Entries.find(path);
+  if(i == this->Entries.end() ||
+     !(i->second.FileStamp.Matches(stamp) ||
+       (!hash.empty() && i->second.Hash == hash)))
+    {
+    ++this->Misses;
+    return false;
+    }
+  ++this->Hits;
+  this->BytesSaved += stamp.Size;
+  lf->Functions = i->second.Functions;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileCache::Insert(const char* path, Stamp const& stamp,
+                             std::string const& hash, cmListFile const& lf)
+{
+  Entry& e = this->Entries[path];
+  e.Hash = hash;
+  e.FileStamp = stamp;
+  e.Functions = lf.Functions;
+
+  // The arguments refer to the file path by pointer.  Make them refer
+  // to the key of the entry which lives as long as this cache.
+  const char* key = this->Entries.find(path)->first.c_str();
+  for(std::vector<cmListFileFunction>::iterator fi = e.Functions.begin();
+      fi != e.Functions.end(); ++fi)
+    {
+    for(std::vector<cmListFileArgument>::iterator ai =
+          fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+      {
+      ai->FilePath = key;
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
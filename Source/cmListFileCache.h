@@ -14,13 +14,6 @@
 
 #include "cmStandardIncludes.h"
 
-/** \class cmListFileCache
- * \brief A class to cache list file contents.
- *
- * cmListFileCache is a class used to cache the contents of parsed
- * cmake list files.
- */
-
 class cmMakefile;
 
 struct cmListFileArgument
@@ -81,6 +74,67 @@ struct cmListFile
   std::vector<cmListFileFunction> Functions;
 };
 
+/** \class cmListFileCache
+ * \brief A class to cache list file contents.
+ *
+ * cmListFileCache is a class used to cache the contents of parsed
+ * cmake list files for the duration of one cmake run.  Modules that
+ * are included from many directories are then parsed only once.
+ * Entries are keyed by the file path and either the modification time
+ * and size or a hash of its content, so a file rewritten during the
+ * run is parsed again.
+ */
+class cmListFileCache
+{
+public:
+  cmListFileCache(): Hits(0), Misses(0), BytesSaved(0), Hashed(0) {}
+
+  /** The modification time in nanoseconds and the size of a file.  A
+      time of 0 is not known and matches nothing.  */
+  struct Stamp
+  {
+    Stamp(): MTime(0), Size(0) {}
+    long long MTime;
+    unsigned long long Size;
+    bool Matches(Stamp const& r) const
+      { return this->MTime && this->MTime == r.MTime &&
+          this->Size == r.Size; }
+  };
+
+  /** Copy the functions cached for the given file into the list file
+      if the entry has the given stamp or, unless empty, content hash.
+      Returns false if there is no such entry.  */
+  bool Find(const char* path, Stamp const& stamp, std::string const& hash,
+            cmListFile* lf);
+
+  /** Store the functions parsed from the given file.  */
+  void Insert(const char* path, Stamp const& stamp, std::string const& hash,
+              cmListFile const& lf);
+
+  /** Count a list file whose content had to be hashed.  */
+  void CountHashed() { ++this->Hashed; }
+
+  /** Statistics about the lookups done so far.  */
+  unsigned long GetHits() const { return this->Hits; }
+  unsigned long GetMisses() const { return this->Misses; }
+  unsigned long long GetBytesSaved() const { return this->BytesSaved; }
+  unsigned long GetHashed() const { return this->Hashed; }
+
+private:
+  struct Entry
+  {
+    std::string Hash;
+    Stamp FileStamp;
+    std::vector<cmListFileFunction> Functions;
+  };
+  typedef std::map<cmStdString, Entry> EntryMap;
+  EntryMap Entries;
+  unsigned long Hits;
+  unsigned long Misses;
+  unsigned long long BytesSaved;
+  unsigned long Hashed;
+};
+
 struct cmValueWithOrigin {
   cmValueWithOrigin(const std::string &value,
                           const cmListFileBacktrace &bt)
@@ -451,6 +451,18 @@ void cmLocalGenerator::GenerateInstallRules()
     "ENDIF(NOT CMAKE_INSTALL_COMPONENT)\n"
     "\n";
 
+  // Remember installed files in the build tree.
+  if ( toplevel_install )
+    {
+    fout <<
+      "# Set the database of installed files.\n"
+      "IF(NOT DEFINED CMAKE_INSTALL_DATABASE)\n"
+      "  SET(CMAKE_INSTALL_DATABASE \""
+         << homedir << "/install_database.txt\")\n"
+      "ENDIF(NOT DEFINED CMAKE_INSTALL_DATABASE)\n"
+      "\n";
+    }
+
   // Copy user-specified install options to the install code.
   if(const char* so_no_exe =
      this->Makefile->GetDefinition("CMAKE_INSTALL_SO_NO_EXE"))
@@ -516,6 +528,12 @@ void cmLocalGenerator::GenerateInstallRules()
       << homedir.c_str() << "/${CMAKE_INSTALL_MANIFEST}\" "
       << "\"${file}\\n\")" << std::endl
       << "ENDFOREACH(file)" << std::endl;
+
+    // Save what was installed to skip unchanged files next time.
+    fout << "\n"
+      << "IF(CMAKE_INSTALL_DATABASE)\n"
+      << "  FILE(INSTALL_DATABASE \"${CMAKE_INSTALL_DATABASE}\")\n"
+      << "ENDIF(CMAKE_INSTALL_DATABASE)\n";
     }
 }
 
@@ -21,6 +21,7 @@ class cmTarget;
 class cmTargetManifest;
 class cmSourceFile;
 class cmCustomCommand;
+class cmDirectoryFingerprint;
 
 /** \class cmLocalGenerator
  * \brief Create required build files for a directory.
@@ -53,6 +54,12 @@ public:
 
   virtual void AddHelperCommands() {}
 
+  /**
+   * Record what the files generated for this directory depend on.
+   * Called for all directories before any of them generates.
+   */
+  virtual void ComputeInputFingerprint(cmDirectoryFingerprint&) {}
+
   /**
    * Perform any final calculations prior to generation
    */
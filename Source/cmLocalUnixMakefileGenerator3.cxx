@@ -20,6 +20,7 @@
 #include "cmVersion.h"
 #include "cmFileTimeComparison.h"
 #include "cmCustomCommandGenerator.h"
+#include "cmWorkerPool.h"
 
 // Include dependency scanners for supported languages.  Only the
 // C/C++ scanner is needed for bootstrapping CMake.
@@ -27,6 +28,7 @@
 #ifdef CMAKE_BUILD_WITH_CMAKE
 # include "cmDependsFortran.h"
 # include "cmDependsJava.h"
+# include "cmDirectoryFingerprint.h"
 # include <cmsys/Terminal.h>
 #endif
 
@@ -144,10 +146,26 @@ void cmLocalUnixMakefileGenerator3::Generate()
   this->SkipAssemblySourceRules =
     this->Makefile->IsOn("CMAKE_SKIP_ASSEMBLY_SOURCE_RULES");
 
+  // Keep the files generated by a previous run with the same inputs.
+  if(this->ReuseGeneratedFiles())
+    {
+    return;
+    }
+
+  // Messages and errors reported while generating would not be
+  // repeated by a run reusing the files, so such a run must generate
+  // them again.  Any message counts, not only diagnostics with context.
+  unsigned long messages;
+  {
+  cmWorkerPool::ModelLock lock;
+  messages = cmSystemTools::GetNumberOfMessages();
+  }
+
   // Generate the rule files for each target.
   cmTargets& targets = this->Makefile->GetTargets();
   cmGlobalUnixMakefileGenerator3* gg =
     static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
+  TargetProgressMap progress;
   for(cmTargets::iterator t = targets.begin(); t != targets.end(); ++t)
     {
     cmsys::auto_ptr<cmMakefileTargetGenerator> tg(
@@ -156,6 +174,7 @@ void cmLocalUnixMakefileGenerator3::Generate()
       {
       tg->WriteRuleFiles();
       gg->RecordTargetProgress(tg.get());
+      progress[t->second.GetName()] = tg->GetNumberOfProgressActions();
       }
     }
 
@@ -164,6 +183,250 @@ void cmLocalUnixMakefileGenerator3::Generate()
 
   // Write the cmake file with information for this directory.
   this->WriteDirectoryInformationFile();
+
+  {
+  cmWorkerPool::ModelLock lock;
+  if(cmSystemTools::GetNumberOfMessages() != messages ||
+     cmSystemTools::GetErrorOccuredFlag())
+    {
+    this->InputFingerprint = "";
+    }
+  }
+  this->WriteInputFingerprint(progress);
+}
+
+//----------------------------------------------------------------------------
+void cmLocalUnixMakefileGenerator3
+::ComputeInputFingerprint(cmDirectoryFingerprint& fingerprint)
+{
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  // The top directory lists the targets of all directories and
+  // compile commands are collected only while generating, so these
+  // generate every time.
+  if(!this->Parent ||
+     this->GlobalGenerator->GetCMakeInstance()->GetIsInTryCompile() ||
+     this->Makefile->IsOn("CMAKE_EXPORT_COMPILE_COMMANDS"))
+    {
+    return;
+    }
+
+  // The project may ask for every directory to generate.
+  if(this->Makefile->IsOn("CMAKE_SKIP_INCREMENTAL_GENERATE"))
+    {
+    return;
+    }
+
+  // Bundles get files written into them while generating.
+  cmTargets& targets = this->Makefile->GetTargets();
+  for(cmTargets::iterator t = targets.begin(); t != targets.end(); ++t)
+    {
+    if(t->second.IsAppBundleOnApple() ||
+       t->second.IsCFBundleOnApple() ||
+       t->second.IsFrameworkOnApple())
+      {
+      return;
+      }
+    }
+  this->InputFingerprint = fingerprint.Compute(this);
+#else
+  (void)fingerprint;
+#endif
+}
+
+//----------------------------------------------------------------------------
+std::string cmLocalUnixMakefileGenerator3::GetInputFingerprintFile()
+{
+  std::string fname = this->Makefile->GetStartOutputDirectory();
+  fname += cmake::GetCMakeFilesDirectory();
+  fname += "/CMakeDirectoryFingerprint.txt";
+  return fname;
+}
+
+//----------------------------------------------------------------------------
+bool cmLocalUnixMakefileGenerator3::ReuseGeneratedFiles()
+{
+  // The first line holds the fingerprint.  It is followed by lines
+  // with the number of progress actions of each target and lines with
+  // the hashes of the custom command rules.
+  std::string fname = this->GetInputFingerprintFile();
+  bool current = false;
+  TargetProgressMap progress;
+  std::map<cmStdString, cmStdString> ruleHashes;
+  {
+  std::ifstream fin(fname.c_str());
+  std::string line;
+  if(!this->InputFingerprint.empty() && fin &&
+     cmSystemTools::GetLineFromStream(fin, line) &&
+     line == this->InputFingerprint)
+    {
+    current = true;
+    while(current && cmSystemTools::GetLineFromStream(fin, line))
+      {
+      std::string::size_type pos1 = line.find(' ');
+      std::string::size_type pos2 =
+        pos1 == line.npos? line.npos : line.find(' ', pos1+1);
+      if(pos2 == line.npos)
+        {
+        current = false;
+        }
+      else if(line.compare(0, pos1, "target") == 0)
+        {
+        progress[line.substr(pos2+1)] =
+          strtoul(line.c_str()+pos1+1, 0, 10);
+        }
+      else if(line.compare(0, pos1, "rule") == 0)
+        {
+        ruleHashes[line.substr(pos2+1)] =
+          line.substr(pos1+1, pos2-pos1-1);
+        }
+      }
+    }
+  }
+  if(!current)
+    {
+    // Drop the old fingerprint before the files change in case
+    // generating does not finish.
+    cmSystemTools::RemoveFile(fname.c_str());
+    return false;
+    }
+
+  // The files must still be there.
+  std::string dir = this->Makefile->GetStartOutputDirectory();
+  if(!cmSystemTools::FileExists((dir + "/Makefile").c_str()) ||
+     !cmSystemTools::FileExists((dir + cmake::GetCMakeFilesDirectory() +
+                                 "/CMakeDirectoryInformation.cmake").c_str()))
+    {
+    return false;
+    }
+  std::vector<std::pair<cmTarget*, std::string> > targetDirs;
+  cmTargets& targets = this->Makefile->GetTargets();
+  for(cmTargets::iterator t = targets.begin(); t != targets.end(); ++t)
+    {
+    switch(t->second.GetType())
+      {
+      case cmTarget::EXECUTABLE:
+      case cmTarget::STATIC_LIBRARY:
+      case cmTarget::SHARED_LIBRARY:
+      case cmTarget::MODULE_LIBRARY:
+      case cmTarget::OBJECT_LIBRARY:
+      case cmTarget::UTILITY:
+        break;
+      default:
+        continue;
+      }
+    std::string tdir =
+      this->ConvertToFullPath(this->GetTargetDirectory(t->second));
+    if(progress.find(t->second.GetName()) == progress.end() ||
+       !cmSystemTools::FileExists((tdir + "/build.make").c_str()))
+      {
+      return false;
+      }
+    targetDirs.push_back(std::make_pair(&t->second, tdir));
+    }
+
+  // Record what generating would have and create the directories it
+  // would have created.
+  cmGlobalUnixMakefileGenerator3* gg =
+    static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
+  for(std::vector<std::pair<cmTarget*, std::string> >::const_iterator
+        ti = targetDirs.begin(); ti != targetDirs.end(); ++ti)
+    {
+    gg->RecordTargetProgress(ti->first, progress[ti->first->GetName()],
+                             ti->second + "/progress.make");
+    this->CreateTargetOutputDirectories(*ti->first);
+    }
+  for(std::map<cmStdString, cmStdString>::const_iterator
+        ri = ruleHashes.begin(); ri != ruleHashes.end(); ++ri)
+    {
+    gg->AddRuleHash(ri->first, ri->second);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmLocalUnixMakefileGenerator3::CreateTargetOutputDirectories(
+  cmTarget& target)
+{
+  const char* config = this->ConfigurationName.c_str();
+  switch(target.GetType())
+    {
+    case cmTarget::EXECUTABLE:
+    case cmTarget::STATIC_LIBRARY:
+    case cmTarget::SHARED_LIBRARY:
+    case cmTarget::MODULE_LIBRARY:
+      cmSystemTools::MakeDirectory(target.GetDirectory(config).c_str());
+      if(target.HasImportLibrary())
+        {
+        cmSystemTools::MakeDirectory(
+          target.GetDirectory(config, true).c_str());
+        }
+      cmSystemTools::MakeDirectory(target.GetPDBDirectory(config).c_str());
+      break;
+    default:
+      break;
+    }
+
+  // Compiling Fortran sources also needs the module directory.
+  const char* modDir = target.GetProperty("Fortran_MODULE_DIRECTORY");
+  if(modDir && this->Makefile->GetDefinition("CMAKE_Fortran_MODDIR_FLAG"))
+    {
+    std::string dir = modDir;
+    if(!cmSystemTools::FileIsFullPath(modDir))
+      {
+      dir = this->Makefile->GetCurrentOutputDirectory();
+      dir += "/";
+      dir += modDir;
+      }
+    cmSystemTools::MakeDirectory(dir.c_str());
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmLocalUnixMakefileGenerator3
+::WriteInputFingerprint(TargetProgressMap const& progress)
+{
+  if(this->InputFingerprint.empty())
+    {
+    return;
+    }
+  cmGeneratedFileStream fout(this->GetInputFingerprintFile().c_str());
+  fout << this->InputFingerprint << "\n";
+  for(TargetProgressMap::const_iterator pi = progress.begin();
+      pi != progress.end(); ++pi)
+    {
+    fout << "target " << pi->second << " " << pi->first << "\n";
+    }
+
+  // The rule hashes of custom commands are not kept across runs for
+  // outputs that do not exist, so keep those of this directory here.
+  std::map<cmStdString, cmStdString> ruleHashes;
+  cmTargets& targets = this->Makefile->GetTargets();
+  for(cmTargets::iterator t = targets.begin(); t != targets.end(); ++t)
+    {
+    if(progress.find(t->second.GetName()) == progress.end())
+      {
+      continue;
+      }
+    cmGeneratorTarget* gt =
+      this->GlobalGenerator->GetGeneratorTarget(&t->second);
+    for(std::vector<cmSourceFile*>::const_iterator
+          si = gt->CustomCommands.begin();
+        si != gt->CustomCommands.end(); ++si)
+      {
+      std::string fname;
+      std::string hash;
+      if(this->GlobalGenerator->GetRuleHash(
+           (*si)->GetCustomCommand()->GetOutputs(), fname, hash))
+        {
+        ruleHashes[fname] = hash;
+        }
+      }
+    }
+  for(std::map<cmStdString, cmStdString>::const_iterator
+        ri = ruleHashes.begin(); ri != ruleHashes.end(); ++ri)
+    {
+    fout << "rule " << ri->second << " " << ri->first << "\n";
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -47,6 +47,12 @@ public:
    */
   virtual void Generate();
 
+  /**
+   * Fingerprint the inputs of the files generated for this directory
+   * so that they can be reused by a later run with the same inputs.
+   */
+  virtual void ComputeInputFingerprint(cmDirectoryFingerprint& fingerprint);
+
 
   // this returns the relative path between the HomeOutputDirectory and this
   // local generators StartOutputDirectory
@@ -376,6 +382,17 @@ private:
 
   std::vector<cmStdString> LocalHelp;
 
+  // Fingerprint of the inputs of this directory.  When the files
+  // generated by a previous run with the same fingerprint are still
+  // present they are kept instead of being generated again.  Empty if
+  // this directory always generates.
+  std::string InputFingerprint;
+  typedef std::map<cmStdString, unsigned long> TargetProgressMap;
+  std::string GetInputFingerprintFile();
+  bool ReuseGeneratedFiles();
+  void CreateTargetOutputDirectories(cmTarget& target);
+  void WriteInputFingerprint(TargetProgressMap const& progress);
+
   /* does the work for each target */
   std::map<cmStdString, cmStdString> MakeVariableMap;
   std::map<cmStdString, cmStdString> ShortMakeVariableMap;
@@ -33,6 +33,8 @@
 #include "cmTestGenerator.h"
 #include "cmDefinitions.h"
 #include "cmake.h"
+#include "cmWorkerPool.h"
+#include "cmMakefileProfilingData.h"
 #include <stdlib.h> // required for atoi
 
 #include <cmsys/RegularExpression.hxx>
@@ -395,6 +397,11 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   cmMakefileCall stack_manager(this, lff, status);
   static_cast<void>(stack_manager);
 
+  // Time the call when profiling.
+  cmMakefileProfilingData::Scope profilingScope(
+    this->GetCMakeInstance()->GetProfilingOutput(), lff);
+  static_cast<void>(profilingScope);
+
   // Lookup the command prototype.
   if(cmCommand* proto = this->GetCMakeInstance()->GetCommand(name.c_str()))
     {
@@ -664,6 +671,10 @@ bool cmMakefile::ReadListFile(const char* filename_in,
     {
     *fullPath=filenametoread;
     }
+  // Time reading the file when profiling.
+  cmMakefileProfilingData::Scope profilingScope(
+    this->GetCMakeInstance()->GetProfilingOutput(), filenametoread);
+  static_cast<void>(profilingScope);
   cmListFile cacheFile;
   if( !cacheFile.ParseFile(filenametoread, requireProjectCommand, this) )
     {
@@ -2443,6 +2454,16 @@ bool cmMakefile::IsDefinitionSet(const char* name) const
   return def?true:false;
 }
 
+const char* cmMakefile::PeekDefinition(const char* name) const
+{
+  const char* def = this->Internal->VarStack.top().Get(name);
+  if(!def)
+    {
+    def = this->GetCacheManager()->GetCacheValue(name);
+    }
+  return def;
+}
+
 const char* cmMakefile::GetDefinition(const char* name) const
 {
 #ifdef CMAKE_STRICT
@@ -3700,21 +3721,21 @@ const char *cmMakefile::GetProperty(const char* prop,
     {
     return 0;
     }
+  cmWorkerPool::ModelLock lock;
   // watch for specific properties
-  static std::string output;
-  output = "";
+  std::string output;
   if (!strcmp("PARENT_DIRECTORY",prop))
     {
     if(cmLocalGenerator* plg = this->LocalGenerator->GetParent())
       {
       output = plg->GetMakefile()->GetStartDirectory();
       }
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("INCLUDE_REGULAR_EXPRESSION",prop) )
     {
     output = this->GetIncludeRegularExpression();
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("LISTFILE_STACK",prop))
     {
@@ -3727,7 +3748,7 @@ const char *cmMakefile::GetProperty(const char* prop,
         }
       output += *i;
       }
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("VARIABLES",prop) || !strcmp("CACHE_VARIABLES",prop))
     {
@@ -3745,17 +3766,17 @@ const char *cmMakefile::GetProperty(const char* prop,
         }
       output += vars[cc];
       }
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("MACROS",prop))
     {
     this->GetListOfMacros(output);
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("DEFINITIONS",prop))
     {
     output += this->DefineFlagsOrig;
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("LINK_DIRECTORIES",prop))
     {
@@ -3772,7 +3793,7 @@ const char *cmMakefile::GetProperty(const char* prop,
       str << it->c_str();
       }
     output = str.str();
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("INCLUDE_DIRECTORIES",prop))
     {
@@ -3786,7 +3807,7 @@ const char *cmMakefile::GetProperty(const char* prop,
       output += it->Value;
       sep = ";";
       }
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("COMPILE_OPTIONS",prop))
     {
@@ -3800,7 +3821,7 @@ const char *cmMakefile::GetProperty(const char* prop,
       output += it->Value;
       sep = ";";
       }
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
   else if (!strcmp("COMPILE_DEFINITIONS",prop))
     {
@@ -3814,7 +3835,7 @@ const char *cmMakefile::GetProperty(const char* prop,
       output += it->Value;
       sep = ";";
       }
-    return output.c_str();
+    return this->KeepComputedProperty(prop, output);
     }
 
   bool chain = false;
@@ -3833,6 +3854,21 @@ const char *cmMakefile::GetProperty(const char* prop,
   return retVal;
 }
 
+//----------------------------------------------------------------------------
+const char* cmMakefile::KeepComputedProperty(const char* prop,
+                                             std::string const& value)
+{
+  // Each property computed on lookup has storage of its own that is
+  // left alone while the value does not change, so that pointers handed
+  // out for it stay valid, even on other generating threads.
+  std::string& stored = this->ComputedProperties[prop];
+  if(stored != value)
+    {
+    stored = value;
+    }
+  return stored.c_str();
+}
+
 bool cmMakefile::GetPropertyAsBool(const char* prop)
 {
   return cmSystemTools::IsOn(this->GetProperty(prop));
@@ -4003,7 +4039,7 @@ void cmMakefile::RaiseScope(const char *var, const char *varDef)
   if(cmDefinitions* up = cur.GetParent())
     {
     // First localize the definition in the current scope.
-    cur.Get(var);
+    cur.Localize(var);
 
     // Now update the definition in the parent scope.
     up->Set(var, varDef);
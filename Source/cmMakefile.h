@@ -604,6 +604,11 @@ public:
   const char* GetSafeDefinition(const char*) const;
   const char* GetRequiredDefinition(const char* name) const;
   bool IsDefinitionSet(const char*) const;
+  /**
+   * Get the value of a variable like GetDefinition does but without
+   * notifying variable watches or recording the variable as used.
+   */
+  const char* PeekDefinition(const char*) const;
   /**
    * Get the list of all variables in the current space. If argument
    * cacheonly is specified and is greater than 0, then only cache
@@ -986,6 +991,9 @@ private:
   cmsys::RegularExpression cmAtVarRegex;
 
   cmPropertyMap Properties;
+  std::map<cmStdString, std::string> ComputedProperties;
+  const char* KeepComputedProperty(const char* prop,
+                                   std::string const& value);
 
   // should this makefile be processed before or after processing the parent
   bool PreOrder;
@@ -0,0 +1,169 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmMakefileProfilingData.h"
+
+#include "cmListFileCache.h"
+#include "cmSystemTools.h"
+
+#include <stdio.h>
+
+//----------------------------------------------------------------------------
+cmMakefileProfilingData::cmMakefileProfilingData(const char* outputFile):
+  Output(0), HasEvents(false)
+{
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(outputFile).c_str());
+  this->Output = new std::ofstream(outputFile);
+  if(!*this->Output)
+    {
+    delete this->Output;
+    this->Output = 0;
+    return;
+    }
+  *this->Output << "[";
+}
+
+//----------------------------------------------------------------------------
+cmMakefileProfilingData::~cmMakefileProfilingData()
+{
+  if(this->Output)
+    {
+    // Close entries left open by an early exit.
+    while(!this->Names.empty())
+      {
+      this->StopEntry();
+      }
+    *this->Output << "\n]\n";
+    delete this->Output;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::StartEntry(cmListFileFunction const& lff)
+{
+  std::string args = "\"functionArgs\":";
+  std::string functionArgs;
+  for(std::vector<cmListFileArgument>::const_iterator
+        ai = lff.Arguments.begin(); ai != lff.Arguments.end(); ++ai)
+    {
+    if(ai != lff.Arguments.begin())
+      {
+      functionArgs += " ";
+      }
+    functionArgs += ai->Value;
+    }
+  this->AppendString(args, functionArgs);
+  char line[64];
+  sprintf(line, ":%ld", lff.Line);
+  args += ",\"location\":";
+  this->AppendString(args, lff.FilePath + line);
+  this->WriteEvent("B", lff.Name, "command", args);
+  this->Names.push_back(lff.Name);
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::StartEntry(const char* listFile)
+{
+  this->WriteEvent("B", listFile, "listfile", "");
+  this->Names.push_back(listFile);
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::StopEntry()
+{
+  if(this->Names.empty())
+    {
+    return;
+    }
+  // Viewers match end events by nesting but the name makes the trace
+  // easier to read and to process.
+  std::string name = this->Names.back();
+  this->Names.pop_back();
+  this->WriteEvent("E", name, 0, "");
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::WriteEvent(const char* phase,
+                                         std::string const& name,
+                                         const char* category,
+                                         std::string const& args)
+{
+  if(!this->Output)
+    {
+    return;
+    }
+
+  // Timestamps are in microseconds.
+  char ts[64];
+  sprintf(ts, "%.0f", cmSystemTools::GetTime() * 1e6);
+
+  std::string event = "{\"ph\":\"";
+  event += phase;
+  event += "\",\"name\":";
+  this->AppendString(event, name);
+  if(category)
+    {
+    event += ",\"cat\":\"";
+    event += category;
+    event += "\"";
+    }
+  event += ",\"pid\":0,\"tid\":0,\"ts\":";
+  event += ts;
+  if(!args.empty())
+    {
+    event += ",\"args\":{";
+    event += args;
+    event += "}";
+    }
+  event += "}";
+
+  // The array is opened by the constructor and closed by the
+  // destructor so every event but the first follows a comma.
+  if(this->HasEvents)
+    {
+    *this->Output << ",";
+    }
+  *this->Output << "\n" << event;
+  this->HasEvents = true;
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::AppendString(std::string& out,
+                                           std::string const& str)
+{
+  out += "\"";
+  for(std::string::const_iterator ci = str.begin(); ci != str.end(); ++ci)
+    {
+    unsigned char c = static_cast<unsigned char>(*ci);
+    switch(c)
+      {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if(c < 0x20)
+          {
+          char buf[8];
+          sprintf(buf, "\\u%04x", c);
+          out += buf;
+          }
+        else
+          {
+          out += *ci;
+          }
+        break;
+      }
+    }
+  out += "\"";
+}
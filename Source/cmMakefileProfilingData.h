@@ -0,0 +1,90 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmMakefileProfilingData_h
+#define cmMakefileProfilingData_h
+
+#include "cmStandardIncludes.h"
+
+struct cmListFileFunction;
+
+/** \class cmMakefileProfilingData
+ * \brief Record how long listfile commands take to a trace file.
+ *
+ * The trace is written in the Chrome trace event format: a JSON array
+ * with a begin and an end event for each command invocation and each
+ * listfile read.  Events of a command give its name, arguments and
+ * location so they can be aggregated by file, function and command.
+ * It can be loaded into chrome://tracing or similar viewers.
+ *
+ * Entries must nest properly.  Those still open when the trace is
+ * destroyed are ended then.
+ */
+class cmMakefileProfilingData
+{
+public:
+  cmMakefileProfilingData(const char* outputFile);
+  ~cmMakefileProfilingData();
+
+  /** Return whether the output file could be opened.  */
+  bool IsValid() const { return this->Output != 0; }
+
+  /** Start the entry for a command invocation.  */
+  void StartEntry(cmListFileFunction const& lff);
+
+  /** Start the entry for reading a listfile.  */
+  void StartEntry(const char* listFile);
+
+  /** Stop the innermost entry.  */
+  void StopEntry();
+
+  /** Start an entry for the lifetime of this object.  */
+  class Scope
+  {
+  public:
+    Scope(cmMakefileProfilingData* data, cmListFileFunction const& lff):
+      Data(data)
+      {
+      if(this->Data)
+        {
+        this->Data->StartEntry(lff);
+        }
+      }
+    Scope(cmMakefileProfilingData* data, const char* listFile): Data(data)
+      {
+      if(this->Data)
+        {
+        this->Data->StartEntry(listFile);
+        }
+      }
+    ~Scope()
+      {
+      if(this->Data)
+        {
+        this->Data->StopEntry();
+        }
+      }
+  private:
+    cmMakefileProfilingData* Data;
+    Scope(Scope const&); // Purposely not implemented.
+    void operator=(Scope const&); // Purposely not implemented.
+  };
+
+private:
+  std::ofstream* Output;
+  bool HasEvents;
+  std::vector<std::string> Names;
+  void WriteEvent(const char* phase, std::string const& name,
+                  const char* category, std::string const& args);
+  static void AppendString(std::string& out, std::string const& str);
+};
+
+#endif
@@ -14,6 +14,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmSystemTools.h"
 #include "cmake.h"
+#include "cmWorkerPool.h"
 
 #include <assert.h>
 
@@ -302,6 +303,8 @@ cmOrderDirectories::~cmOrderDirectories()
 //----------------------------------------------------------------------------
 std::vector<std::string> const& cmOrderDirectories::GetOrderedDirectories()
 {
+  // The computation looks at directory content shared by all targets.
+  cmWorkerPool::ModelLock lock;
   if(!this->Computed)
     {
     this->Computed = true;
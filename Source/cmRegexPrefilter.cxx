@@ -0,0 +1,530 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmRegexPrefilter.h"
+
+#include <string.h>
+
+// Largest set of strings tracked for a part of a pattern.
+#define cmRegexPrefilter_MAX_STRINGS 16
+
+//----------------------------------------------------------------------------
+static char cmRegexPrefilterFold(char c)
+{
+  return (c >= 'A' && c <= 'Z')? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+//----------------------------------------------------------------------------
+// What is known about the texts matched by a part of a pattern.  When
+// Exact is set, Strings holds all of the texts the part matches.
+// Otherwise every text it matches contains one of Strings, and nothing
+// is known when Strings is empty.
+struct cmRegexPrefilterInfo
+{
+  bool Exact;
+  std::set<std::string> Strings;
+  cmRegexPrefilterInfo(): Exact(false) {}
+  static cmRegexPrefilterInfo Literal(std::string const& s)
+    {
+    cmRegexPrefilterInfo info;
+    info.Exact = true;
+    info.Strings.insert(s);
+    return info;
+    }
+  // The strings of which every match contains one.
+  std::set<std::string> Required() const
+    {
+    if(this->Exact && this->Strings.count(""))
+      {
+      return std::set<std::string>();
+      }
+    return this->Strings;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Parse a pattern in the syntax of cmsys::RegularExpression.
+class cmRegexPrefilterParser
+{
+public:
+  cmRegexPrefilterParser(const char* pattern): Valid(true), Pos(pattern) {}
+  cmRegexPrefilterInfo Parse()
+    {
+    cmRegexPrefilterInfo info = this->ParseAlternation();
+    if(*this->Pos)
+      {
+      this->Valid = false;
+      }
+    return info;
+    }
+  bool Valid;
+private:
+  const char* Pos;
+
+  cmRegexPrefilterInfo ParseAlternation();
+  cmRegexPrefilterInfo ParseBranch();
+  cmRegexPrefilterInfo ParsePiece();
+  cmRegexPrefilterInfo ParseAtom();
+  cmRegexPrefilterInfo ParseClass();
+
+  // The shortest of the strings counts for how selective a set is.
+  static size_t Score(std::set<std::string> const& strings)
+    {
+    size_t score = 0;
+    for(std::set<std::string>::const_iterator si = strings.begin();
+        si != strings.end(); ++si)
+      {
+      if(si == strings.begin() || si->size() < score)
+        {
+        score = si->size();
+        }
+      }
+    return score;
+    }
+  static void Consider(std::set<std::string>& best,
+                       std::set<std::string> const& strings)
+    {
+    size_t score = Score(strings);
+    size_t bestScore = Score(best);
+    if(score > bestScore ||
+       (score == bestScore && score > 0 && strings.size() < best.size()))
+      {
+      best = strings;
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+cmRegexPrefilterInfo cmRegexPrefilterParser::ParseAlternation()
+{
+  cmRegexPrefilterInfo result = this->ParseBranch();
+  while(this->Valid && *this->Pos == '|')
+    {
+    ++this->Pos;
+    cmRegexPrefilterInfo next = this->ParseBranch();
+    if(result.Exact && next.Exact &&
+       result.Strings.size() + next.Strings.size() <=
+       cmRegexPrefilter_MAX_STRINGS)
+      {
+      result.Strings.insert(next.Strings.begin(), next.Strings.end());
+      continue;
+      }
+    // A match of the alternation contains a literal of either branch.
+    std::set<std::string> left = result.Required();
+    std::set<std::string> right = next.Required();
+    result.Exact = false;
+    result.Strings.clear();
+    if(!left.empty() && !right.empty())
+      {
+      result.Strings = left;
+      result.Strings.insert(right.begin(), right.end());
+      }
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+cmRegexPrefilterInfo cmRegexPrefilterParser::ParseBranch()
+{
+  // Join the exact strings of consecutive pieces as long as there are
+  // few enough of them.  The best set of strings found anywhere in the
+  // branch is required by it.
+  std::set<std::string> run;
+  run.insert("");
+  std::set<std::string> best;
+  bool exact = true;
+  while(this->Valid && *this->Pos && *this->Pos != '|' && *this->Pos != ')')
+    {
+    cmRegexPrefilterInfo piece = this->ParsePiece();
+    if(piece.Exact &&
+       run.size() * piece.Strings.size() <= cmRegexPrefilter_MAX_STRINGS)
+      {
+      std::set<std::string> joined;
+      for(std::set<std::string>::const_iterator ri = run.begin();
+          ri != run.end(); ++ri)
+        {
+        for(std::set<std::string>::const_iterator pi = piece.Strings.begin();
+            pi != piece.Strings.end(); ++pi)
+          {
+          joined.insert(*ri + *pi);
+          }
+        }
+      run.swap(joined);
+      }
+    else if(piece.Exact)
+      {
+      Consider(best, run);
+      run = piece.Strings;
+      exact = false;
+      }
+    else
+      {
+      Consider(best, run);
+      run.clear();
+      run.insert("");
+      Consider(best, piece.Strings);
+      exact = false;
+      }
+    }
+  cmRegexPrefilterInfo info;
+  if(exact)
+    {
+    info.Exact = true;
+    info.Strings = run;
+    }
+  else
+    {
+    Consider(best, run);
+    info.Strings = best;
+    }
+  return info;
+}
+
+//----------------------------------------------------------------------------
+cmRegexPrefilterInfo cmRegexPrefilterParser::ParsePiece()
+{
+  cmRegexPrefilterInfo atom = this->ParseAtom();
+  switch(*this->Pos)
+    {
+    case '*':
+      ++this->Pos;
+      return cmRegexPrefilterInfo();
+    case '?':
+      ++this->Pos;
+      if(atom.Exact)
+        {
+        atom.Strings.insert("");
+        return atom;
+        }
+      return cmRegexPrefilterInfo();
+    case '+':
+      {
+      ++this->Pos;
+      cmRegexPrefilterInfo info;
+      info.Strings = atom.Required();
+      return info;
+      }
+    default:
+      return atom;
+    }
+}
+
+//----------------------------------------------------------------------------
+cmRegexPrefilterInfo cmRegexPrefilterParser::ParseAtom()
+{
+  char c = *this->Pos;
+  switch(c)
+    {
+    case '(':
+      {
+      ++this->Pos;
+      cmRegexPrefilterInfo info = this->ParseAlternation();
+      if(*this->Pos != ')')
+        {
+        this->Valid = false;
+        return cmRegexPrefilterInfo();
+        }
+      ++this->Pos;
+      return info;
+      }
+    case '[':
+      return this->ParseClass();
+    case '.':
+      ++this->Pos;
+      return cmRegexPrefilterInfo();
+    case '^':
+    case '$':
+      ++this->Pos;
+      return cmRegexPrefilterInfo::Literal("");
+    case '\\':
+      ++this->Pos;
+      if(!*this->Pos)
+        {
+        this->Valid = false;
+        return cmRegexPrefilterInfo();
+        }
+      c = *this->Pos++;
+      return cmRegexPrefilterInfo::Literal(
+        std::string(1, cmRegexPrefilterFold(c)));
+    case '\0':
+    case '|':
+    case ')':
+    case '*':
+    case '+':
+    case '?':
+      this->Valid = false;
+      return cmRegexPrefilterInfo();
+    default:
+      ++this->Pos;
+      return cmRegexPrefilterInfo::Literal(
+        std::string(1, cmRegexPrefilterFold(c)));
+    }
+}
+
+//----------------------------------------------------------------------------
+cmRegexPrefilterInfo cmRegexPrefilterParser::ParseClass()
+{
+  // Follow the bracket syntax of cmsys::RegularExpression.  A class of
+  // a few characters, such as [Ww], is exact.
+  ++this->Pos;
+  bool negated = false;
+  if(*this->Pos == '^')
+    {
+    negated = true;
+    ++this->Pos;
+    }
+  std::set<char> chars;
+  if(*this->Pos == ']' || *this->Pos == '-')
+    {
+    chars.insert(*this->Pos++);
+    }
+  while(*this->Pos && *this->Pos != ']')
+    {
+    if(*this->Pos == '-' && this->Pos[1] && this->Pos[1] != ']')
+      {
+      unsigned char first = static_cast<unsigned char>(this->Pos[-1]);
+      unsigned char last = static_cast<unsigned char>(this->Pos[1]);
+      for(unsigned int ch = first; ch <= last; ++ch)
+        {
+        chars.insert(static_cast<char>(ch));
+        }
+      this->Pos += 2;
+      }
+    else
+      {
+      chars.insert(*this->Pos++);
+      }
+    }
+  if(*this->Pos != ']')
+    {
+    this->Valid = false;
+    return cmRegexPrefilterInfo();
+    }
+  ++this->Pos;
+
+  cmRegexPrefilterInfo info;
+  if(negated)
+    {
+    return info;
+    }
+  for(std::set<char>::const_iterator ci = chars.begin();
+      ci != chars.end(); ++ci)
+    {
+    info.Strings.insert(std::string(1, cmRegexPrefilterFold(*ci)));
+    }
+  if(info.Strings.size() > 4)
+    {
+    info.Strings.clear();
+    return info;
+    }
+  info.Exact = true;
+  return info;
+}
+
+//----------------------------------------------------------------------------
+cmRegexPrefilter::cmRegexPrefilter()
+{
+  this->Clear();
+}
+
+//----------------------------------------------------------------------------
+void cmRegexPrefilter::Clear()
+{
+  this->Literals.clear();
+  this->Unfiltered.clear();
+  memset(this->Classes, 0, sizeof(this->Classes));
+  this->NumClasses = 1;
+  this->Transitions.clear();
+  this->Outputs.clear();
+}
+
+//----------------------------------------------------------------------------
+void cmRegexPrefilter::AddPattern(const char* pattern)
+{
+  this->Literals.push_back(ExtractLiterals(pattern));
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string>
+cmRegexPrefilter::ExtractLiterals(const char* pattern)
+{
+  cmRegexPrefilterParser parser(pattern);
+  cmRegexPrefilterInfo info = parser.Parse();
+  std::set<std::string> required = info.Required();
+
+  // A single character occurs in too many texts to be worth it.
+  std::vector<std::string> literals;
+  if(parser.Valid)
+    {
+    for(std::set<std::string>::const_iterator ri = required.begin();
+        ri != required.end(); ++ri)
+      {
+      if(ri->size() < 2)
+        {
+        return std::vector<std::string>();
+        }
+      literals.push_back(*ri);
+      }
+    }
+  return literals;
+}
+
+//----------------------------------------------------------------------------
+void cmRegexPrefilter::Compile()
+{
+  // Number the bytes occurring in literals.  Upper case letters share
+  // the class of their lower case.
+  memset(this->Classes, 0, sizeof(this->Classes));
+  this->NumClasses = 1;
+  this->Unfiltered.clear();
+  for(size_t i = 0; i < this->Literals.size(); ++i)
+    {
+    if(this->Literals[i].empty())
+      {
+      this->Unfiltered.push_back(i);
+      }
+    for(std::vector<std::string>::const_iterator li =
+          this->Literals[i].begin(); li != this->Literals[i].end(); ++li)
+      {
+      for(std::string::const_iterator ci = li->begin(); ci != li->end(); ++ci)
+        {
+        unsigned char c = static_cast<unsigned char>(*ci);
+        if(!this->Classes[c])
+          {
+          this->Classes[c] = static_cast<unsigned char>(this->NumClasses++);
+          }
+        }
+      }
+    }
+  for(unsigned int c = 'A'; c <= 'Z'; ++c)
+    {
+    this->Classes[c] = this->Classes[c - 'A' + 'a'];
+    }
+
+  // Build the trie of the literals.  A transition of -1 is missing.
+  size_t numClasses = this->NumClasses;
+  this->Transitions.assign(numClasses, -1);
+  this->Outputs.assign(1, std::vector<size_t>());
+  for(size_t i = 0; i < this->Literals.size(); ++i)
+    {
+    for(std::vector<std::string>::const_iterator li =
+          this->Literals[i].begin(); li != this->Literals[i].end(); ++li)
+      {
+      size_t state = 0;
+      for(std::string::const_iterator ci = li->begin(); ci != li->end(); ++ci)
+        {
+        size_t c = this->Classes[static_cast<unsigned char>(*ci)];
+        int next = this->Transitions[state * numClasses + c];
+        if(next < 0)
+          {
+          next = static_cast<int>(this->Outputs.size());
+          this->Transitions[state * numClasses + c] = next;
+          this->Transitions.resize(this->Transitions.size() + numClasses, -1);
+          this->Outputs.push_back(std::vector<size_t>());
+          }
+        state = static_cast<size_t>(next);
+        }
+      this->Outputs[state].push_back(i);
+      }
+    }
+
+  // Complete the transitions breadth first.  A missing transition
+  // goes where the longest proper suffix of the state's text leads,
+  // and a state outputs the patterns of that suffix too.
+  std::vector<size_t> fail(this->Outputs.size(), 0);
+  std::vector<size_t> queue;
+  for(size_t c = 0; c < numClasses; ++c)
+    {
+    int next = this->Transitions[c];
+    if(next < 0)
+      {
+      this->Transitions[c] = 0;
+      }
+    else
+      {
+      queue.push_back(static_cast<size_t>(next));
+      }
+    }
+  for(size_t qi = 0; qi < queue.size(); ++qi)
+    {
+    size_t state = queue[qi];
+    std::vector<size_t> const& inherited = this->Outputs[fail[state]];
+    this->Outputs[state].insert(this->Outputs[state].end(),
+                                inherited.begin(), inherited.end());
+    for(size_t c = 0; c < numClasses; ++c)
+      {
+      int& next = this->Transitions[state * numClasses + c];
+      int fallback = this->Transitions[fail[state] * numClasses + c];
+      if(next < 0)
+        {
+        next = fallback;
+        }
+      else
+        {
+        fail[next] = static_cast<size_t>(fallback);
+        queue.push_back(static_cast<size_t>(next));
+        }
+      }
+    }
+  for(std::vector<std::vector<size_t> >::iterator oi = this->Outputs.begin();
+      oi != this->Outputs.end(); ++oi)
+    {
+    std::sort(oi->begin(), oi->end());
+    oi->erase(std::unique(oi->begin(), oi->end()), oi->end());
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmRegexPrefilter::Scan(const char* text,
+                            std::vector<char>& candidates) const
+{
+  candidates.assign(this->Literals.size(), 0);
+  for(std::vector<size_t>::const_iterator ui = this->Unfiltered.begin();
+      ui != this->Unfiltered.end(); ++ui)
+    {
+    candidates[*ui] = 1;
+    }
+  if(this->Transitions.empty())
+    {
+    return;
+    }
+  const int* transitions = &this->Transitions[0];
+  size_t numClasses = this->NumClasses;
+  size_t state = 0;
+  for(const unsigned char* c = reinterpret_cast<const unsigned char*>(text);
+      *c; ++c)
+    {
+    state = static_cast<size_t>(
+      transitions[state * numClasses + this->Classes[*c]]);
+    std::vector<size_t> const& outputs = this->Outputs[state];
+    for(std::vector<size_t>::const_iterator oi = outputs.begin();
+        oi != outputs.end(); ++oi)
+      {
+      candidates[*oi] = 1;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int cmRegexPrefilter::Find(std::vector<cmsys::RegularExpression>& regexes,
+                           const char* text) const
+{
+  std::vector<char> candidates;
+  this->Scan(text, candidates);
+  for(size_t i = 0; i < regexes.size(); ++i)
+    {
+    if((i >= candidates.size() || candidates[i]) && regexes[i].find(text))
+      {
+      return static_cast<int>(i);
+      }
+    }
+  return -1;
+}
@@ -0,0 +1,80 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmRegexPrefilter_h
+#define cmRegexPrefilter_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+/** \class cmRegexPrefilter
+ * \brief Rule out regular expressions that cannot match a text.
+ *
+ * Most regular expressions can only match a text containing one of a
+ * few literal strings, such as ": warning" for
+ * "([^:]+): warning".  The prefilter extracts such literals from a
+ * list of patterns and finds all of them in one pass over a text with
+ * an Aho-Corasick automaton.  Only the regular expressions whose
+ * literals occur still need to be tried.  Literals are compared
+ * ignoring ASCII case so that "[Ww]arning" gives "warning".  Patterns
+ * without a useful literal are always tried.
+ *
+ * Once compiled the prefilter is not modified by scanning, so one may
+ * be shared by threads.
+ */
+class cmRegexPrefilter
+{
+public:
+  cmRegexPrefilter();
+
+  /** Remove all patterns.  */
+  void Clear();
+
+  /** Add a pattern in the syntax of cmsys::RegularExpression.  Patterns
+      are numbered in the order they are added.  */
+  void AddPattern(const char* pattern);
+
+  /** Build the automaton for the patterns added.  */
+  void Compile();
+
+  /** Set an element of candidates to 1 for each pattern that may match
+      somewhere in the text and to 0 for those that cannot.  */
+  void Scan(const char* text, std::vector<char>& candidates) const;
+
+  /** Return the index of the first of the regular expressions compiled
+      from the patterns that matches the text, or -1 if none does.  */
+  int Find(std::vector<cmsys::RegularExpression>& regexes,
+           const char* text) const;
+
+  /** Get the literals of which a text must contain one for a pattern
+      to match it, in lower case.  It is empty for a pattern that is
+      always tried.  */
+  std::vector<std::string> const& GetLiterals(size_t index) const
+    { return this->Literals[index]; }
+
+private:
+  std::vector<std::vector<std::string> > Literals;
+  std::vector<size_t> Unfiltered;
+
+  // The automaton works on classes of bytes.  Class 0 holds the bytes
+  // that occur in no literal.  Transitions has one row per state with
+  // one entry per class, and Outputs lists the patterns whose literals
+  // end at each state.
+  unsigned char Classes[256];
+  size_t NumClasses;
+  std::vector<int> Transitions;
+  std::vector<std::vector<size_t> > Outputs;
+
+  static std::vector<std::string> ExtractLiterals(const char* pattern);
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "cmSystemTools.h"
 #include "cmake.h"
 #include "cmDocumentCompileDefinitions.h"
+#include "cmWorkerPool.h"
 
 //----------------------------------------------------------------------------
 cmSourceFile::cmSourceFile(cmMakefile* mf, const char* name):
@@ -42,6 +43,7 @@ std::string const& cmSourceFile::GetExtension() const
 //----------------------------------------------------------------------------
 const char* cmSourceFile::GetLanguage()
 {
+  cmWorkerPool::ModelLock lock;
   // If the language was set explicitly by the user then use it.
   if(const char* lang = this->GetProperty("LANGUAGE"))
     {
@@ -104,6 +106,7 @@ cmSourceFileLocation const& cmSourceFile::GetLocation() const
 //----------------------------------------------------------------------------
 std::string const& cmSourceFile::GetFullPath(std::string* error)
 {
+  cmWorkerPool::ModelLock lock;
   if(this->FullPath.empty())
     {
     if(this->FindFullPath(error))
@@ -13,6 +13,7 @@
 # define _WIN32_WINNT 0x0400 /* for wincrypt.h */
 #endif
 #include "cmSystemTools.h"
+#include "cmWorkerPool.h"
 #include <ctype.h>
 #include <errno.h>
 #include <time.h>
@@ -45,6 +46,11 @@
 
 #include <sys/stat.h>
 
+#if defined(__linux__)
+# include <fcntl.h>
+# include <sys/syscall.h>
+#endif
+
 #if defined(_WIN32) && \
    (defined(_MSC_VER) || defined(__WATCOMC__) || \
     defined(__BORLANDC__) || defined(__MINGW32__))
@@ -113,6 +119,7 @@ bool cmSystemTools::s_DisableRunCommandOutput = false;
 bool cmSystemTools::s_ErrorOccured = false;
 bool cmSystemTools::s_FatalErrorOccured = false;
 bool cmSystemTools::s_DisableMessages = false;
+unsigned long cmSystemTools::s_NumberOfMessages = 0;
 bool cmSystemTools::s_ForceUnixPaths = false;
 
 std::string cmSystemTools::s_Windows9xComspecSubstitute = "command.com";
@@ -234,6 +241,7 @@ void cmSystemTools::Error(const char* m1, const char* m2,
     {
     message += m4;
     }
+  cmWorkerPool::ModelLock lock;
   cmSystemTools::s_ErrorOccured = true;
   cmSystemTools::Message(message.c_str(),"Error");
 }
@@ -281,6 +289,8 @@ void cmSystemTools::Stdout(const char* s)
 
 void cmSystemTools::Stderr(const char* s, int length)
 {
+    cmWorkerPool::ModelLock lock;
+    ++s_NumberOfMessages;
     std::cerr.write(s, length);
     std::cerr.flush();
 }
@@ -300,6 +310,8 @@ void cmSystemTools::Stdout(const char* s, int length)
 
 void cmSystemTools::Message(const char* m1, const char *title)
 {
+  cmWorkerPool::ModelLock lock;
+  ++s_NumberOfMessages;
   if(s_DisableMessages)
     {
     return;
@@ -1182,6 +1194,64 @@ bool cmSystemTools::CopyFileIfDifferent(const char* source,
   return Superclass::CopyFileIfDifferent(source, destination);
 }
 
+//----------------------------------------------------------------------------
+bool cmSystemTools::CloneFile(const char* source, const char* destination)
+{
+  if(cmSystemTools::SameFile(source, destination))
+    {
+    return true;
+    }
+#if defined(__linux__) && defined(SYS_copy_file_range)
+  int in = open(source, O_RDONLY);
+  if(in >= 0)
+    {
+    // Files of pseudo file systems report no size or a wrong one, so
+    // the size copied tells whether the kernel copied everything.
+    struct stat st;
+    int out = -1;
+    if(fstat(in, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+      {
+      // Remove the destination so that read-only files can be replaced.
+      unlink(destination);
+      out = open(destination, O_WRONLY | O_CREAT | O_TRUNC,
+                 st.st_mode & 07777);
+      }
+    long n = -1;
+    if(out >= 0)
+      {
+      off_t copied = 0;
+      do
+        {
+        n = syscall(SYS_copy_file_range, in, static_cast<void*>(0),
+                    out, static_cast<void*>(0),
+                    static_cast<size_t>(1) << 30, 0u);
+        copied += n > 0? static_cast<off_t>(n) : 0;
+        } while(n > 0);
+      if(n == 0 && copied != st.st_size)
+        {
+        n = -1;
+        }
+      if(n == 0 && fchmod(out, st.st_mode & 07777) != 0)
+        {
+        n = -1;
+        }
+      if(close(out) != 0)
+        {
+        n = -1;
+        }
+      }
+    close(in);
+    if(n == 0)
+      {
+      return true;
+      }
+    // The kernel or file system cannot copy these files.  Copy the
+    // data ourselves.
+    }
+#endif
+  return Superclass::CopyFileAlways(source, destination);
+}
+
 //----------------------------------------------------------------------------
 bool cmSystemTools::RenameFile(const char* oldname, const char* newname)
 {
@@ -1737,7 +1807,8 @@ bool cmSystemTools::IsPathToFramework(const char* path)
 
 bool cmSystemTools::CreateTar(const char* outFileName,
                               const std::vector<cmStdString>& files,
-                              bool gzip, bool bzip2, bool verbose)
+                              bool gzip, bool bzip2, bool verbose,
+                              unsigned int threads)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   std::string cwd = cmSystemTools::GetCurrentWorkingDirectory();
@@ -1754,7 +1825,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
   cmArchiveWrite a(fout, (gzip? cmArchiveWrite::CompressGZip :
                           (bzip2? cmArchiveWrite::CompressBZip2 :
                            cmArchiveWrite::CompressNone)),
-                           cmArchiveWrite::TypeTAR);
+                           cmArchiveWrite::TypeTAR, threads);
   a.SetVerbose(verbose);
   for(std::vector<cmStdString>::const_iterator i = files.begin();
       i != files.end(); ++i)
@@ -1770,7 +1841,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
       break;
       }
     }
-  if(!a)
+  if(!a.Close())
     {
     cmSystemTools::Error(a.GetError().c_str());
     return false;
@@ -1781,6 +1852,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
   (void)files;
   (void)gzip;
   (void)verbose;
+  (void)threads;
   return false;
 #endif
 }
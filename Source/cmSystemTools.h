@@ -177,6 +177,11 @@ public:
   static bool CopyFileIfDifferent(const char* source,
     const char* destination);
 
+  /** Copy a file like cmCopyFile but let the operating system copy the
+      data where it can, e.g. with copy_file_range on Linux.  File
+      systems supporting reflinks then share the data instead.  */
+  static bool CloneFile(const char* source, const char* destination);
+
   /** Rename a file or directory within a single disk volume (atomic
       if possible).  */
   static bool RenameFile(const char* oldname, const char* newname);
@@ -269,6 +274,8 @@ public:
                                                 int shell_flags);
 
   static void EnableMessages() { s_DisableMessages = false; }
+  ///! Return the number of messages and errors reported so far.
+  static unsigned long GetNumberOfMessages() { return s_NumberOfMessages; }
   static void DisableMessages() { s_DisableMessages = true; }
   static void DisableRunCommandOutput() {s_DisableRunCommandOutput = true; }
   static void EnableRunCommandOutput() {s_DisableRunCommandOutput = false; }
@@ -405,7 +412,7 @@ public:
                       bool gzip, bool verbose);
   static bool CreateTar(const char* outFileName,
                         const std::vector<cmStdString>& files, bool gzip,
-                        bool bzip2, bool verbose);
+                        bool bzip2, bool verbose, unsigned int threads = 1);
   static bool ExtractTar(const char* inFileName, bool gzip,
                          bool verbose);
   // This should be called first thing in main
@@ -478,6 +485,7 @@ private:
   static bool s_ErrorOccured;
   static bool s_FatalErrorOccured;
   static bool s_DisableMessages;
+  static unsigned long s_NumberOfMessages;
   static bool s_DisableRunCommandOutput;
   static ErrorCallback s_ErrorCallback;
   static StdoutCallback s_StdoutCallback;
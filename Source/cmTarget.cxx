@@ -22,6 +22,7 @@
 #include "cmListFileCache.h"
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorExpressionDAGChecker.h"
+#include "cmWorkerPool.h"
 #include <cmsys/RegularExpression.hxx>
 #include <map>
 #include <set>
@@ -95,6 +96,15 @@ public:
     this->SourceEntries = r.SourceEntries;
     }
   ~cmTargetInternals();
+
+  // Values of the properties computed on each lookup, and the locations
+  // of the target by configuration.  Each has storage of its own that
+  // is left alone while the value does not change, so that pointers
+  // handed out for it stay valid, even on other generating threads.
+  std::map<cmStdString, std::string> ComputedProperties;
+  std::map<cmStdString, std::string> Locations;
+  std::string BuildTimeLocation;
+
   typedef cmTarget::SourceFileFlags SourceFileFlags;
   std::map<cmSourceFile const*, SourceFileFlags> SourceFlagsMap;
   bool SourceFileFlagsConstructed;
@@ -2225,6 +2235,7 @@ void cmTarget::ProcessSourceExpression(std::string const& expr)
 struct cmTarget::SourceFileFlags
 cmTarget::GetTargetSourceFileFlags(const cmSourceFile* sf)
 {
+  cmWorkerPool::ModelLock lock;
   struct SourceFileFlags flags;
   this->ConstructSourceFileFlags();
   std::map<cmSourceFile const*, SourceFileFlags>::iterator si =
@@ -2425,6 +2436,7 @@ bool cmTarget::NameResolvesToFramework(const std::string& libname)
 void cmTarget::GetDirectLinkLibraries(const char *config,
                             std::vector<std::string> &libs, cmTarget *head)
 {
+  cmWorkerPool::ModelLock lock;
   const char *prop = this->GetProperty("LINK_LIBRARIES");
   if (prop)
     {
@@ -2975,6 +2987,7 @@ void cmTarget::GatherDependencies( const cmMakefile& mf,
 //----------------------------------------------------------------------------
 void cmTarget::SetProperty(const char* prop, const char* value)
 {
+  cmWorkerPool::ModelLock lock;
   if (!prop)
     {
     return;
@@ -3044,10 +3057,26 @@ void cmTarget::SetProperty(const char* prop, const char* value)
   this->MaybeInvalidatePropertyCache(prop);
 }
 
+//----------------------------------------------------------------------------
+void cmTarget::SetComputedProperty(const char* prop, const char* value)
+{
+  // Leave the value alone if it is already current so that pointers
+  // handed out for it by an earlier lookup stay valid.
+  bool chain = false;
+  const char* old =
+    this->Properties.GetPropertyValue(prop, cmProperty::TARGET, chain);
+  if(old && value && strcmp(old, value) == 0)
+    {
+    return;
+    }
+  this->SetProperty(prop, value);
+}
+
 //----------------------------------------------------------------------------
 void cmTarget::AppendProperty(const char* prop, const char* value,
                               bool asString)
 {
+  cmWorkerPool::ModelLock lock;
   if (!prop)
     {
     return;
@@ -3339,6 +3368,7 @@ static void processIncludeDirectories(cmTarget *tgt,
 //----------------------------------------------------------------------------
 std::vector<std::string> cmTarget::GetIncludeDirectories(const char *config)
 {
+  cmWorkerPool::ModelLock lock;
   std::vector<std::string> includes;
   std::set<std::string> uniqueIncludes;
   cmListFileBacktrace lfbt;
@@ -3540,6 +3570,7 @@ static void processCompileOptions(cmTarget *tgt,
 void cmTarget::GetCompileOptions(std::vector<std::string> &result,
                                  const char *config)
 {
+  cmWorkerPool::ModelLock lock;
   std::set<std::string> uniqueOptions;
   cmListFileBacktrace lfbt;
 
@@ -3648,6 +3679,7 @@ static void processCompileDefinitions(cmTarget *tgt,
 void cmTarget::GetCompileDefinitions(std::vector<std::string> &list,
                                             const char *config)
 {
+  cmWorkerPool::ModelLock lock;
   std::set<std::string> uniqueOptions;
   cmListFileBacktrace lfbt;
 
@@ -3882,6 +3914,7 @@ bool cmTarget::HaveWellDefinedOutputFiles()
 //----------------------------------------------------------------------------
 cmTarget::OutputInfo const* cmTarget::GetOutputInfo(const char* config)
 {
+  cmWorkerPool::ModelLock lock;
   // There is no output information for imported targets.
   if(this->IsImported())
     {
@@ -3953,9 +3986,21 @@ std::string cmTarget::GetPDBDirectory(const char* config)
   return "";
 }
 
+//----------------------------------------------------------------------------
+static const char* cmTargetKeepValue(std::string& stored,
+                                     std::string const& value)
+{
+  if(stored != value)
+    {
+    stored = value;
+    }
+  return stored.c_str();
+}
+
 //----------------------------------------------------------------------------
 const char* cmTarget::GetLocation(const char* config)
 {
+  cmWorkerPool::ModelLock lock;
   if (this->IsImported())
     {
     return this->ImportedGetLocation(config);
@@ -3969,8 +4014,8 @@ const char* cmTarget::GetLocation(const char* config)
 //----------------------------------------------------------------------------
 const char* cmTarget::ImportedGetLocation(const char* config)
 {
-  this->Location = this->ImportedGetFullPath(config, false);
-  return this->Location.c_str();
+  return cmTargetKeepValue(this->Internal->Locations[config? config : ""],
+                           this->ImportedGetFullPath(config, false));
 }
 
 //----------------------------------------------------------------------------
@@ -3979,17 +4024,17 @@ const char* cmTarget::NormalGetLocation(const char* config)
   // Handle the configuration-specific case first.
   if(config)
     {
-    this->Location = this->GetFullPath(config, false);
-    return this->Location.c_str();
+    return cmTargetKeepValue(this->Internal->Locations[config],
+                             this->GetFullPath(config, false));
     }
 
   // Now handle the deprecated build-time configuration location.
-  this->Location = this->GetDirectory();
+  std::string location = this->GetDirectory();
   const char* cfgid = this->Makefile->GetDefinition("CMAKE_CFG_INTDIR");
   if(cfgid && strcmp(cfgid, ".") != 0)
     {
-    this->Location += "/";
-    this->Location += cfgid;
+    location += "/";
+    location += cfgid;
     }
 
   if(this->IsAppBundleOnApple())
@@ -3997,13 +4042,13 @@ const char* cmTarget::NormalGetLocation(const char* config)
     std::string macdir = this->BuildMacContentDirectory("", config, false);
     if(!macdir.empty())
       {
-      this->Location += "/";
-      this->Location += macdir;
+      location += "/";
+      location += macdir;
       }
     }
-  this->Location += "/";
-  this->Location += this->GetFullName(config, false);
-  return this->Location.c_str();
+  location += "/";
+  location += this->GetFullName(config, false);
+  return cmTargetKeepValue(this->Internal->BuildTimeLocation, location);
 }
 
 //----------------------------------------------------------------------------
@@ -4072,6 +4117,7 @@ const char *cmTarget::GetProperty(const char* prop)
 const char *cmTarget::GetProperty(const char* prop,
                                   cmProperty::ScopeType scope)
 {
+  cmWorkerPool::ModelLock lock;
   if(!prop)
     {
     return 0;
@@ -4101,14 +4147,15 @@ const char *cmTarget::GetProperty(const char* prop,
       // cannot take into account the per-configuration name of the
       // target because the configuration type may not be known at
       // CMake time.
-      this->SetProperty("LOCATION", this->GetLocation(0));
+      this->SetComputedProperty("LOCATION", this->GetLocation(0));
       }
 
     // Support "LOCATION_<CONFIG>".
     if(strncmp(prop, "LOCATION_", 9) == 0)
       {
       std::string configName = prop+9;
-      this->SetProperty(prop, this->GetLocation(configName.c_str()));
+      this->SetComputedProperty(prop,
+                                this->GetLocation(configName.c_str()));
       }
     else
       {
@@ -4119,15 +4166,15 @@ const char *cmTarget::GetProperty(const char* prop,
         std::string configName(prop, len-9);
         if(configName != "IMPORTED")
           {
-          this->SetProperty(prop, this->GetLocation(configName.c_str()));
+          this->SetComputedProperty(prop,
+                                    this->GetLocation(configName.c_str()));
           }
         }
       }
     }
   if(strcmp(prop,"INCLUDE_DIRECTORIES") == 0)
     {
-    static std::string output;
-    output = "";
+    std::string output;
     std::string sep;
     typedef cmTargetInternals::TargetPropertyEntry
                                 TargetPropertyEntry;
@@ -4140,12 +4187,12 @@ const char *cmTarget::GetProperty(const char* prop,
       output += (*it)->ge->GetInput();
       sep = ";";
       }
-    return output.c_str();
+    return cmTargetKeepValue(this->Internal->ComputedProperties[prop],
+                             output);
     }
   if(strcmp(prop,"COMPILE_OPTIONS") == 0)
     {
-    static std::string output;
-    output = "";
+    std::string output;
     std::string sep;
     typedef cmTargetInternals::TargetPropertyEntry
                                 TargetPropertyEntry;
@@ -4158,12 +4205,12 @@ const char *cmTarget::GetProperty(const char* prop,
       output += (*it)->ge->GetInput();
       sep = ";";
       }
-    return output.c_str();
+    return cmTargetKeepValue(this->Internal->ComputedProperties[prop],
+                             output);
     }
   if(strcmp(prop,"COMPILE_DEFINITIONS") == 0)
     {
-    static std::string output;
-    output = "";
+    std::string output;
     std::string sep;
     typedef cmTargetInternals::TargetPropertyEntry
                                 TargetPropertyEntry;
@@ -4176,7 +4223,8 @@ const char *cmTarget::GetProperty(const char* prop,
       output += (*it)->ge->GetInput();
       sep = ";";
       }
-    return output.c_str();
+    return cmTargetKeepValue(this->Internal->ComputedProperties[prop],
+                             output);
     }
 
   if (strcmp(prop,"IMPORTED") == 0)
@@ -4208,7 +4256,7 @@ const char *cmTarget::GetProperty(const char* prop,
       // Append this list entry.
       ss << sname;
       }
-    this->SetProperty("SOURCES", ss.str().c_str());
+    this->SetComputedProperty("SOURCES", ss.str().c_str());
     }
 
   // the type property returns what type the target is
@@ -4286,6 +4334,7 @@ const char* cmTarget::GetLinkerLanguage(const char* config, cmTarget *head)
 cmTarget::LinkClosure const* cmTarget::GetLinkClosure(const char* config,
                                                       cmTarget *head)
 {
+  cmWorkerPool::ModelLock lock;
   TargetConfigPair key(head, cmSystemTools::UpperCase(config ? config : ""));
   cmTargetInternals::LinkClosureMapType::iterator
     i = this->Internal->LinkClosureMap.find(key);
@@ -5612,6 +5661,7 @@ const char* cmTarget::GetExportMacro()
 //----------------------------------------------------------------------------
 bool cmTarget::IsNullImpliedByLinkLibraries(const std::string &p)
 {
+  cmWorkerPool::ModelLock lock;
   return this->LinkImplicitNullProperties.find(p)
       != this->LinkImplicitNullProperties.end();
 }
@@ -5800,6 +5850,7 @@ PropertyType checkInterfacePropertyCompatibility(cmTarget *tgt,
 bool cmTarget::GetLinkInterfaceDependentBoolProperty(const std::string &p,
                                                      const char *config)
 {
+  cmWorkerPool::ModelLock lock;
   return checkInterfacePropertyCompatibility<bool>(this, p, config, "FALSE",
                                                    0);
 }
@@ -5809,6 +5860,7 @@ const char * cmTarget::GetLinkInterfaceDependentStringProperty(
                                                       const std::string &p,
                                                       const char *config)
 {
+  cmWorkerPool::ModelLock lock;
   return checkInterfacePropertyCompatibility<const char *>(this,
                                                            p,
                                                            config,
@@ -5966,6 +6018,7 @@ bool cmTarget::IsChrpathUsed(const char* config)
 cmTarget::ImportInfo const*
 cmTarget::GetImportInfo(const char* config, cmTarget *headTarget)
 {
+  cmWorkerPool::ModelLock lock;
   // There is no imported information for non-imported targets.
   if(!this->IsImported())
     {
@@ -6312,6 +6365,7 @@ void cmTarget::ComputeImportInfo(std::string const& desired_config,
 cmTarget::LinkInterface const* cmTarget::GetLinkInterface(const char* config,
                                                       cmTarget *head)
 {
+  cmWorkerPool::ModelLock lock;
   // Imported targets have their own link interface.
   if(this->IsImported())
     {
@@ -6638,6 +6692,7 @@ bool cmTarget::ComputeLinkInterface(const char* config, LinkInterface& iface,
 cmTarget::LinkImplementation const*
 cmTarget::GetLinkImplementation(const char* config, cmTarget *head)
 {
+  cmWorkerPool::ModelLock lock;
   // There is no link implementation for imported targets.
   if(this->IsImported())
     {
@@ -6909,6 +6964,7 @@ void cmTarget::CheckPropertyCompatibility(cmComputeLinkInformation *info,
 cmComputeLinkInformation*
 cmTarget::GetLinkInformation(const char* config, cmTarget *head)
 {
+  cmWorkerPool::ModelLock lock;
   cmTarget *headTarget = head ? head : this;
   // Lookup any existing information for this configuration.
   TargetConfigPair key(headTarget,
@@ -621,6 +621,9 @@ private:
   // If the variable is not defined use the given default instead.
   void SetPropertyDefault(const char* property, const char* default_value);
 
+  // Store the value of a computed property unless it is already set.
+  void SetComputedProperty(const char* prop, const char* value);
+
   // Returns ARCHIVE, LIBRARY, or RUNTIME based on platform and type.
   const char* GetOutputTargetType(bool implib);
 
@@ -663,7 +666,6 @@ private:
   bool HaveInstallRule;
   std::string InstallPath;
   std::string RuntimeInstallPath;
-  std::string Location;
   std::string ExportMacro;
   std::set<cmStdString> Utilities;
   bool RecordDependencies;
@@ -720,7 +722,8 @@ private:
 
 #undef TARGET_POLICY_MEMBER
 
-  // Internal representation details.
+  // Internal representation details.  The methods computing results
+  // cached here hold the cmWorkerPool model lock while they run.
   friend class cmTargetInternals;
   cmTargetInternalPointer Internal;
 
@@ -113,7 +113,8 @@ void cmTest::DefineProperties(cmake *cm)
      "Set this to a floating point value. Tests in a test set will be "
      "run in descending order of cost.", "This property describes the cost "
      "of a test. You can explicitly set this value; tests with higher COST "
-     "values will run first.");
+     "values will run first.  When running in parallel, the cost of the "
+     "tests depending on a test is added to its own.");
 
   cm->DefineProperty
     ("DEPENDS", cmProperty::TEST,
@@ -148,6 +149,17 @@ void cmTest::DefineProperties(cmake *cm)
     "If multiple tests specify the same resource lock, they are guaranteed "
     "not to run concurrently.");
 
+  cm->DefineProperty
+    ("RESOURCES", cmProperty::TEST,
+     "Specify the quantities of named resources this test needs.",
+     "Set to a list of \"name=quantity\" entries such as "
+     "\"memory=8G;ports=2\".  A quantity may end in K, M, G or T for "
+     "multiples of 1024.  When ctest is given a resource specification "
+     "file with the quantities available, it runs tests at the same time "
+     "only while they fit in those.  A test needing more than is "
+     "available runs while no other test uses the resource.  Resources "
+     "not in the file are not limited.");
+
   cm->DefineProperty
     ("MEASUREMENT", cmProperty::TEST,
      "Specify a CDASH measurement and value to be reported for a test.",
@@ -113,7 +113,9 @@ public:
       "RESULT_VAR. CMAKE_FLAGS can be used to pass -DVAR:TYPE=VALUE flags "
       "to the cmake that is run during the build. "
       "Set variable CMAKE_TRY_COMPILE_CONFIGURATION to choose a build "
-      "configuration."
+      "configuration.  "
+      "Set variable CMAKE_TRY_COMPILE_CACHE_DIR to share the results of "
+      "the srcfile signature between build trees."
       ;
     }
 
@@ -11,6 +11,8 @@
 ============================================================================*/
 #include "cmVariableWatch.h"
 
+#include "cmWorkerPool.h"
+
 static const char* const cmVariableWatchAccessStrings[] =
 {
     "READ_ACCESS",
@@ -109,6 +111,8 @@ void  cmVariableWatch::VariableAccessed(const std::string& variable,
     this->WatchMap.find(variable);
   if ( mit  != this->WatchMap.end() )
     {
+    // Callbacks may run CMake code, so run them one at a time.
+    cmWorkerPool::ModelLock lock;
     const cmVariableWatch::VectorOfPairs* vp = &mit->second;
     cmVariableWatch::VectorOfPairs::const_iterator it;
     for ( it = vp->begin(); it != vp->end(); it ++ )
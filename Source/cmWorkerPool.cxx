@@ -0,0 +1,248 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmWorkerPool.h"
+
+#if defined(CMAKE_USE_WIN32_THREADS)
+# include <windows.h>
+#elif defined(CMAKE_USE_PTHREADS)
+# include <pthread.h>
+#endif
+
+#if defined(CMAKE_USE_WIN32_THREADS) || defined(CMAKE_USE_PTHREADS)
+# define CM_WORKER_POOL_THREADS
+# include <cmsys/SystemInformation.hxx>
+#endif
+
+//----------------------------------------------------------------------------
+cmWorkerPool::Mutex::Mutex(bool recursive): Internal(0)
+{
+#if defined(CMAKE_USE_WIN32_THREADS)
+  // Critical sections are always recursive.
+  (void)recursive;
+  CRITICAL_SECTION* cs = new CRITICAL_SECTION;
+  InitializeCriticalSection(cs);
+  this->Internal = cs;
+#elif defined(CMAKE_USE_PTHREADS)
+  pthread_mutex_t* m = new pthread_mutex_t;
+  if(recursive)
+    {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(m, &attr);
+    pthread_mutexattr_destroy(&attr);
+    }
+  else
+    {
+    pthread_mutex_init(m, 0);
+    }
+  this->Internal = m;
+#else
+  (void)recursive;
+#endif
+}
+
+//----------------------------------------------------------------------------
+cmWorkerPool::Mutex::~Mutex()
+{
+#if defined(CMAKE_USE_WIN32_THREADS)
+  CRITICAL_SECTION* cs = static_cast<CRITICAL_SECTION*>(this->Internal);
+  DeleteCriticalSection(cs);
+  delete cs;
+#elif defined(CMAKE_USE_PTHREADS)
+  pthread_mutex_t* m = static_cast<pthread_mutex_t*>(this->Internal);
+  pthread_mutex_destroy(m);
+  delete m;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Mutex::Lock()
+{
+#if defined(CMAKE_USE_WIN32_THREADS)
+  EnterCriticalSection(static_cast<CRITICAL_SECTION*>(this->Internal));
+#elif defined(CMAKE_USE_PTHREADS)
+  pthread_mutex_lock(static_cast<pthread_mutex_t*>(this->Internal));
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Mutex::Unlock()
+{
+#if defined(CMAKE_USE_WIN32_THREADS)
+  LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(this->Internal));
+#elif defined(CMAKE_USE_PTHREADS)
+  pthread_mutex_unlock(static_cast<pthread_mutex_t*>(this->Internal));
+#endif
+}
+
+//----------------------------------------------------------------------------
+// The model lock exists once enabled and is kept until exit.  It is
+// only enabled and disabled while no jobs run.
+static cmWorkerPool::Mutex* cmWorkerPoolModelMutex = 0;
+static bool cmWorkerPoolModelLockEnabled = false;
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::ModelLock::Enable(bool enable)
+{
+  if(enable && !cmWorkerPoolModelMutex)
+    {
+    cmWorkerPoolModelMutex = new cmWorkerPool::Mutex(true);
+    }
+  cmWorkerPoolModelLockEnabled = enable;
+}
+
+//----------------------------------------------------------------------------
+cmWorkerPool::ModelLock::ModelLock(): Locked(cmWorkerPoolModelLockEnabled)
+{
+  if(this->Locked)
+    {
+    cmWorkerPoolModelMutex->Lock();
+    }
+}
+
+//----------------------------------------------------------------------------
+cmWorkerPool::ModelLock::~ModelLock()
+{
+  if(this->Locked)
+    {
+    cmWorkerPoolModelMutex->Unlock();
+    }
+}
+
+//----------------------------------------------------------------------------
+unsigned int cmWorkerPool::GetDefaultThreadCount()
+{
+#if defined(CM_WORKER_POOL_THREADS)
+  static unsigned int count = 0;
+  if(count == 0)
+    {
+    cmsys::SystemInformation info;
+    info.RunCPUCheck();
+    count = info.GetNumberOfLogicalCPU();
+    if(count < 1)
+      {
+      count = 1;
+      }
+    }
+  return count;
+#else
+  return 1;
+#endif
+}
+
+#if defined(CM_WORKER_POOL_THREADS)
+//----------------------------------------------------------------------------
+// The queue shared by the threads of one RunJobs call.
+struct cmWorkerPoolQueue
+{
+  std::vector<cmWorkerPool::Job*> const* Jobs;
+  size_t Next;
+  cmWorkerPool::Mutex NextLock;
+
+  // Take the next job to run, or return null when all are taken.
+  cmWorkerPool::Job* Take()
+    {
+    cmWorkerPool::Lock lock(this->NextLock);
+    if(this->Next < this->Jobs->size())
+      {
+      return (*this->Jobs)[this->Next++];
+      }
+    return 0;
+    }
+
+  void RunAll()
+    {
+    while(cmWorkerPool::Job* job = this->Take())
+      {
+      job->Run();
+      }
+    }
+};
+
+# if defined(CMAKE_USE_WIN32_THREADS)
+static DWORD WINAPI cmWorkerPoolThread(LPVOID arg)
+{
+  static_cast<cmWorkerPoolQueue*>(arg)->RunAll();
+  return 0;
+}
+# else
+extern "C" void* cmWorkerPoolThread(void* arg)
+{
+  static_cast<cmWorkerPoolQueue*>(arg)->RunAll();
+  return 0;
+}
+# endif
+#endif
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::RunJobs(std::vector<Job*> const& jobs,
+                           unsigned int threads)
+{
+#if defined(CM_WORKER_POOL_THREADS)
+  if(threads > jobs.size())
+    {
+    threads = static_cast<unsigned int>(jobs.size());
+    }
+  if(threads > 1)
+    {
+    cmWorkerPoolQueue queue;
+    queue.Jobs = &jobs;
+    queue.Next = 0;
+
+    // Start helper threads and work on the calling thread too.  If a
+    // thread cannot be started the remaining ones do its share.
+# if defined(CMAKE_USE_WIN32_THREADS)
+    std::vector<HANDLE> helpers;
+    for(unsigned int i = 1; i < threads; ++i)
+      {
+      HANDLE h = CreateThread(0, 0, cmWorkerPoolThread, &queue, 0, 0);
+      if(h)
+        {
+        helpers.push_back(h);
+        }
+      }
+    queue.RunAll();
+    for(std::vector<HANDLE>::iterator hi = helpers.begin();
+        hi != helpers.end(); ++hi)
+      {
+      WaitForSingleObject(*hi, INFINITE);
+      CloseHandle(*hi);
+      }
+# else
+    std::vector<pthread_t> helpers;
+    for(unsigned int i = 1; i < threads; ++i)
+      {
+      pthread_t t;
+      if(pthread_create(&t, 0, cmWorkerPoolThread, &queue) == 0)
+        {
+        helpers.push_back(t);
+        }
+      }
+    queue.RunAll();
+    for(std::vector<pthread_t>::iterator ti = helpers.begin();
+        ti != helpers.end(); ++ti)
+      {
+      pthread_join(*ti, 0);
+      }
+# endif
+    return;
+    }
+#else
+  (void)threads;
+#endif
+  for(std::vector<Job*>::const_iterator ji = jobs.begin();
+      ji != jobs.end(); ++ji)
+    {
+    (*ji)->Run();
+    }
+}
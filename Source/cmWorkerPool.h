@@ -0,0 +1,92 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmWorkerPool_h
+#define cmWorkerPool_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmWorkerPool
+ * \brief Run independent jobs on a number of threads.
+ *
+ * Jobs run concurrently and must only touch data they own or data
+ * protected by a cmWorkerPool::Mutex.  Most of CMake is not thread
+ * safe: jobs must not use a cmMakefile or report through
+ * cmSystemTools::Error.  They should record their results and let the
+ * caller report them once all jobs are done.
+ *
+ * When CMake is built without thread support all jobs run on the
+ * calling thread.
+ */
+class cmWorkerPool
+{
+public:
+  /** A unit of work.  */
+  class Job
+  {
+  public:
+    virtual ~Job() {}
+    virtual void Run() = 0;
+  };
+
+  /** Return the number of threads worth using on this machine.  */
+  static unsigned int GetDefaultThreadCount();
+
+  /** Run all jobs on up to the given number of threads and return
+      when they are done.  Jobs are started in order.  */
+  static void RunJobs(std::vector<Job*> const& jobs, unsigned int threads);
+
+  /** Mutual exclusion between jobs.  */
+  class Mutex
+  {
+  public:
+    Mutex(bool recursive = false);
+    ~Mutex();
+    void Lock();
+    void Unlock();
+  private:
+    void* Internal;
+    Mutex(Mutex const&); // Purposely not implemented.
+    void operator=(Mutex const&); // Purposely not implemented.
+  };
+
+  /** Hold the model lock for the lifetime of this object.  The model
+      lock is a process-wide recursive lock that guards state CMake
+      normally uses from one thread only, such as the lazily computed
+      parts of cmTarget and cmSourceFile.  Code that runs jobs touching
+      such state enables it for the duration; otherwise it does
+      nothing.  */
+  class ModelLock
+  {
+  public:
+    ModelLock();
+    ~ModelLock();
+    static void Enable(bool enable);
+  private:
+    bool Locked;
+    ModelLock(ModelLock const&); // Purposely not implemented.
+    void operator=(ModelLock const&); // Purposely not implemented.
+  };
+
+  /** Hold a mutex for the lifetime of this object.  */
+  class Lock
+  {
+  public:
+    Lock(Mutex& m): M(m) { this->M.Lock(); }
+    ~Lock() { this->M.Unlock(); }
+  private:
+    Mutex& M;
+    Lock(Lock const&); // Purposely not implemented.
+    void operator=(Lock const&); // Purposely not implemented.
+  };
+};
+
+#endif
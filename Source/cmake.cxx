@@ -19,11 +19,14 @@
 #include "cmCommands.h"
 #include "cmCommand.h"
 #include "cmFileTimeComparison.h"
+#include "cmListFileCache.h"
+#include "cmMakefileProfilingData.h"
 #include "cmGeneratedFileStream.h"
 #include "cmQtAutomoc.h"
 #include "cmSourceFile.h"
 #include "cmVersion.h"
 #include "cmTest.h"
+#include "cmWorkerPool.h"
 #include "cmDocumentationFormatterText.h"
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
@@ -150,6 +153,7 @@ void cmWarnUnusedCliWarning(const std::string& variable,
 cmake::cmake()
 {
   this->Trace = false;
+  this->ProfilingOutput = 0;
   this->WarnUninitialized = false;
   this->WarnUnused = false;
   this->WarnUnusedCli = true;
@@ -160,6 +164,7 @@ cmake::cmake()
   this->DebugTryCompile = false;
   this->ClearBuildSystem = false;
   this->FileComparison = new cmFileTimeComparison;
+  this->ListFileCache = new cmListFileCache;
 
   this->Policies = new cmPolicies();
   this->InitializeProperties();
@@ -225,6 +230,8 @@ cmake::~cmake()
   delete this->VariableWatch;
 #endif
   delete this->FileComparison;
+  delete this->ListFileCache;
+  delete this->ProfilingOutput;
 }
 
 void cmake::InitializeProperties()
@@ -779,6 +786,18 @@ void cmake::SetArgs(const std::vector<std::string>& args,
       std::cout << "Running with trace output on.\n";
       this->SetTrace(true);
       }
+    else if(arg.find("--profiling-output=",0) == 0)
+      {
+      std::string path = arg.substr(strlen("--profiling-output="));
+      path = cmSystemTools::CollapseFullPath(path.c_str());
+      delete this->ProfilingOutput;
+      this->ProfilingOutput = new cmMakefileProfilingData(path.c_str());
+      if(!this->ProfilingOutput->IsValid())
+        {
+        cmSystemTools::Error("Cannot write profiling output to ",
+                             path.c_str());
+        }
+      }
     else if(arg.find("--warn-uninitialized",0) == 0)
       {
       std::cout << "Warn about uninitialized values.\n";
@@ -1171,6 +1190,7 @@ void CMakeCommandUsage(const char* program)
        "(on one volume)\n"
     << "  tar [cxt][vfz][cvfj] file.tar [file/dir1 file/dir2 ...]\n"
     << "                            - create or extract a tar or zip archive\n"
+    << "    --threads=<n>           - compress on n threads, 0 for all\n"
     << "  time command [args] ...   - run command and return elapsed time\n"
     << "  touch file                - touch a file.\n"
     << "  touch_nocreate file       - touch a file but do not create it.\n"
@@ -1749,9 +1769,24 @@ int cmake::ExecuteCMakeCommand(std::vector<std::string>& args)
       std::string flags = args[2];
       std::string outFile = args[3];
       std::vector<cmStdString> files;
+      unsigned int threads = 1;
+      bool doing_options = true;
       for (std::string::size_type cc = 4; cc < args.size(); cc ++)
         {
-        files.push_back(args[cc]);
+        std::string const& arg = args[cc];
+        if (doing_options &&
+            cmSystemTools::StringStartsWith(arg.c_str(), "--threads="))
+          {
+          threads = static_cast<unsigned int>(atoi(arg.c_str() + 10));
+          }
+        else if (doing_options && arg == "--")
+          {
+          doing_options = false;
+          }
+        else
+          {
+          files.push_back(arg);
+          }
         }
       bool gzip = false;
       bool bzip2 = false;
@@ -1780,7 +1815,7 @@ int cmake::ExecuteCMakeCommand(std::vector<std::string>& args)
       else if ( flags.find_first_of('c') != flags.npos )
         {
         if ( !cmSystemTools::CreateTar(
-               outFile.c_str(), files, gzip, bzip2, verbose) )
+               outFile.c_str(), files, gzip, bzip2, verbose, threads) )
           {
           cmSystemTools::Error("Problem creating tar: ", outFile.c_str());
           return 1;
@@ -2370,6 +2405,17 @@ int cmake::ActualConfigure()
 
   // actually do the configure
   this->GlobalGenerator->Configure();
+  if(this->GetDebugOutput())
+    {
+    cmOStringStream msg;
+    msg << "List file cache: "
+        << this->ListFileCache->GetHits() << " hits, "
+        << this->ListFileCache->GetMisses() << " misses, "
+        << this->ListFileCache->GetBytesSaved()
+        << " bytes not parsed again, "
+        << this->ListFileCache->GetHashed() << " files hashed";
+    cmSystemTools::Message(msg.str().c_str());
+    }
   // Before saving the cache
   // if the project did not define one of the entries below, add them now
   // so users can edit the values in the cache:
@@ -3776,6 +3822,7 @@ bool cmake::IsPropertyChained(const char *name, cmProperty::ScopeType scope)
 
 void cmake::SetProperty(const char* prop, const char* value)
 {
+  cmWorkerPool::ModelLock lock;
   if (!prop)
     {
     return;
@@ -3792,6 +3839,7 @@ void cmake::SetProperty(const char* prop, const char* value)
 
 void cmake::AppendProperty(const char* prop, const char* value, bool asString)
 {
+  cmWorkerPool::ModelLock lock;
   if (!prop)
     {
     return;
@@ -3813,6 +3861,7 @@ const char *cmake::GetProperty(const char* prop)
 
 const char *cmake::GetProperty(const char* prop, cmProperty::ScopeType scope)
 {
+  cmWorkerPool::ModelLock lock;
   if(!prop)
     {
     return 0;
@@ -4472,6 +4521,7 @@ int cmake::VisualStudioLinkNonIncremental(std::vector<std::string>& args,
 void cmake::IssueMessage(cmake::MessageType t, std::string const& text,
                          cmListFileBacktrace const& backtrace)
 {
+  cmWorkerPool::ModelLock lock;
   cmOStringStream msg;
   bool isError = false;
   // Construct the message header.
@@ -25,12 +25,14 @@ class cmMakefile;
 class cmCommand;
 class cmVariableWatch;
 class cmFileTimeComparison;
+class cmListFileCache;
 class cmExternalMakefileProjectGenerator;
 class cmDocumentationSection;
 class cmPolicies;
 class cmListFileBacktrace;
 class cmTarget;
 class cmGeneratedFileStream;
+class cmMakefileProfilingData;
 
 /** \brief Represents a cmake invocation.
  *
@@ -317,6 +319,11 @@ class cmake
    */
   cmFileTimeComparison* GetFileComparison() { return this->FileComparison; }
 
+  /**
+   * Get the cache of list files parsed during this run
+   */
+  cmListFileCache* GetListFileCache() { return this->ListFileCache; }
+
   /**
    * Get the path to ctest
    */
@@ -331,6 +338,10 @@ class cmake
   // Do we want trace output during the cmake run.
   bool GetTrace() { return this->Trace;}
   void SetTrace(bool b) {  this->Trace = b;}
+
+  // Where listfile commands are timed when profiling, or null.
+  cmMakefileProfilingData* GetProfilingOutput()
+    { return this->ProfilingOutput; }
   bool GetWarnUninitialized() { return this->WarnUninitialized;}
   void SetWarnUninitialized(bool b) {  this->WarnUninitialized = b;}
   bool GetWarnUnused() { return this->WarnUnused;}
@@ -487,6 +498,7 @@ private:
   WorkingMode CurrentWorkingMode;
   bool DebugOutput;
   bool Trace;
+  cmMakefileProfilingData* ProfilingOutput;
   bool WarnUninitialized;
   bool WarnUnused;
   bool WarnUnusedCli;
@@ -505,6 +517,7 @@ private:
   bool ClearBuildSystem;
   bool DebugTryCompile;
   cmFileTimeComparison* FileComparison;
+  cmListFileCache* ListFileCache;
   std::string GraphVizFile;
   std::vector<std::string> DebugConfigs;
 
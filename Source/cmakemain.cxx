@@ -134,6 +134,14 @@ static const char * cmDocumentationOptions[][3] =
   {"--trace", "Put cmake in trace mode.",
    "Print a trace of all calls made and from where with "
    "message(send_error ) calls."},
+  {"--profiling-output=<file>", "Time listfile commands and write a "
+   "trace.",
+   "Record when each listfile command invocation and each listfile read "
+   "starts and ends and write the timings to the given file.  The file "
+   "holds the events in the Chrome trace event JSON format, with the "
+   "command name, arguments and location of each invocation.  It can be "
+   "viewed in chrome://tracing or aggregated by file, function and "
+   "command to find which parts of a project take long to configure."},
   {"--warn-uninitialized", "Warn about uninitialized values.",
    "Print a warning when an uninitialized variable is used."},
   {"--warn-unused-vars", "Warn about unused variables.",
@@ -72,7 +72,10 @@ static const char * cmDocumentationOptions[][3] =
    "given number of jobs.",
    "This option tells ctest to run the tests in parallel using given "
    "number of jobs.  This option can also be set by setting "
-   "the environment variable CTEST_PARALLEL_LEVEL."},
+   "the environment variable CTEST_PARALLEL_LEVEL.  Tests start in order "
+   "of the longest chain of DEPENDS through them, weighed by the average "
+   "and standard deviation of their past run times.  When those are known "
+   "ctest also reports the time the run was predicted to take."},
   {"-Q,--quiet", "Make ctest quiet.",
     "This option will suppress all the output. The output log file will "
     "still be generated if the --output-log is specified. Options such "
@@ -223,6 +226,38 @@ static const char * cmDocumentationOptions[][3] =
   {"--schedule-random", "Use a random order for scheduling tests",
    "This option will run the tests in a random order. It is commonly used to "
    "detect implicit dependencies in a test suite." },
+  {"--resource-spec-file <file>", "Limit the resources used by tests.",
+   "The file lists the quantities of named resources available to the "
+   "tests, one \"name=quantity\" entry per line.  Lines starting in '#' "
+   "are comments.  A quantity may end in K, M, G or T for multiples of "
+   "1024.  Tests running at the same time never need more of a resource "
+   "than this, as requested with the RESOURCES test property.  Resources "
+   "not listed are not limited." },
+  {"--test-output-dir <dir>", "Write the full output of each test to a file.",
+   "Each test writes its output to <dir>/<test name>.log while it runs.  "
+   "Characters of the test name that may not be used in a file name are "
+   "replaced by '_' and a hash of the name is appended.  "
+   "Only the head and the tail of a test output larger than "
+   "CTEST_CUSTOM_TEST_OUTPUT_BUFFER_SIZE bytes each (1 MB by default) are "
+   "kept in memory and reported, so this keeps the rest available.  "
+   "The PASS_REGULAR_EXPRESSION and FAIL_REGULAR_EXPRESSION of the test "
+   "still match the whole output as it runs, as long as a match is no "
+   "longer than the buffer size.  Expressions using ^ or $ match only "
+   "the head and the tail." },
+  {"--shard <index>/<count>", "Run one of several shards of the tests.",
+   "The tests selected by the other options are split into <count> "
+   "shards and only shard <index>, counting from 1, is run.  Tests "
+   "connected by the DEPENDS test property are kept in the same shard.  "
+   "The shards are balanced by the COST test property, or else by the "
+   "average run times in Testing/Temporary/CTestCostData.txt.  Every "
+   "shard computes the same split from the same test list and cost "
+   "data, so the shards can run on different machines from copies of "
+   "one build tree." },
+  {"--merge-test-xml <output> <files>",
+   "Merge the Test.xml files of shards.",
+   "Write the results of the tests in the ';' separated list of Test.xml "
+   "files to <output> as one run.  This is used to combine the results "
+   "of runs with --shard." },
   {"--submit-index", "Submit individual dashboard tests with specific index",
    "This option allows performing the same CTest action (such as test) "
    "multiple times and submit all stages to the same dashboard (Dart2 "
@@ -1354,6 +1354,160 @@ int kwsysProcess_WaitForExit(kwsysProcess* cp, double* userTimeout)
   return 1;
 }
 
+/*--------------------------------------------------------------------------*/
+int kwsysProcess_WaitForAny(kwsysProcess** processes, int count,
+                            double* userTimeout)
+{
+  kwsysProcessTime userStartTime = kwsysProcessTimeGetCurrent();
+  int ready = 0;
+#if KWSYSPE_USE_SELECT
+  kwsysProcessTime timeoutTime = {-1, -1};
+  kwsysProcessTimeNative timeoutLength;
+  kwsysProcessTimeNative* timeout = 0;
+  fd_set readSet;
+  int numReady = 0;
+  int max = -1;
+  int user = 0;
+  int unwatched = 0;
+  int k;
+
+  FD_ZERO(&readSet);
+  for(k=0; k < count && !ready; ++k)
+    {
+    kwsysProcess* cp = processes[k];
+    kwsysProcessTime processTimeoutTime;
+    int i;
+    if(!cp)
+      {
+      continue;
+      }
+
+    /* A process that is not executing or has no pipes left open is
+       ready to be finished.  Data reported by the last call to select
+       must be read before waiting again.  */
+    if(cp->State != kwsysProcess_State_Executing || cp->Killed ||
+       cp->TimeoutExpired || cp->PipesLeft <= 0)
+      {
+      ready = 1;
+      }
+    for(i=0; i < KWSYSPE_PIPE_COUNT; ++i)
+      {
+      int fd = cp->PipeReadEnds[i];
+      if(fd < 0)
+        {
+        continue;
+        }
+      if(fd >= FD_SETSIZE)
+        {
+        /* The descriptor does not fit in the set.  Poll for it.  */
+        unwatched = 1;
+        }
+      else if(FD_ISSET(fd, &cp->PipeSet))
+        {
+        ready = 1;
+        }
+      else
+        {
+        FD_SET(fd, &readSet);
+        if(fd > max)
+          {
+          max = fd;
+          }
+        }
+      }
+
+    /* Wake up when the first process timeout expires.  */
+    kwsysProcessGetTimeoutTime(cp, 0, &processTimeoutTime);
+    if(processTimeoutTime.tv_sec >= 0 &&
+       (timeoutTime.tv_sec < 0 ||
+        kwsysProcessTimeLess(processTimeoutTime, timeoutTime)))
+      {
+      timeoutTime = processTimeoutTime;
+      }
+    }
+
+  if(!ready)
+    {
+    /* Check if the user timeout is earlier.  */
+    if(userTimeout)
+      {
+      kwsysProcessTime userTimeoutTime =
+        kwsysProcessTimeAdd(userStartTime,
+                            kwsysProcessTimeFromDouble(*userTimeout));
+      if(timeoutTime.tv_sec < 0 ||
+         kwsysProcessTimeLess(userTimeoutTime, timeoutTime))
+        {
+        timeoutTime = userTimeoutTime;
+        user = 1;
+        }
+      }
+    if(timeoutTime.tv_sec >= 0)
+      {
+      timeout = &timeoutLength;
+      if(kwsysProcessGetTimeoutLeft(&timeoutTime, 0, &timeoutLength, 0))
+        {
+        /* The timeout has already expired.  Just check the pipes.  */
+        timeoutLength.tv_sec = 0;
+        timeoutLength.tv_usec = 0;
+        }
+      }
+    if(unwatched &&
+       (!timeout || timeoutLength.tv_sec > 0 || timeoutLength.tv_usec > 10000))
+      {
+      /* Return after a short time slice to poll the other pipes.  */
+      timeout = &timeoutLength;
+      timeoutLength.tv_sec = 0;
+      timeoutLength.tv_usec = 10000;
+      user = 0;
+      }
+
+    if(max < 0 && !timeout)
+      {
+      /* There is nothing to wait for.  */
+      ready = 1;
+      }
+    else
+      {
+      /* Run select to block until data are available.  Repeat call
+         until it is not interrupted.  */
+      while(((numReady = select(max+1, &readSet, 0, 0, timeout)) < 0) &&
+            (errno == EINTR));
+
+      /* Report a process as ready unless the user timeout expired.
+         Errors are reported by WaitForData.  */
+      ready = (numReady != 0 || !user)? 1:0;
+      }
+    }
+#else
+  /* Without select the pipes can only be polled.  Sleep a little and
+     let the caller poll them.  */
+  unsigned int usec = 10000;
+  (void)processes;
+  (void)count;
+  if(userTimeout && *userTimeout < 0.01)
+    {
+    usec = *userTimeout > 0? (unsigned int)(*userTimeout * 1000000) : 0;
+    }
+  kwsysProcess_usleep(usec);
+  ready = 1;
+#endif
+
+  /* Update the user timeout.  */
+  if(userTimeout)
+    {
+    kwsysProcessTime userEndTime = kwsysProcessTimeGetCurrent();
+    kwsysProcessTime difference = kwsysProcessTimeSubtract(userEndTime,
+                                                           userStartTime);
+    double d = kwsysProcessTimeToDouble(difference);
+    *userTimeout -= d;
+    if(*userTimeout < 0)
+      {
+      *userTimeout = 0;
+      }
+    }
+  return ready;
+}
+
 /*--------------------------------------------------------------------------*/
 void kwsysProcess_Kill(kwsysProcess* cp)
 {
@@ -1302,6 +1302,155 @@ int kwsysProcess_WaitForExit(kwsysProcess* cp, double* userTimeout)
   return 1;
 }
 
+/*--------------------------------------------------------------------------*/
+int kwsysProcess_WaitForAny(kwsysProcess** processes, int count,
+                            double* userTimeout)
+{
+  kwsysProcessTime userStartTime = kwsysProcessTimeGetCurrent();
+  kwsysProcessTime timeoutTime;
+  kwsysProcessTime timeoutLength;
+  HANDLE events[MAXIMUM_WAIT_OBJECTS];
+  kwsysProcess* owners[MAXIMUM_WAIT_OBJECTS];
+  DWORD numEvents = 0;
+  DWORD timeout = INFINITE;
+  DWORD w;
+  int ready = 0;
+  int user = 0;
+  int unwatched = 0;
+  int k;
+
+  timeoutTime.QuadPart = -1;
+  for(k=0; k < count && !ready; ++k)
+    {
+    kwsysProcess* cp = processes[k];
+    kwsysProcessTime processTimeoutTime;
+    int i;
+    if(!cp)
+      {
+      continue;
+      }
+
+    /* A process that is not executing or has no pipes left open is
+       ready to be finished.  Data reported by the last call to
+       WaitForData must be released by another call before its reader
+       thread reports more.  */
+    if(cp->State != kwsysProcess_State_Executing || cp->Killed ||
+       cp->TimeoutExpired || cp->PipesLeft <= 0 ||
+       cp->CurrentIndex < KWSYSPE_PIPE_COUNT)
+      {
+      ready = 1;
+      }
+
+    /* Wait for the data semaphore and the process handles that
+       WaitForData waits for.  */
+    for(i=0; i < cp->ProcessEventsLength; ++i)
+      {
+      if(numEvents < MAXIMUM_WAIT_OBJECTS)
+        {
+        events[numEvents] = cp->ProcessEvents[i];
+        owners[numEvents] = cp;
+        ++numEvents;
+        }
+      else
+        {
+        /* The handle does not fit in the wait.  Poll for it.  */
+        unwatched = 1;
+        }
+      }
+
+    /* Wake up when the first process timeout expires.  */
+    kwsysProcessGetTimeoutTime(cp, 0, &processTimeoutTime);
+    if(processTimeoutTime.QuadPart >= 0 &&
+       (timeoutTime.QuadPart < 0 ||
+        kwsysProcessTimeLess(processTimeoutTime, timeoutTime)))
+      {
+      timeoutTime = processTimeoutTime;
+      }
+    }
+
+  if(!ready)
+    {
+    /* Check if the user timeout is earlier.  */
+    if(userTimeout)
+      {
+      kwsysProcessTime userTimeoutTime =
+        kwsysProcessTimeAdd(userStartTime,
+                            kwsysProcessTimeFromDouble(*userTimeout));
+      if(timeoutTime.QuadPart < 0 ||
+         kwsysProcessTimeLess(userTimeoutTime, timeoutTime))
+        {
+        timeoutTime = userTimeoutTime;
+        user = 1;
+        }
+      }
+    if(timeoutTime.QuadPart >= 0)
+      {
+      if(kwsysProcessGetTimeoutLeft(&timeoutTime, 0, &timeoutLength))
+        {
+        /* The timeout has already expired.  Just check the events.  */
+        timeout = 0;
+        }
+      else
+        {
+        timeout = kwsysProcessTimeToDWORD(timeoutLength);
+        }
+      }
+    if(unwatched && (timeout == INFINITE || timeout > 10))
+      {
+      /* Return after a short time slice to poll the other events.  */
+      timeout = 10;
+      user = 0;
+      }
+
+    if(numEvents == 0)
+      {
+      /* There is nothing to wait for.  */
+      if(timeout != INFINITE)
+        {
+        Sleep(timeout);
+        }
+      ready = user? 0:1;
+      }
+    else
+      {
+      w = WaitForMultipleObjects(numEvents, events, 0, timeout);
+      if(w >= WAIT_OBJECT_0 && w < WAIT_OBJECT_0 + numEvents)
+        {
+        /* Waiting for the data semaphore took the notification of a
+           reader thread.  Give it back for WaitForData.  Process
+           handles stay signaled.  */
+        w -= WAIT_OBJECT_0;
+        if(events[w] == owners[w]->Full)
+          {
+          ReleaseSemaphore(events[w], 1, 0);
+          }
+        ready = 1;
+        }
+      else
+        {
+        /* Report a process as ready unless the user timeout expired.
+           Errors are reported by WaitForData.  */
+        ready = (w == WAIT_TIMEOUT && user)? 0:1;
+        }
+      }
+    }
+
+  /* Update the user timeout.  */
+  if(userTimeout)
+    {
+    kwsysProcessTime userEndTime = kwsysProcessTimeGetCurrent();
+    kwsysProcessTime difference = kwsysProcessTimeSubtract(userEndTime,
+                                                           userStartTime);
+    double d = kwsysProcessTimeToDouble(difference);
+    *userTimeout -= d;
+    if(*userTimeout < 0)
+      {
+      *userTimeout = 0;
+      }
+    }
+  return ready;
+}
+
 /*--------------------------------------------------------------------------*/
 void kwsysProcess_Kill(kwsysProcess* cp)
 {
@@ -221,6 +221,109 @@ static int test8_grandchild(int argc, const char* argv[])
   return 0;
 }
 
+static int test9_sleeper(int argc, const char* argv[])
+{
+  (void)argc; (void)argv;
+  /* Sleep quietly for 5 seconds.  */
+#if defined(_WIN32)
+  Sleep(5000);
+#else
+  sleep(5);
+#endif
+  return 0;
+}
+
+/* Read what a process has printed without blocking.  Returns whether
+   it has finished.  */
+static int test9_drain(kwsysProcess* kp)
+{
+  char* data;
+  int length;
+  for(;;)
+    {
+    double timeout = 0;
+    int p = kwsysProcess_WaitForData(kp, &data, &length, &timeout);
+    if(p == kwsysProcess_Pipe_None)
+      {
+      kwsysProcess_WaitForExit(kp, 0);
+      return 1;
+      }
+    else if(p == kwsysProcess_Pipe_Timeout)
+      {
+      return 0;
+      }
+    }
+}
+
+static int test9(const char* argv0)
+{
+  /* Wait for a quick and a quiet slow child at once.  The quick one
+     must be seen to finish long before the slow one does.  */
+  const char* quick[4];
+  const char* slow[4];
+  kwsysProcess* kp[2];
+  double timeout = 10;
+  int done = 0;
+  int result = 0;
+  quick[0] = argv0;
+  quick[1] = "run";
+  quick[2] = "1";
+  quick[3] = 0;
+  slow[0] = argv0;
+  slow[1] = "run";
+  slow[2] = "109";
+  slow[3] = 0;
+  kp[0] = kwsysProcess_New();
+  kp[1] = kwsysProcess_New();
+  if(!kp[0] || !kp[1])
+    {
+    fprintf(stderr, "Problem creating kwsysProcess instances.\n");
+    return 1;
+    }
+  kwsysProcess_SetCommand(kp[0], quick);
+  kwsysProcess_SetCommand(kp[1], slow);
+  kwsysProcess_Execute(kp[1]);
+  kwsysProcess_Execute(kp[0]);
+  while(!done && timeout > 6)
+    {
+    if(!kwsysProcess_WaitForAny(kp, 2, &timeout))
+      {
+      break;
+      }
+    done = test9_drain(kp[0]);
+    if(test9_drain(kp[1]))
+      {
+      fprintf(stderr, "The slow child finished too early.\n");
+      result = 1;
+      }
+    }
+  if(!done)
+    {
+    fprintf(stderr, "The quick child was not seen to finish.\n");
+    result = 1;
+    }
+  else if(kwsysProcess_GetState(kp[0]) != kwsysProcess_State_Exited ||
+          kwsysProcess_GetExitValue(kp[0]) != 0)
+    {
+    fprintf(stderr, "The quick child did not exit normally.\n");
+    result = 1;
+    }
+
+  /* The slow child stays quiet, so waiting for it times out.  */
+  timeout = 0.5;
+  if(kwsysProcess_WaitForAny(kp+1, 1, &timeout) ||
+     kwsysProcess_GetState(kp[1]) != kwsysProcess_State_Executing)
+    {
+    fprintf(stderr, "Waiting for the quiet child did not time out.\n");
+    result = 1;
+    }
+  kwsysProcess_Kill(kp[1]);
+  kwsysProcess_WaitForExit(kp[1], 0);
+  kwsysProcess_Delete(kp[0]);
+  kwsysProcess_Delete(kp[1]);
+  return result;
+}
+
 static int runChild2(kwsysProcess* kp,
               const char* cmd[], int state, int exception, int value,
               int share, int output, int delay, double timeout,
@@ -418,7 +521,7 @@ int main(int argc, const char* argv[])
     n = atoi(argv[2]);
     }
   /* Check arguments.  */
-  if(((n >= 1 && n <= 8) || n == 108) && argc == 3)
+  if(((n >= 1 && n <= 8) || n == 108 || n == 109) && argc == 3)
     {
     /* This is the child process for a requested test number.  */
     switch (n)
@@ -432,6 +535,7 @@ int main(int argc, const char* argv[])
       case 7: return test7(argc, argv);
       case 8: return test8(argc, argv);
       case 108: return test8_grandchild(argc, argv);
+      case 109: return test9_sleeper(argc, argv);
       }
     fprintf(stderr, "Invalid test number %d.\n", n);
     return 1;
@@ -510,6 +614,12 @@ int main(int argc, const char* argv[])
 #endif
     return r;
     }
+  else if(n == 9)
+    {
+    /* This is the parent process for the test of waiting for several
+       processes.  */
+    return test9(argv[0]);
+    }
   else if(argc > 2 && strcmp(argv[1], "0") == 0)
     {
     /* This is the special debugging test to run a given command
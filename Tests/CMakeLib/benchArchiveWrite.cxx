@@ -0,0 +1,135 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmArchiveWrite.h"
+#include "cmSystemTools.h"
+#include "cmWorkerPool.h"
+
+#include <cm_libarchive.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Write a gzip and a bzip2 compressed tar archive of a directory on one
+// and on several threads and report the throughput on the uncompressed
+// archive.  Every archive must decompress to the uncompressed one.
+// Usage: benchArchiveWrite <dir> [copies]
+
+static std::string archive(std::string const& dir, int copies,
+                           cmArchiveWrite::Compress c, unsigned int threads)
+{
+  cmOStringStream out;
+    {
+    cmArchiveWrite a(out, c, cmArchiveWrite::TypeTAR, threads);
+    for(int i = 0; i < copies; ++i)
+      {
+      char prefix[32];
+      sprintf(prefix, "copy%d/", i);
+      if(!a.Add(dir, dir.size() + 1, prefix))
+        {
+        fprintf(stderr, "%s\n", a.GetError().c_str());
+        return "";
+        }
+      }
+    }
+  return out.str();
+}
+
+static std::string decompress(std::string const& data)
+{
+  std::string result;
+  struct archive* a = archive_read_new();
+  archive_read_support_filter_all(a);
+  archive_read_support_format_raw(a);
+  struct archive_entry* e;
+  if(archive_read_open_memory(a, const_cast<char*>(data.data()),
+                              data.size()) == ARCHIVE_OK &&
+     archive_read_next_header(a, &e) == ARCHIVE_OK)
+    {
+    char buffer[16384];
+    __LA_SSIZE_T n;
+    while((n = archive_read_data(a, buffer, sizeof(buffer))) > 0)
+      {
+      result.append(buffer, static_cast<size_t>(n));
+      }
+    }
+  archive_read_free(a);
+  return result;
+}
+
+int benchArchiveWrite(int argc, char* argv[])
+{
+  if(argc < 2)
+    {
+    fprintf(stderr, "Usage: benchArchiveWrite <dir> [copies]\n");
+    return 1;
+    }
+  std::string dir = argv[1];
+  int copies = argc > 2? atoi(argv[2]) : 1;
+  if(copies < 1)
+    {
+    copies = 1;
+    }
+
+  std::string tar = archive(dir, copies, cmArchiveWrite::CompressNone, 1);
+  if(tar.empty())
+    {
+    return 1;
+    }
+  double mb = static_cast<double>(tar.size()) / (1024 * 1024);
+
+  std::vector<unsigned int> threads;
+  threads.push_back(1);
+  threads.push_back(2);
+  threads.push_back(4);
+  unsigned int all = cmWorkerPool::GetDefaultThreadCount();
+  if(all > 4)
+    {
+    threads.push_back(all);
+    }
+
+  struct { const char* Name; cmArchiveWrite::Compress Compress; }
+  const compressions[] = {
+    {"gzip", cmArchiveWrite::CompressGZip},
+    {"bzip2", cmArchiveWrite::CompressBZip2}
+  };
+
+  printf("%.1f MB uncompressed, %u threads available\n", mb, all);
+  printf("%8s %8s %10s %8s %8s\n", "format", "threads", "MB/s", "ratio",
+         "speedup");
+  bool ok = true;
+  for(size_t c = 0; c < sizeof(compressions)/sizeof(compressions[0]); ++c)
+    {
+    double single = 0;
+    for(size_t t = 0; t < threads.size(); ++t)
+      {
+      double start = cmSystemTools::GetTime();
+      std::string data = archive(dir, copies, compressions[c].Compress,
+                                 threads[t]);
+      double elapsed = cmSystemTools::GetTime() - start;
+      if(t == 0)
+        {
+        single = elapsed;
+        }
+      if(decompress(data) != tar)
+        {
+        fprintf(stderr, "%s on %u threads does not decompress to the "
+                "archive\n", compressions[c].Name, threads[t]);
+        ok = false;
+        }
+      printf("%8s %8u %10.1f %8.3f %8.2f\n", compressions[c].Name,
+             threads[t], elapsed > 0? mb / elapsed : 0.0,
+             static_cast<double>(data.size()) / tar.size(),
+             elapsed > 0? single / elapsed : 0.0);
+      }
+    }
+  return ok? 0 : 1;
+}
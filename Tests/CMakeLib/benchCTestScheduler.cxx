@@ -0,0 +1,139 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmSystemTools.h"
+
+#include <cmsys/ios/sstream>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Measure how long a parallel ctest run takes to notice that a test
+// finished: run a suite of no-op tests with ctest -j next to a few
+// tests that sleep quietly, and compare the times ctest recorded for
+// the no-op tests with their real run time of a few milliseconds.
+// Usage: benchCTestScheduler <ctest> <cmake> [tests [jobs]]
+
+int benchCTestScheduler(int argc, char* argv[])
+{
+  if(argc < 3)
+    {
+    fprintf(stderr, "Usage: %s <ctest> <cmake> [tests [jobs]]\n", argv[0]);
+    return 1;
+    }
+  const char* ctest = argv[1];
+  const char* cmake = argv[2];
+  int tests = 5000;
+  if(argc > 3)
+    {
+    tests = atoi(argv[3]);
+    }
+  int jobs = 32;
+  if(argc > 4)
+    {
+    jobs = atoi(argv[4]);
+    }
+  if(tests < 1)
+    {
+    tests = 1;
+    }
+  if(jobs < 1)
+    {
+    jobs = 1;
+    }
+
+  std::string dir = cmSystemTools::GetCurrentWorkingDirectory();
+  dir += "/benchCTestScheduler";
+  cmSystemTools::RemoveADirectory(dir.c_str());
+  cmSystemTools::MakeDirectory(dir.c_str());
+  std::string sleepfile = dir + "/sleep.cmake";
+  {
+  std::ofstream fout(sleepfile.c_str());
+  fout << "ctest_sleep(2)\n"
+       << "set(CTEST_RUN_CURRENT_SCRIPT 0)\n";
+  }
+  // Keep a quarter of the job slots busy with sleeping tests.  They
+  // come first so they start first.
+  int sleepers = jobs / 4 > 0? jobs / 4 : 1;
+  {
+  std::string testfile = dir + "/CTestTestfile.cmake";
+  std::ofstream fout(testfile.c_str());
+  for(int i = 0; i < sleepers; ++i)
+    {
+    fout << "add_test(sleep" << i << " \"" << ctest << "\" -S \""
+         << sleepfile << "\")\n";
+    }
+  for(int i = 0; i < tests; ++i)
+    {
+    fout << "add_test(noop" << i << " \"" << cmake << "\" -E echo_append)\n";
+    }
+  if(!fout)
+    {
+    fprintf(stderr, "Cannot write %s\n", testfile.c_str());
+    return 1;
+    }
+  }
+
+  std::vector<cmStdString> command;
+  command.push_back(ctest);
+  char jflag[32];
+  sprintf(jflag, "-j%d", jobs);
+  command.push_back(jflag);
+  command.push_back("-Q");
+  int retVal = 1;
+  double start = cmSystemTools::GetTime();
+  bool ok = cmSystemTools::RunSingleCommand(command, 0, &retVal, dir.c_str(),
+                                            cmSystemTools::OUTPUT_NONE);
+  double wall = cmSystemTools::GetTime() - start;
+  if(!ok || retVal != 0)
+    {
+    fprintf(stderr, "ctest failed in %s\n", dir.c_str());
+    return 1;
+    }
+
+  // Each line of the cost data gives the name of a test, the number of
+  // times it ran and its average run time.  A line of dashes separates
+  // them from the names of failed tests.
+  std::string costfile = dir + "/Testing/Temporary/CTestCostData.txt";
+  std::ifstream fin(costfile.c_str());
+  std::string line;
+  double busy = 0;
+  int counted = 0;
+  while(cmSystemTools::GetLineFromStream(fin, line) && line != "---")
+    {
+    cmsys_ios::istringstream parts(line);
+    std::string name;
+    int runs = 0;
+    double cost = 0;
+    if(parts >> name >> runs >> cost)
+      {
+      if(name.compare(0, 4, "noop") == 0)
+        {
+        busy += cost;
+        ++counted;
+        }
+      }
+    }
+  if(counted != tests)
+    {
+    fprintf(stderr, "Expected cost data for %d tests in %s, found %d\n",
+            tests, costfile.c_str(), counted);
+    return 1;
+    }
+
+  // A test is timed until ctest notices that it finished so the time
+  // recorded for a no-op test is mostly the latency of the scheduler.
+  printf("%8s %6s %9s %12s %14s\n", "tests", "jobs", "sleepers",
+         "wall", "ms/no-op test");
+  printf("%8d %6d %9d %12.3f %14.2f\n", tests, jobs, sleepers, wall,
+         busy * 1e3 / tests);
+  return 0;
+}
@@ -0,0 +1,111 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmDefinitions.h"
+#include "cmSystemTools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Simulate the variable traffic of nested function() calls: each call
+// pushes a scope, reads a mix of directory-level, caller-level and
+// undefined variables, sets a few locals, and pops the scope again.
+// Usage: benchDefinitions [iterations]
+
+static const int NumGlobals = 1000;
+static const int NumLocals = 8;
+static const int NumLookups = 64;
+
+static double bench_depth(std::vector<cmStdString> const& globals,
+                          std::vector<cmStdString> const& locals,
+                          int depth, int iterations, unsigned long& found)
+{
+  cmDefinitions top;
+  for(std::vector<cmStdString>::const_iterator i = globals.begin();
+      i != globals.end(); ++i)
+    {
+    top.Set(i->c_str(), i->c_str());
+    }
+
+  double start = cmSystemTools::GetTime();
+  for(int it = 0; it < iterations; ++it)
+    {
+    std::list<cmDefinitions> stack;
+    cmDefinitions* parent = &top;
+    for(int d = 0; d < depth; ++d)
+      {
+      stack.push_back(cmDefinitions(parent));
+      cmDefinitions& cur = stack.back();
+      for(int l = 0; l < NumLookups; ++l)
+        {
+        int g = (it * 131 + d * 17 + l * 31) % NumGlobals;
+        if(cur.Get(globals[g].c_str()))
+          {
+          ++found;
+          }
+        if(cur.Get(locals[l % NumLocals].c_str()))
+          {
+          ++found;
+          }
+        if(cur.Get("UNDEFINED_VARIABLE"))
+          {
+          ++found;
+          }
+        }
+      for(int l = 0; l < NumLocals; ++l)
+        {
+        cur.Set(locals[l].c_str(), globals[l].c_str());
+        }
+      parent = &cur;
+      }
+    }
+  return cmSystemTools::GetTime() - start;
+}
+
+int benchDefinitions(int argc, char* argv[])
+{
+  int iterations = 20;
+  if(argc > 1)
+    {
+    iterations = atoi(argv[1]);
+    }
+  if(iterations < 1)
+    {
+    iterations = 1;
+    }
+
+  std::vector<cmStdString> globals;
+  for(int i = 0; i < NumGlobals; ++i)
+    {
+    char buf[64];
+    sprintf(buf, "CMAKE_GLOBAL_VARIABLE_%d", i);
+    globals.push_back(buf);
+    }
+  std::vector<cmStdString> locals;
+  for(int i = 0; i < NumLocals; ++i)
+    {
+    char buf[64];
+    sprintf(buf, "ARG%d", i);
+    locals.push_back(buf);
+    }
+
+  unsigned long found = 0;
+  printf("%6s %12s %12s %14s\n", "depth", "scopes", "seconds",
+         "ns/operation");
+  for(int depth = 1; depth <= 64; depth *= 2)
+    {
+    double t = bench_depth(globals, locals, depth, iterations, found);
+    double scopes = double(depth) * iterations;
+    double ops = scopes * (3 * NumLookups + NumLocals);
+    printf("%6d %12.0f %12.4f %14.1f\n", depth, scopes, t, t * 1e9 / ops);
+    }
+  return found? 0 : 1;
+}
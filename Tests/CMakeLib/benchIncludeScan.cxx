@@ -0,0 +1,186 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmDependsC.h"
+#include "cmSystemTools.h"
+
+#include <cmsys/Glob.hxx>
+#include <cmsys/RegularExpression.hxx>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Compare the hand-written include directive scanner of cmDependsC
+// with the line matching regular expression it replaces, on all C and
+// C++ sources and headers below a directory.  The fast scanner must
+// find every directive the regular expression finds.  It may find more
+// because it also accepts continued directives and embedded comments.
+// Usage: benchIncludeScan <directory> [iterations]
+
+// Keep in sync with INCLUDE_REGEX_LINE in cmDependsC.cxx.
+#define BENCH_INCLUDE_REGEX_LINE \
+  "^[ \t]*#[ \t]*(include|import)[ \t]*[<\"]([^\">]+)([\">])"
+
+typedef std::vector<cmDependsC::IncludeDirective> Directives;
+
+static void scan_regex(cmsys::RegularExpression& re,
+                       std::string const& content, Directives& out)
+{
+  cmsys_ios::istringstream is(content);
+  std::string line;
+  while(cmSystemTools::GetLineFromStream(is, line))
+    {
+    if(re.find(line.c_str()))
+      {
+      cmDependsC::IncludeDirective inc;
+      inc.FileName = re.match(2);
+      inc.Quoted = re.match(3) == "\"";
+      out.push_back(inc);
+      }
+    }
+}
+
+static void scan_fast(std::string const& content, Directives& out)
+{
+  const char* data = content.c_str();
+  cmDependsC::FindIncludes(data, data + content.size(), out);
+}
+
+static bool contains_directives(Directives const& a, Directives const& b)
+{
+  // Check that all of "a" appears in "b" in the same order.
+  Directives::const_iterator bi = b.begin();
+  for(Directives::const_iterator ai = a.begin(); ai != a.end(); ++ai)
+    {
+    while(bi != b.end() &&
+          (bi->FileName != ai->FileName || bi->Quoted != ai->Quoted))
+      {
+      ++bi;
+      }
+    if(bi == b.end())
+      {
+      return false;
+      }
+    ++bi;
+    }
+  return true;
+}
+
+int benchIncludeScan(int argc, char* argv[])
+{
+  if(argc < 2)
+    {
+    printf("usage: benchIncludeScan <directory> [iterations]\n");
+    return 1;
+    }
+  int iterations = 3;
+  if(argc > 2)
+    {
+    iterations = atoi(argv[2]);
+    }
+  if(iterations < 1)
+    {
+    iterations = 1;
+    }
+
+  // Load the corpus.
+  std::vector<std::string> files;
+  const char* exts[] = {"c", "cxx", "cpp", "h", "hxx", "hpp", 0};
+  for(const char** ext = exts; *ext; ++ext)
+    {
+    cmsys::Glob g;
+    g.RecurseOn();
+    std::string expr = argv[1];
+    expr += "/*.";
+    expr += *ext;
+    if(g.FindFiles(expr))
+      {
+      files.insert(files.end(), g.GetFiles().begin(), g.GetFiles().end());
+      }
+    }
+  std::vector<std::string> corpus;
+  unsigned long bytes = 0;
+  for(std::vector<std::string>::const_iterator fi = files.begin();
+      fi != files.end(); ++fi)
+    {
+    std::ifstream fin(fi->c_str());
+    std::string content;
+    char buf[16384];
+    while(fin)
+      {
+      fin.read(buf, sizeof(buf));
+      content.append(buf, static_cast<size_t>(fin.gcount()));
+      }
+    bytes += static_cast<unsigned long>(content.size());
+    corpus.push_back(content);
+    }
+  if(corpus.empty())
+    {
+    printf("no sources found in %s\n", argv[1]);
+    return 1;
+    }
+
+  cmsys::RegularExpression re(BENCH_INCLUDE_REGEX_LINE);
+
+  // Check that the fast scanner finds everything.
+  int result = 0;
+  unsigned long directives = 0;
+  for(std::vector<std::string>::size_type i = 0; i < corpus.size(); ++i)
+    {
+    Directives r;
+    Directives f;
+    scan_regex(re, corpus[i], r);
+    scan_fast(corpus[i], f);
+    directives += static_cast<unsigned long>(r.size());
+    if(!contains_directives(r, f))
+      {
+      printf("fast scanner misses directives in %s: regex %d, fast %d\n",
+             files[i].c_str(), static_cast<int>(r.size()),
+             static_cast<int>(f.size()));
+      result = 1;
+      }
+    }
+
+  double mb = double(bytes) * iterations / (1024.0 * 1024.0);
+  printf("%d files, %lu bytes, %lu directives, %d iterations\n",
+         static_cast<int>(corpus.size()), bytes, directives, iterations);
+
+  double start = cmSystemTools::GetTime();
+  for(int it = 0; it < iterations; ++it)
+    {
+    for(std::vector<std::string>::const_iterator ci = corpus.begin();
+        ci != corpus.end(); ++ci)
+      {
+      Directives d;
+      scan_regex(re, *ci, d);
+      }
+    }
+  double tRegex = cmSystemTools::GetTime() - start;
+
+  start = cmSystemTools::GetTime();
+  for(int it = 0; it < iterations; ++it)
+    {
+    for(std::vector<std::string>::const_iterator ci = corpus.begin();
+        ci != corpus.end(); ++ci)
+      {
+      Directives d;
+      scan_fast(*ci, d);
+      }
+    }
+  double tFast = cmSystemTools::GetTime() - start;
+
+  printf("%-8s %10s %10s\n", "scanner", "seconds", "MB/s");
+  printf("%-8s %10.4f %10.1f\n", "regex", tRegex,
+         tRegex > 0? mb / tRegex : 0.0);
+  printf("%-8s %10.4f %10.1f\n", "fast", tFast,
+         tFast > 0? mb / tFast : 0.0);
+  return result;
+}
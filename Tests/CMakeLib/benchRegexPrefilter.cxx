@@ -0,0 +1,166 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmCTestBuildHandler.h"
+#include "cmRegexPrefilter.h"
+#include "cmSystemTools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Match the default error and warning regular expressions of
+// ctest_build against a synthetic build log of GCC, MSVC and Intel
+// compiler output, once trying every regular expression on every line
+// and once behind the literal prefilter.  Both must find the same
+// first match for every line.
+// Usage: benchRegexPrefilter [lines]
+
+static const char* log_lines[] = {
+  "[ 42%] Building CXX object Source/CMakeFiles/CMakeLib.dir/cmTarget.o",
+  "/usr/bin/c++ -O2 -Wall -I/src/Source -o cmTarget.o -c cmTarget.cxx",
+  "Linking CXX static library libCMakeLib.a",
+  "[ 43%] Built target CMakeLib",
+  "make[2]: Entering directory `/build/Source'",
+  "Scanning dependencies of target cmake",
+  "cmTarget.cxx:1234:5: warning: unused variable 'x' [-Wunused-variable]",
+  "cmTarget.cxx: In member function 'void cmTarget::Foo()':",
+  "cmTarget.cxx:99:12: error: 'bar' was not declared in this scope",
+  "cl /nologo /TP /DWIN32 /W3 /Zm1000 /EHsc /GR /Focmake.dir\\cmTarget.obj",
+  "cmTarget.cxx",
+  "c:\\src\\cmTarget.cxx(1234) : warning C4244: 'argument' : conversion",
+  "c:\\src\\cmTarget.cxx(99) : error C2065: 'bar' : undeclared identifier",
+  "   Creating library CMakeLib.lib and object CMakeLib.exp",
+  "icpc -O2 -c cmTarget.cxx -o cmTarget.o",
+  "cmTarget.cxx(1234): warning #177: variable \"x\" was declared",
+  "cmTarget.cxx(99): error: identifier \"bar\" is undefined",
+  "compilation aborted for cmTarget.cxx (code 2)",
+  "  -- Installing: /usr/local/bin/cmake",
+  0
+};
+
+typedef std::vector<cmsys::RegularExpression> Regexes;
+
+static void compile(std::vector<std::string> const& patterns,
+                    Regexes& regexes, cmRegexPrefilter& filter)
+{
+  for(std::vector<std::string>::const_iterator pi = patterns.begin();
+      pi != patterns.end(); ++pi)
+    {
+    regexes.push_back(cmsys::RegularExpression(pi->c_str()));
+    filter.AddPattern(pi->c_str());
+    }
+  filter.Compile();
+}
+
+static int find_all(Regexes& regexes, const char* line)
+{
+  for(Regexes::iterator it = regexes.begin(); it != regexes.end(); ++it)
+    {
+    if(it->find(line))
+      {
+      return static_cast<int>(it - regexes.begin());
+      }
+    }
+  return -1;
+}
+
+int benchRegexPrefilter(int argc, char* argv[])
+{
+  int lines = 20000;
+  if(argc > 1)
+    {
+    lines = atoi(argv[1]);
+    }
+  if(lines < 1)
+    {
+    lines = 1;
+    }
+
+  std::vector<std::string> patterns[4];
+  cmCTestBuildHandler::GetDefaultRegularExpressions(
+    patterns[0], patterns[1], patterns[2], patterns[3]);
+  Regexes regexes[4];
+  cmRegexPrefilter filters[4];
+  size_t numPatterns = 0;
+  size_t numUnfiltered = 0;
+  for(int s = 0; s < 4; ++s)
+    {
+    compile(patterns[s], regexes[s], filters[s]);
+    for(size_t i = 0; i < patterns[s].size(); ++i)
+      {
+      ++numPatterns;
+      numUnfiltered += filters[s].GetLiterals(i).empty()? 1 : 0;
+      }
+    }
+
+  int numLogLines = 0;
+  while(log_lines[numLogLines])
+    {
+    ++numLogLines;
+    }
+
+  std::vector<int> expected;
+  double start = cmSystemTools::GetTime();
+  for(int l = 0; l < lines; ++l)
+    {
+    const char* line = log_lines[l % numLogLines];
+    for(int s = 0; s < 4; ++s)
+      {
+      expected.push_back(find_all(regexes[s], line));
+      }
+    }
+  double full = cmSystemTools::GetTime() - start;
+
+  // Count the regular expressions the prefilter leaves to try.
+  std::vector<char> candidates;
+  size_t tried = 0;
+  for(int l = 0; l < numLogLines; ++l)
+    {
+    for(int s = 0; s < 4; ++s)
+      {
+      filters[s].Scan(log_lines[l], candidates);
+      for(size_t i = 0; i < candidates.size(); ++i)
+        {
+        tried += candidates[i]? 1 : 0;
+        }
+      }
+    }
+
+  bool ok = true;
+  start = cmSystemTools::GetTime();
+  for(int l = 0; l < lines; ++l)
+    {
+    const char* line = log_lines[l % numLogLines];
+    for(int s = 0; s < 4; ++s)
+      {
+      if(filters[s].Find(regexes[s], line) != expected[l * 4 + s])
+        {
+        ok = false;
+        }
+      }
+    }
+  double filtered = cmSystemTools::GetTime() - start;
+  if(!ok)
+    {
+    fprintf(stderr, "The prefilter changed the result of matching\n");
+    return 1;
+    }
+
+  printf("%lu patterns, %lu without literals, %.1f%% tried per line\n",
+         static_cast<unsigned long>(numPatterns),
+         static_cast<unsigned long>(numUnfiltered),
+         100.0 * static_cast<double>(tried) / (numLogLines * numPatterns));
+  printf("%8s %14s %14s %8s\n", "lines", "full ns/line", "filter ns/line",
+         "speedup");
+  printf("%8d %14.0f %14.0f %8.1f\n", lines, full * 1e9 / lines,
+         filtered * 1e9 / lines, filtered > 0? full / filtered : 0.0);
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmDefinitions.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static bool check_value(cmDefinitions const& defs, const char* key,
+                        const char* expect)
+{
+  const char* value = defs.Get(key);
+  if(!value && !expect)
+    {
+    return true;
+    }
+  if(value && expect && strcmp(value, expect) == 0)
+    {
+    return true;
+    }
+  printf("FAIL: %s: expected [%s], got [%s]\n", key,
+         expect? expect : "(null)", value? value : "(null)");
+  return false;
+}
+
+static bool check_keys(std::set<cmStdString> const& keys,
+                       const char* const* expect)
+{
+  std::set<cmStdString> e;
+  for(; *expect; ++expect)
+    {
+    e.insert(*expect);
+    }
+  if(keys == e)
+    {
+    return true;
+    }
+  printf("FAIL: key set mismatch, got:");
+  for(std::set<cmStdString>::const_iterator i = keys.begin();
+      i != keys.end(); ++i)
+    {
+    printf(" %s", i->c_str());
+    }
+  printf("\n");
+  return false;
+}
+
+int testDefinitions(int, char*[])
+{
+  bool ok = true;
+
+  cmDefinitions top;
+  top.Set("A", "a0");
+  top.Set("B", "b0");
+  top.Set("C", "c0");
+  top.Set("GONE", "x");
+  top.Set("GONE", 0);
+
+  cmDefinitions mid(&top);
+  mid.Set("B", "b1");
+  mid.Set("C", 0);
+
+  cmDefinitions low(&mid);
+  low.Set("D", "d2");
+
+  // Lookups see through to the nearest scope that sets or unsets a key.
+  ok = check_value(low, "A", "a0") && ok;
+  ok = check_value(low, "B", "b1") && ok;
+  ok = check_value(low, "C", 0) && ok;
+  ok = check_value(low, "D", "d2") && ok;
+  ok = check_value(low, "GONE", 0) && ok;
+  ok = check_value(mid, "D", 0) && ok;
+
+  // Lookups must not copy parent values into the local scope.
+  static const char* const lowLocal[] = {"D", 0};
+  ok = check_keys(low.LocalKeys(), lowLocal) && ok;
+
+  // Changes in a parent are visible until the key is localized.
+  top.Set("A", "a0'");
+  ok = check_value(low, "A", "a0'") && ok;
+  low.Localize("A");
+  low.Localize("C");
+  low.Localize("D");
+  top.Set("A", "a0''");
+  mid.Set("C", "c1");
+  ok = check_value(low, "A", "a0'") && ok;
+  ok = check_value(low, "C", 0) && ok;
+  ok = check_value(low, "D", "d2") && ok;
+
+  // Closure flattens set keys and drops unset keys.
+  static const char* const closureKeys[] = {"A", "B", "D", 0};
+  cmDefinitions closure = low.Closure();
+  ok = check_keys(closure.LocalKeys(), closureKeys) && ok;
+  ok = check_keys(low.ClosureKeys(), closureKeys) && ok;
+  ok = check_value(closure, "A", "a0'") && ok;
+  ok = check_value(closure, "B", "b1") && ok;
+  ok = check_value(closure, "C", 0) && ok;
+  if(closure.GetParent())
+    {
+    printf("FAIL: closure has a parent\n");
+    ok = false;
+    }
+
+  static const char* const midKeys[] = {"A", "B", "C", 0};
+  ok = check_keys(mid.ClosureKeys(), midKeys) && ok;
+
+  return ok? 0 : 1;
+}
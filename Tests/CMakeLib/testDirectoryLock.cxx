@@ -0,0 +1,72 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmDirectoryLock.h"
+#include "cmSystemTools.h"
+
+#define cmFailed(m) \
+  std::cout << "FAILED: " << m << "\n"; failed=1
+
+int testDirectoryLock(int, char*[])
+{
+  int failed = 0;
+  std::string path = "testDirectoryLock.lock";
+  cmSystemTools::RemoveADirectory(path.c_str());
+
+  // Only one holder at a time, and the holder is known to run.
+  {
+  cmDirectoryLock first(path);
+  cmDirectoryLock second(path);
+  if(!first.TryAcquire() || !first.IsHeld())
+    {
+    cmFailed("The lock cannot be taken.");
+    }
+  if(second.TryAcquire())
+    {
+    cmFailed("The lock was taken twice.");
+    }
+  if(!second.Exists() || !second.OwnerRuns())
+    {
+    cmFailed("The holder of the lock is not known to run.");
+    }
+  first.Release();
+  if(first.Exists() || !second.TryAcquire())
+    {
+    cmFailed("The lock was not released.");
+    }
+  }
+  if(cmSystemTools::FileIsDirectory(path.c_str()))
+    {
+    cmFailed("The lock was not released on destruction.");
+    }
+
+  // A lock left behind by a holder that is gone is removed.
+  cmSystemTools::MakeDirectory(path.c_str());
+  {
+  cmDirectoryLock stale(path);
+  if(stale.OwnerRuns())
+    {
+    cmFailed("A lock without holder is reported held.");
+    }
+  if(!stale.Acquire() || !stale.IsHeld())
+    {
+    cmFailed("A lock without holder cannot be taken.");
+    }
+  }
+
+  // A lock that cannot be created is reported.
+  cmDirectoryLock missing("testDirectoryLock-missing/sub.lock");
+  if(missing.Acquire())
+    {
+    cmFailed("A lock in a missing directory was taken.");
+    }
+  return failed;
+}
@@ -0,0 +1,168 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "testParseGCDACoverage.h"
+
+#include "cmParseGCDACoverage.h"
+#include "cmSystemTools.h"
+
+#include <cmsys/Directory.hxx>
+
+#include <stdio.h>
+
+#define DATA_DIR SOURCE_DIR "/testParseGCDACoverage_data"
+
+// The line counts ctest gets from the .gcov file gcc 12 writes for
+// cov.cxx, in which the lines of the functions of a template are listed
+// once for the template and once for each instantiation.
+static const int expected_counts[] = {
+  -1, -1, 4, 4, -1, -1, -1, 2, -1, 2, -1, 1, -1, 1, -1, -1, 0, -1, 0, -1,
+  -1, 1, -1, 1, 6, -1, -1, 1, 0, -1, 1, -1, 1, 1, 1, 1, 1, -1, 1, 1,
+  1, 1, 1, 0, 0, -1, -1, -1, 1, -1, -1, -1, -1, -1, 1
+};
+
+static int check_counts(cmParseGCDACoverage::FileLinesType const& lines)
+{
+  if(lines.size() != 1 ||
+     cmSystemTools::GetFilenameName(lines.begin()->first) != "cov.cxx")
+    {
+    printf("FAIL: cov.gcda does not cover cov.cxx alone\n");
+    return 1;
+    }
+  int failed = 0;
+  std::vector<int> const& counts = lines.begin()->second;
+  size_t size = sizeof(expected_counts) / sizeof(expected_counts[0]);
+  if(counts.size() != size)
+    {
+    printf("FAIL: %lu lines read, expected %lu\n",
+           static_cast<unsigned long>(counts.size()),
+           static_cast<unsigned long>(size));
+    ++failed;
+    }
+  for(size_t i = 0; i < counts.size() && i < size; ++i)
+    {
+    if(counts[i] != expected_counts[i])
+      {
+      printf("FAIL: line %lu has count %d, expected %d\n",
+             static_cast<unsigned long>(i + 1), counts[i],
+             expected_counts[i]);
+      ++failed;
+      }
+    }
+  return failed;
+}
+
+// Copy the test data next to a copy of its notes in which the block
+// count of the first function is replaced by a huge number.
+static bool write_corrupt_notes(std::string const& prefix)
+{
+  std::string notes;
+  {
+  std::ifstream fin(DATA_DIR "/cov.gcno", std::ios::in | cmsys_ios_binary);
+  cmOStringStream content;
+  content << fin.rdbuf();
+  notes = content.str();
+  }
+  // The little-endian blocks tag is followed by the record length and
+  // the block count.
+  static const char blocksTag[] = { 0x00, 0x00, 0x41, 0x01 };
+  std::string::size_type pos = notes.find(std::string(blocksTag, 4));
+  if(pos == std::string::npos || pos + 12 > notes.size())
+    {
+    return false;
+    }
+  notes.replace(pos + 8, 4, "\xf0\xff\xff\x7f", 4);
+  std::ofstream fout((prefix + ".gcno").c_str(),
+                     std::ios::out | cmsys_ios_binary);
+  fout.write(notes.data(), static_cast<std::streamsize>(notes.size()));
+  fout.close();
+  return fout &&
+    cmSystemTools::CopyFileAlways(DATA_DIR "/cov.gcda",
+                                  (prefix + ".gcda").c_str());
+}
+
+int testParseGCDACoverage(int, char*[])
+{
+  int failed = 0;
+  cmParseGCDACoverage parser;
+  cmParseGCDACoverage::FileLinesType lines;
+  if(!parser.ReadGCDAFile(DATA_DIR "/cov.gcda", lines))
+    {
+    printf("FAIL: cannot read cov.gcda: %s\n", parser.GetError().c_str());
+    return 1;
+    }
+  failed += check_counts(lines);
+
+  // The counts read back from the cache are those computed.
+  std::string cacheDir = BINARY_DIR "/testParseGCDACoverage_cache";
+  cmSystemTools::RemoveADirectory(cacheDir.c_str());
+  parser.SetCacheDirectory(cacheDir);
+  for(int run = 0; run < 2; ++run)
+    {
+    lines.clear();
+    if(!parser.ReadGCDAFile(DATA_DIR "/cov.gcda", lines) ||
+       parser.GetCacheHit() != (run == 1))
+      {
+      printf("FAIL: cov.gcda was %sread from the cache\n",
+             run == 1? "not " : "");
+      ++failed;
+      }
+    failed += check_counts(lines);
+    }
+
+  // The entry of a .gcda file that is removed is pruned.
+  std::string pruned = BINARY_DIR "/testParseGCDACoverage_pruned";
+  cmSystemTools::CopyFileAlways(DATA_DIR "/cov.gcda",
+                                (pruned + ".gcda").c_str());
+  cmSystemTools::CopyFileAlways(DATA_DIR "/cov.gcno",
+                                (pruned + ".gcno").c_str());
+  lines.clear();
+  parser.ReadGCDAFile((pruned + ".gcda").c_str(), lines);
+  cmSystemTools::RemoveFile((pruned + ".gcda").c_str());
+  parser.PruneCache();
+  cmsys::Directory dir;
+  dir.Load(cacheDir.c_str());
+  lines.clear();
+  if(dir.GetNumberOfFiles() != 3 ||
+     !parser.ReadGCDAFile(DATA_DIR "/cov.gcda", lines) ||
+     !parser.GetCacheHit())
+    {
+    printf("FAIL: the cache holds %lu entries after pruning, expected 1\n",
+           dir.GetNumberOfFiles() - 2);
+    ++failed;
+    }
+  parser.SetCacheDirectory("");
+
+  // Data without its notes file cannot be read.
+  lines.clear();
+  if(parser.ReadGCDAFile(DATA_DIR "/missing.gcda", lines) ||
+     parser.GetError().empty())
+    {
+    printf("FAIL: missing.gcda was read\n");
+    ++failed;
+    }
+
+  // Notes with an impossible block count are rejected.
+  std::string corrupt = BINARY_DIR "/testParseGCDACoverage_corrupt";
+  lines.clear();
+  if(!write_corrupt_notes(corrupt))
+    {
+    printf("FAIL: cannot write corrupt notes\n");
+    ++failed;
+    }
+  else if(parser.ReadGCDAFile((corrupt + ".gcda").c_str(), lines) ||
+          parser.GetError().empty())
+    {
+    printf("FAIL: notes with a corrupt block count were read\n");
+    ++failed;
+    }
+  return failed? 1 : 0;
+}
@@ -0,0 +1,56 @@
+template <typename T> struct Box
+{
+  Box(T x): v(x) {}
+  T get() const { return v; }
+  T v;
+};
+
+static int check(int x)
+{
+  if(x > 3)
+    {
+    throw x;
+    }
+  return x;
+}
+
+static int unused(int x)
+{
+  return x + 1;
+}
+
+int main(int argc, char*[])
+{
+  int t = 0;
+  for(int i = 0; i < 5; ++i) { t += i; }
+  try
+    {
+    t += check(argc + 5);
+    t = 0;
+    }
+  catch(int)
+    {
+    t++;
+    }
+  Box<int> bi(t);
+  Box<long> bl(t);
+  switch(argc)
+    {
+    case 1:
+      t += bi.get();
+    case 2:
+      t += static_cast<int>(bl.get());
+      break;
+    default:
+      t = unused(t);
+    }
+  try
+    {
+    t += check(0);
+    }
+  catch(int)
+    {
+    t = -1;
+    }
+  return t > 100;
+}
@@ -0,0 +1,133 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmRegexPrefilter.h"
+
+#include <stdio.h>
+
+static bool check_literals(const char* pattern, const char* expected)
+{
+  cmRegexPrefilter filter;
+  filter.AddPattern(pattern);
+  filter.Compile();
+  std::vector<std::string> const& literals = filter.GetLiterals(0);
+  std::string actual;
+  for(std::vector<std::string>::const_iterator li = literals.begin();
+      li != literals.end(); ++li)
+    {
+    actual += actual.empty()? "" : "|";
+    actual += *li;
+    }
+  if(actual != expected)
+    {
+    printf("FAIL: literals of \"%s\" are \"%s\", expected \"%s\"\n",
+           pattern, actual.c_str(), expected);
+    return false;
+    }
+  return true;
+}
+
+// The prefilter must never rule out a regular expression that matches.
+static const char* patterns[] = {
+  "^[Bb]us [Ee]rror",
+  "([^ :]+):([0-9]+): ([^ \\t])",
+  "([^:]+): warning[ \\t]*[0-9]+[ \\t]*:",
+  "^cc[^C]*CC: WARNING File = ([^,]+), Line = ([0-9]+)",
+  "(^|[ :])[Ww][Aa][Rr][Nn][Ii][Nn][Gg]",
+  "Makefile:[0-9]+: warning: ignoring old commands",
+  "(foo|bar)+baz?",
+  "a(bc|de)*f",
+  "x.y",
+  "\\(\\)",
+  "[]x-]yz",
+  0
+};
+
+static const char* texts[] = {
+  "",
+  "Bus error",
+  "bus Error (core dumped)",
+  "foo.c:12: warning: unused",
+  "foo.c:12:  warning",
+  "foo.obj : warning C4244: conversion",
+  "cc-1234 CC: WARNING File = a.c, Line = 3",
+  "Warning: deprecated",
+  "WARNING here",
+  "Makefile:17: warning: ignoring old commands for target",
+  "foobarbarba",
+  "af",
+  "abcdedef",
+  "xzy",
+  "()",
+  "]yz -yz",
+  0
+};
+
+int testRegexPrefilter(int, char*[])
+{
+  int failed = 0;
+  failed += !check_literals("abc", "abc");
+  failed += !check_literals("^[Bb]us [Ee]rror", "bus error");
+  failed += !check_literals("([^:]+): warning[ \\t]*[0-9]+", ": warning");
+  failed += !check_literals("(foo|bar)baz", "barbaz|foobaz");
+  failed += !check_literals("(foo|ba)+", "ba|foo");
+  failed += !check_literals("x.y", "");
+  failed += !check_literals("a*bc?", "");
+  failed += !check_literals("(ab|c)", "");
+  failed += !check_literals("\\.cxx", ".cxx");
+  failed += !check_literals("unbalanced (", "");
+
+  cmRegexPrefilter filter;
+  std::vector<cmsys::RegularExpression> regexes;
+  for(int i = 0; patterns[i]; ++i)
+    {
+    filter.AddPattern(patterns[i]);
+    regexes.push_back(cmsys::RegularExpression());
+    regexes.back().compile(patterns[i]);
+    }
+  filter.Compile();
+  std::vector<char> candidates;
+  for(int t = 0; texts[t]; ++t)
+    {
+    filter.Scan(texts[t], candidates);
+    int first = -1;
+    for(size_t i = 0; i < regexes.size(); ++i)
+      {
+      if(regexes[i].find(texts[t]))
+        {
+        if(first < 0)
+          {
+          first = static_cast<int>(i);
+          }
+        if(!candidates[i])
+          {
+          printf("FAIL: \"%s\" matches \"%s\" but was ruled out\n",
+                 patterns[i], texts[t]);
+          ++failed;
+          }
+        }
+      }
+    if(filter.Find(regexes, texts[t]) != first)
+      {
+      printf("FAIL: Find on \"%s\" did not return %d\n", texts[t], first);
+      ++failed;
+      }
+    }
+
+  // Unrelated text rules out every pattern with literals.
+  filter.Scan("nothing to see", candidates);
+  if(candidates[0] || candidates[1] || candidates[5])
+    {
+    printf("FAIL: unrelated text was not ruled out\n");
+    ++failed;
+    }
+  return failed? 1 : 0;
+}
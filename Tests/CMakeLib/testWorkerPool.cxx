@@ -0,0 +1,94 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmWorkerPool.h"
+
+#include <stdio.h>
+
+// Each job adds its own share to a counter under the mutex and
+// records its result in a slot no other job touches.
+class testWorkerPoolJob: public cmWorkerPool::Job
+{
+public:
+  testWorkerPoolJob(cmWorkerPool::Mutex& m, unsigned long& total, int n):
+    M(m), Total(total), N(n), Result(0) {}
+  virtual void Run()
+    {
+    unsigned long sum = 0;
+    for(int i = 1; i <= this->N * 1000; ++i)
+      {
+      sum += static_cast<unsigned long>(i % 7);
+      }
+    this->Result = sum;
+    for(int i = 0; i < 100; ++i)
+      {
+      cmWorkerPool::Lock lock(this->M);
+      ++this->Total;
+      }
+    }
+  unsigned long GetResult() const { return this->Result; }
+private:
+  cmWorkerPool::Mutex& M;
+  unsigned long& Total;
+  int N;
+  unsigned long Result;
+};
+
+static bool run_jobs(unsigned int threads, int count)
+{
+  cmWorkerPool::Mutex m;
+  unsigned long total = 0;
+  std::vector<testWorkerPoolJob*> jobs;
+  std::vector<cmWorkerPool::Job*> pool;
+  for(int i = 0; i < count; ++i)
+    {
+    jobs.push_back(new testWorkerPoolJob(m, total, i % 13));
+    pool.push_back(jobs.back());
+    }
+  cmWorkerPool::RunJobs(pool, threads);
+
+  bool ok = true;
+  if(total != static_cast<unsigned long>(count) * 100)
+    {
+    printf("FAIL: %u threads, %d jobs: counter is %lu\n",
+           threads, count, total);
+    ok = false;
+    }
+  for(int i = 0; i < count; ++i)
+    {
+    testWorkerPoolJob serial(m, total, i % 13);
+    serial.Run();
+    if(jobs[i]->GetResult() != serial.GetResult())
+      {
+      printf("FAIL: %u threads: job %d result differs\n", threads, i);
+      ok = false;
+      }
+    delete jobs[i];
+    }
+  return ok;
+}
+
+int testWorkerPool(int, char*[])
+{
+  bool ok = true;
+  if(cmWorkerPool::GetDefaultThreadCount() < 1)
+    {
+    printf("FAIL: no default threads\n");
+    ok = false;
+    }
+  ok = run_jobs(0, 10) && ok;
+  ok = run_jobs(1, 10) && ok;
+  ok = run_jobs(4, 0) && ok;
+  ok = run_jobs(4, 1) && ok;
+  ok = run_jobs(4, 200) && ok;
+  ok = run_jobs(64, 5) && ok;
+  return ok? 0 : 1;
+}
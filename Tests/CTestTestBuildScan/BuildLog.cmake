@@ -0,0 +1,17 @@
+# Print a build log of 20000 lines with errors and warnings among them.
+foreach(block RANGE 0 199)
+  set(lines "")
+  foreach(i RANGE 0 99)
+    math(EXPR n "${block} * 100 + ${i}")
+    math(EXPR error "${n} % 37")
+    math(EXPR warning "${n} % 23")
+    if(error EQUAL 0)
+      set(lines "${lines}src/file${n}.c:${i}: error: 'x${n}' undeclared\n")
+    elseif(warning EQUAL 0)
+      set(lines "${lines}src/file${n}.c:${i}: warning: unused 'y${n}'\n")
+    else()
+      set(lines "${lines}[${block}%] Building C object src/file${n}.o\n")
+    endif()
+  endforeach()
+  message("${lines}")
+endforeach()
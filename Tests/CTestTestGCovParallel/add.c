@@ -0,0 +1,6 @@
+#include "count.h"
+
+int add(int a, int b)
+{
+  return count_check(a) + count_check(b);
+}
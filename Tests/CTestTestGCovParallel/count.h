@@ -0,0 +1,14 @@
+/* Every object counts calls of this function separately, so its
+   coverage merges the output of several gcov runs.  */
+static int count_check(int value)
+{
+  if(value < 0)
+    {
+    return 0;
+    }
+  return value;
+}
+
+int add(int a, int b);
+int scale(int a, int b);
+int unused(int a);
@@ -0,0 +1,18 @@
+#include <stdlib.h>
+
+#include "count.h"
+
+int main(int argc, char* argv[])
+{
+  int total = 0;
+  int i;
+  for(i = 1; i < argc; ++i)
+    {
+    total = add(total, count_check(atoi(argv[i])));
+    }
+  if(argc > 2)
+    {
+    total = scale(total, 2);
+    }
+  return total < 0;
+}
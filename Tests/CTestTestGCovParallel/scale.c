@@ -0,0 +1,10 @@
+#include "count.h"
+
+int scale(int a, int b)
+{
+  if(b == 0)
+    {
+    return 0;
+    }
+  return count_check(a * b);
+}
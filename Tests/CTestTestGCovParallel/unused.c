@@ -0,0 +1,6 @@
+#include "count.h"
+
+int unused(int a)
+{
+  return count_check(-a);
+}
@@ -0,0 +1 @@
+set(CTEST_CUSTOM_TEST_OUTPUT_BUFFER_SIZE 1000)
@@ -0,0 +1,8 @@
+# Print 2000 lines with the marker in the middle.
+foreach(i RANGE 1 2000)
+  if(i EQUAL 1000)
+    message("${marker}")
+  else()
+    message("line ${i}")
+  endif()
+endforeach()
@@ -0,0 +1,10 @@
+# The log written with --test-output-dir has all of the output.
+file(STRINGS "${log}" lines)
+list(LENGTH lines count)
+if(NOT count EQUAL 2000)
+  message(FATAL_ERROR "${log} has ${count} lines instead of 2000")
+endif()
+list(GET lines 999 middle)
+if(NOT middle STREQUAL "MiddleMarker")
+  message(FATAL_ERROR "${log} line 1000 is \"${middle}\"")
+endif()
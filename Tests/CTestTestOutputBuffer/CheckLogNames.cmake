@@ -0,0 +1,13 @@
+# Each test has a log of its own with its own output.
+file(GLOB logs "${dir}/Log_Name*.log")
+list(LENGTH logs count)
+if(NOT count EQUAL 2)
+  message(FATAL_ERROR "Test logs \"${logs}\" instead of two")
+endif()
+foreach(log ${logs})
+  file(READ "${log}" content)
+  set(outputs "${outputs}${content}")
+endforeach()
+if(NOT outputs MATCHES "Log:Name" OR NOT outputs MATCHES "Log\\?Name")
+  message(FATAL_ERROR "Test logs have output:\n${outputs}")
+endif()
@@ -0,0 +1,11 @@
+# The log written with --test-output-dir has the long line whole.
+file(STRINGS "${log}" lines)
+list(LENGTH lines count)
+if(NOT count EQUAL 3)
+  message(FATAL_ERROR "${log} has ${count} lines instead of 3")
+endif()
+list(GET lines 1 line)
+string(LENGTH "${line}" length)
+if(NOT length EQUAL 200000)
+  message(FATAL_ERROR "${log} line 2 has ${length} characters")
+endif()
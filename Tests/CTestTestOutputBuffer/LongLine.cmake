@@ -0,0 +1,10 @@
+# Print a line of 200000 characters between two short ones.
+set(line "0123456789")
+foreach(i 1 2 3 4)
+  set(line "${line}${line}${line}${line}${line}")
+endforeach()
+set(line "${line}${line}${line}${line}${line}${line}${line}${line}")
+set(line "${line}${line}${line}${line}")
+message("before")
+message("${line}")
+message("after")
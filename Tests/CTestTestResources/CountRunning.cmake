@@ -0,0 +1,16 @@
+set(CTEST_RUN_CURRENT_SCRIPT 0)
+
+get_filename_component(self_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+set(filename "${self_dir}/${name}.${group}running")
+
+# Mark this test as running, count the running tests of its group
+# and keep running for a while.
+file(WRITE "${filename}" "${name}")
+file(GLOB running "${self_dir}/*.${group}running")
+list(LENGTH running c)
+message("c='${c}'")
+ctest_sleep(1)
+file(GLOB running "${self_dir}/*.${group}running")
+list(LENGTH running c)
+message("c='${c}'")
+file(REMOVE "${filename}")
@@ -0,0 +1,48 @@
+# The entries of data.tar.gz must belong to root whoever built the
+# package.  The listing of "cmake -E tar" shows owner names only, so
+# check the ids with GNU tar where it is available.
+set(extract ${packages}/extract)
+file(REMOVE_RECURSE ${extract})
+file(MAKE_DIRECTORY ${extract})
+file(GLOB deb ${packages}/*.deb)
+execute_process(COMMAND ${CMAKE_COMMAND} -E tar xf ${deb}
+  WORKING_DIRECTORY ${extract} RESULT_VARIABLE result)
+if(result OR NOT EXISTS ${extract}/data.tar.gz)
+  set(RunCMake_TEST_FAILED "Cannot extract data.tar.gz from [${deb}].")
+  return()
+endif()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E tar tvf data.tar.gz
+  WORKING_DIRECTORY ${extract} OUTPUT_VARIABLE listing)
+string(REGEX REPLACE "\n$" "" listing "${listing}")
+string(REPLACE "\n" ";" listing "${listing}")
+list(LENGTH listing count)
+if(count LESS 2)
+  set(RunCMake_TEST_FAILED "data.tar.gz holds only [${listing}].")
+  return()
+endif()
+foreach(entry ${listing})
+  if(NOT entry MATCHES "^[^ ]+ +[0-9]+ +root +root ")
+    set(RunCMake_TEST_FAILED "Entry not owned by root:root:\n  ${entry}")
+    return()
+  endif()
+endforeach()
+
+find_program(TAR_EXECUTABLE NAMES gtar tar)
+if(TAR_EXECUTABLE)
+  execute_process(COMMAND ${TAR_EXECUTABLE} --version
+    OUTPUT_VARIABLE version ERROR_QUIET)
+endif()
+if(NOT "${version}" MATCHES "GNU tar")
+  return()
+endif()
+execute_process(COMMAND ${TAR_EXECUTABLE} --numeric-owner -tvzf data.tar.gz
+  WORKING_DIRECTORY ${extract} OUTPUT_VARIABLE listing)
+string(REGEX REPLACE "\n$" "" listing "${listing}")
+string(REPLACE "\n" ";" listing "${listing}")
+foreach(entry ${listing})
+  if(NOT entry MATCHES "^[^ ]+ 0/0 ")
+    set(RunCMake_TEST_FAILED "Entry not owned by uid/gid 0/0:\n  ${entry}")
+    return()
+  endif()
+endforeach()
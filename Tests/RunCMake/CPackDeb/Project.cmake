@@ -0,0 +1,10 @@
+install(FILES app.txt DESTINATION bin)
+install(FILES app.txt DESTINATION share/doc)
+
+set(CPACK_PACKAGE_NAME owned)
+set(CPACK_PACKAGE_VERSION 1.0)
+set(CPACK_PACKAGE_CONTACT "Nobody <nobody@example.com>")
+set(CPACK_PACKAGE_DESCRIPTION_SUMMARY "Ownership test")
+set(CPACK_DEBIAN_PACKAGE_ARCHITECTURE all)
+set(CPACK_GENERATOR DEB)
+include(CPack)
@@ -0,0 +1,9 @@
+include(RunCMake)
+
+# Build a Debian package and check the ownership of its entries.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Project-build)
+run_cmake(Project)
+set(RunCMake_TEST_NO_CLEAN 1)
+set(packages ${RunCMake_BINARY_DIR}/Ownership-packages)
+file(REMOVE_RECURSE ${packages})
+run_cmake_command(Ownership ${CMAKE_CPACK_COMMAND} -B ${packages})
@@ -0,0 +1,63 @@
+# Check how often the install script of each component ran and compare
+# the packages of a test with those built without reuse.
+set(packages ${RunCMake_BINARY_DIR}/${test}-packages)
+set(reference ${RunCMake_BINARY_DIR}/NoReuse-packages)
+
+file(READ ${RunCMake_TEST_BINARY_DIR}/install.log runs)
+string(REGEX REPLACE "\n$" "" runs "${runs}")
+string(REPLACE "\n" ";" runs "${runs}")
+list(SORT runs)
+if(NOT "${runs}" STREQUAL "${expect_runs}")
+  set(RunCMake_TEST_FAILED
+    "Install scripts ran for [${runs}], not [${expect_runs}].")
+  return()
+endif()
+
+if("${test}" STREQUAL "NoReuse")
+  return()
+endif()
+
+file(GLOB names RELATIVE ${reference}
+  ${reference}/*.tar.gz ${reference}/*.zip)
+file(GLOB actual_names RELATIVE ${packages}
+  ${packages}/*.tar.gz ${packages}/*.zip)
+list(LENGTH names count)
+if(NOT "${actual_names}" STREQUAL "${names}" OR NOT count EQUAL 4)
+  set(RunCMake_TEST_FAILED
+    "Packages are [${actual_names}], not [${names}].")
+  return()
+endif()
+
+foreach(name ${names})
+  foreach(dir ${packages} ${reference})
+    set(extract ${dir}/${name}-extract)
+    file(REMOVE_RECURSE ${extract})
+    file(MAKE_DIRECTORY ${extract})
+    execute_process(COMMAND ${CMAKE_COMMAND} -E tar xf ${dir}/${name}
+      WORKING_DIRECTORY ${extract} RESULT_VARIABLE result)
+    if(result)
+      set(RunCMake_TEST_FAILED "Cannot extract ${dir}/${name}.")
+      return()
+    endif()
+  endforeach()
+  file(GLOB_RECURSE actual RELATIVE ${packages}/${name}-extract
+    ${packages}/${name}-extract/*)
+  file(GLOB_RECURSE expect RELATIVE ${reference}/${name}-extract
+    ${reference}/${name}-extract/*)
+  list(SORT actual)
+  list(SORT expect)
+  if(NOT "${actual}" STREQUAL "${expect}")
+    set(RunCMake_TEST_FAILED
+      "${name} holds\n  ${actual}\nnot\n  ${expect}")
+    return()
+  endif()
+  foreach(file ${actual})
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+      ${packages}/${name}-extract/${file} ${reference}/${name}-extract/${file}
+      RESULT_VARIABLE result)
+    if(result)
+      set(RunCMake_TEST_FAILED "${file} differs in ${name}.")
+      return()
+    endif()
+  endforeach()
+endforeach()
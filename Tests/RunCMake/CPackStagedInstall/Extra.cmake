@@ -0,0 +1,2 @@
+set(WITH_EXTRA 1)
+include(${CMAKE_CURRENT_SOURCE_DIR}/Project.cmake)
@@ -0,0 +1,2 @@
+set(expect_runs app data)
+include(${RunCMake_TEST_SOURCE_DIR}/Compare.cmake)
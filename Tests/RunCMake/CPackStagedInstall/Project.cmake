@@ -0,0 +1,20 @@
+# Count the runs of the install script of each component.
+set(log "${CMAKE_BINARY_DIR}/install.log")
+
+install(FILES app.txt DESTINATION bin COMPONENT app)
+install(FILES data.txt DESTINATION share COMPONENT data)
+install(DIRECTORY doc DESTINATION share COMPONENT data)
+if(WITH_EXTRA)
+  install(FILES extra.txt DESTINATION share COMPONENT data)
+endif()
+foreach(component app data)
+  install(CODE "file(APPEND \"${log}\" \"${component}\\n\")"
+    COMPONENT ${component})
+endforeach()
+
+set(CPACK_PACKAGE_NAME Staged)
+set(CPACK_PACKAGE_VERSION 1.0)
+set(CPACK_GENERATOR "TGZ;ZIP")
+set(CPACK_ARCHIVE_COMPONENT_INSTALL ON)
+set(CPACK_COMPONENTS_ALL app data)
+include(CPack)
@@ -0,0 +1,14 @@
+set(packages ${RunCMake_BINARY_DIR}/Prune-packages)
+file(GLOB_RECURSE staged ${packages}/_CPack_Packages/*/_Staging/*/extra.txt)
+file(GLOB_RECURSE kept ${packages}/_CPack_Packages/*/_Staging/*/data.txt)
+if(staged OR NOT kept)
+  set(RunCMake_TEST_FAILED
+    "Staged trees hold [${staged}] and [${kept}], not only data.txt.")
+  return()
+endif()
+file(GLOB archives ${packages}/*-data.tar.gz)
+execute_process(COMMAND ${CMAKE_COMMAND} -E tar tf ${archives}
+  OUTPUT_VARIABLE contents)
+if(NOT contents MATCHES "data.txt" OR contents MATCHES "extra.txt")
+  set(RunCMake_TEST_FAILED "The data package holds:\n${contents}")
+endif()
@@ -0,0 +1,31 @@
+include(RunCMake)
+
+# Package a project with two archive generators that install the same
+# way, so the second one reuses the installs staged by the first one.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Project-build)
+run_cmake(Project)
+set(RunCMake_TEST_NO_CLEAN 1)
+
+# Package into its own directory with the given cpack options and keep
+# the log of install script runs next to the packages.
+macro(run_cpack test)
+  set(packages ${RunCMake_BINARY_DIR}/${test}-packages)
+  file(REMOVE_RECURSE ${packages})
+  file(REMOVE ${RunCMake_TEST_BINARY_DIR}/install.log)
+  run_cmake_command(${test} ${CMAKE_CPACK_COMMAND} -V -B ${packages} ${ARGN})
+endmacro()
+
+run_cpack(NoReuse -D CPACK_REUSE_STAGED_INSTALL=OFF)
+run_cpack(Reuse)
+run_cpack(Jobs -j 2)
+run_cpack(Hardlinks -D CPACK_STAGED_INSTALL_HARDLINKS=ON)
+
+# Package twice into the same directory, first with an extra file and
+# then without it.  The staged trees are kept between the runs, and the
+# second one prunes the file from them.
+set(packages ${RunCMake_BINARY_DIR}/Prune-packages)
+file(REMOVE_RECURSE ${packages})
+run_cmake(Extra)
+run_cmake_command(StageExtra ${CMAKE_CPACK_COMMAND} -B ${packages})
+run_cmake(Project)
+run_cmake_command(PruneExtra ${CMAKE_CPACK_COMMAND} -B ${packages})
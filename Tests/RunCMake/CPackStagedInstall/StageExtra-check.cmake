@@ -0,0 +1,5 @@
+set(packages ${RunCMake_BINARY_DIR}/Prune-packages)
+file(GLOB_RECURSE staged ${packages}/_CPack_Packages/*/_Staging/*/extra.txt)
+if(NOT staged)
+  set(RunCMake_TEST_FAILED "extra.txt was not staged.")
+endif()
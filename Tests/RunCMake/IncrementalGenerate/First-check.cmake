@@ -0,0 +1,5 @@
+foreach(dir a b)
+  if(NOT EXISTS ${RunCMake_TEST_BINARY_DIR}/${dir}/CMakeFiles/CMakeDirectoryFingerprint.txt)
+    set(RunCMake_TEST_FAILED "No fingerprint recorded for directory ${dir}.")
+  endif()
+endforeach()
@@ -0,0 +1,41 @@
+include(RunCMake)
+
+# Generate the same tree several times while changing only the input
+# of directory "a".  Each run after the first marks the Makefiles of
+# all directories to see which ones it generates again.
+set(input ${RunCMake_BINARY_DIR}/Input.cmake)
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Tree-build)
+set(RunCMake_TEST_OPTIONS -DINPUT_FILE=${input})
+file(REMOVE_RECURSE ${RunCMake_TEST_BINARY_DIR})
+
+macro(mark_makefiles)
+  foreach(dir a b c d)
+    file(APPEND ${RunCMake_TEST_BINARY_DIR}/${dir}/Makefile "# marked\n")
+  endforeach()
+endmacro()
+
+file(WRITE ${input} "set(A_DEFINITION A_FIRST)\n")
+run_cmake(First)
+
+# The first run defines some variables only while enabling languages,
+# so the next one generates everything again.
+set(RunCMake_TEST_NO_CLEAN 1)
+run_cmake(Again)
+
+mark_makefiles()
+file(WRITE ${input} "set(A_DEFINITION A_SECOND)\n")
+run_cmake(Second)
+
+mark_makefiles()
+run_cmake(Unchanged)
+
+# Turning reuse off generates every directory again, even on a second
+# run with the same inputs.
+set(RunCMake_TEST_OPTIONS ${RunCMake_TEST_OPTIONS}
+  -DCMAKE_SKIP_INCREMENTAL_GENERATE=ON)
+run_cmake(SkipFirst)
+mark_makefiles()
+run_cmake(Skipped)
+
+unset(RunCMake_TEST_NO_CLEAN)
+unset(RunCMake_TEST_OPTIONS)
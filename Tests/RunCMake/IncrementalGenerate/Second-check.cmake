@@ -0,0 +1,17 @@
+set(tree ${RunCMake_TEST_BINARY_DIR})
+file(STRINGS ${tree}/a/CMakeFiles/a.dir/flags.make a_flags REGEX A_SECOND)
+file(STRINGS ${tree}/a/Makefile a_marked REGEX "# marked")
+file(STRINGS ${tree}/b/Makefile b_marked REGEX "# marked")
+file(STRINGS ${tree}/c/CMakeFiles/c.dir/flags.make c_flags
+  REGEX "-DA_SECOND( |$)")
+file(STRINGS ${tree}/c/CMakeFiles/c.dir/flags.make c_file
+  REGEX "A_FILE=[^ ]*A_SECOND")
+if(NOT a_flags)
+  set(RunCMake_TEST_FAILED "Directory a does not use its new input.")
+elseif(a_marked)
+  set(RunCMake_TEST_FAILED "Directory a was not generated again.")
+elseif(NOT b_marked)
+  set(RunCMake_TEST_FAILED "Directory b was generated again.")
+elseif(NOT c_flags OR NOT c_file)
+  set(RunCMake_TEST_FAILED "Directory c does not use the new input of a.")
+endif()
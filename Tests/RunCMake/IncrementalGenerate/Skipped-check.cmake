@@ -0,0 +1,7 @@
+set(tree ${RunCMake_TEST_BINARY_DIR})
+foreach(dir a b c d)
+  file(STRINGS ${tree}/${dir}/Makefile marked REGEX "# marked")
+  if(marked)
+    set(RunCMake_TEST_FAILED "Directory ${dir} was not generated again.")
+  endif()
+endforeach()
@@ -0,0 +1,11 @@
+set(tree ${RunCMake_TEST_BINARY_DIR})
+foreach(dir a b c)
+  file(STRINGS ${tree}/${dir}/Makefile marked REGEX "# marked")
+  if(NOT marked)
+    set(RunCMake_TEST_FAILED "Directory ${dir} was generated again.")
+  endif()
+endforeach()
+file(STRINGS ${tree}/d/Makefile marked REGEX "# marked")
+if(marked)
+  set(RunCMake_TEST_FAILED "Directory d was not generated again.")
+endif()
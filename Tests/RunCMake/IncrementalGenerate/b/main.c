@@ -0,0 +1,2 @@
+extern int b(void);
+int main(void) { return b(); }
@@ -0,0 +1 @@
+int d(void) { return 0; }
@@ -0,0 +1 @@
+int e(void) { return 0; }
@@ -0,0 +1,7 @@
+file(STRINGS ${RunCMake_TEST_BINARY_DIR}/install_database.txt entries
+  REGEX "/root/share/[abc].txt$")
+list(LENGTH entries count)
+if(NOT count EQUAL 3)
+  set(RunCMake_TEST_FAILED
+    "The install database does not record the files:\n  ${entries}")
+endif()
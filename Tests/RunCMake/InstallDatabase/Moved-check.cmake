@@ -0,0 +1,7 @@
+file(STRINGS ${RunCMake_TEST_BINARY_DIR}/install_database.txt sources
+  REGEX "/moved/[abc].txt$")
+list(LENGTH sources count)
+if(NOT count EQUAL 3)
+  set(RunCMake_TEST_FAILED
+    "The install database does not record the new sources:\n  ${sources}")
+endif()
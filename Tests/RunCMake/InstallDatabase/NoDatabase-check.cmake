@@ -0,0 +1,7 @@
+set(database ${RunCMake_TEST_BINARY_DIR}/install_database.txt)
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+  ${database} ${database}.before RESULT_VARIABLE result)
+if(result)
+  set(RunCMake_TEST_FAILED
+    "The install database changed while it was disabled.")
+endif()
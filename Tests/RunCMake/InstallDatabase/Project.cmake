@@ -0,0 +1,2 @@
+install(FILES ${SOURCE_DIR}/a.txt ${SOURCE_DIR}/b.txt ${SOURCE_DIR}/c.txt
+  DESTINATION share)
@@ -0,0 +1,4 @@
+file(READ ${RunCMake_BINARY_DIR}/root/share/b.txt b)
+if(NOT "${b}" STREQUAL "b changed\n")
+  set(RunCMake_TEST_FAILED "The changed b.txt was not installed.")
+endif()
@@ -0,0 +1,57 @@
+include(RunCMake)
+
+set(src ${RunCMake_BINARY_DIR}/src)
+file(REMOVE_RECURSE ${src} ${RunCMake_BINARY_DIR}/root)
+foreach(name a b c)
+  file(WRITE ${src}/${name}.txt "${name}\n")
+endforeach()
+
+# Wait until a file written now gets a later time than the given file
+# by the second, so that comparing times alone tells them apart.
+macro(wait_past file)
+  file(TIMESTAMP ${file} before "%Y-%m-%d %H:%M:%S")
+  set(now "${before}")
+  while("${now}" STREQUAL "${before}")
+    file(WRITE ${RunCMake_BINARY_DIR}/probe "")
+    file(TIMESTAMP ${RunCMake_BINARY_DIR}/probe now "%Y-%m-%d %H:%M:%S")
+  endwhile()
+endmacro()
+
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Project-build)
+set(RunCMake_TEST_OPTIONS
+  -DSOURCE_DIR=${src}
+  -DCMAKE_INSTALL_PREFIX=${RunCMake_BINARY_DIR}/root
+  )
+run_cmake(Project)
+unset(RunCMake_TEST_OPTIONS)
+set(RunCMake_TEST_NO_CLEAN 1)
+
+set(install ${CMAKE_COMMAND} -P cmake_install.cmake)
+run_cmake_command(First ${install})
+run_cmake_command(Unchanged ${install})
+
+# Rebuild a.txt with the same contents and change b.txt.
+wait_past(${src}/a.txt)
+file(WRITE ${src}/a.txt "a\n")
+file(WRITE ${src}/b.txt "b changed\n")
+run_cmake_command(Rebuilt ${install})
+
+# Without the database a rebuilt source is copied again and the
+# database is left alone.
+set(database ${RunCMake_TEST_BINARY_DIR}/install_database.txt)
+configure_file(${database} ${database}.before COPYONLY)
+wait_past(${src}/a.txt)
+file(WRITE ${src}/a.txt "a\n")
+run_cmake_command(NoDatabase
+  ${CMAKE_COMMAND} -DCMAKE_INSTALL_DATABASE= -P cmake_install.cmake)
+
+# Install the same destinations from other sources with the same
+# contents.  What the database knows about the old sources is not used.
+set(moved ${RunCMake_BINARY_DIR}/moved)
+file(REMOVE_RECURSE ${moved})
+wait_past(${src}/a.txt)
+foreach(name a b c)
+  configure_file(${src}/${name}.txt ${moved}/${name}.txt COPYONLY)
+endforeach()
+run_cmake_command(Reconfigure ${CMAKE_COMMAND} -DSOURCE_DIR=${moved} .)
+run_cmake_command(Moved ${install})
@@ -0,0 +1,4 @@
+file(GLOB entries "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileParseCache/*.bin")
+if(NOT entries)
+  set(RunCMake_TEST_FAILED "No parse cache entries were written.")
+endif()
@@ -0,0 +1,11 @@
+foreach(i 1 2 3)
+  include(${CMAKE_CURRENT_LIST_DIR}/repeated.cmake)
+endforeach()
+
+# A file rewritten during the run must be parsed again.
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/rewritten.cmake
+  "message(STATUS \"rewritten=1\")\n")
+include(${CMAKE_CURRENT_BINARY_DIR}/rewritten.cmake)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/rewritten.cmake
+  "message(STATUS \"rewritten=2\")\n")
+include(${CMAKE_CURRENT_BINARY_DIR}/rewritten.cmake)
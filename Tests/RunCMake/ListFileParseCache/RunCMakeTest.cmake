@@ -0,0 +1,43 @@
+include(RunCMake)
+
+# Use a single build tree for all tests without cleaning.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ParseCache-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+
+# Rewrite an included file between runs without changing its size.
+# The modification time may not change either, so the cache must notice
+# the new content.
+file(WRITE ${RunCMake_TEST_BINARY_DIR}/changing.cmake
+  "message(STATUS \"value=1\")\n")
+run_cmake(Changed1)
+file(WRITE ${RunCMake_TEST_BINARY_DIR}/changing.cmake
+  "message(STATUS \"value=2\")\n")
+run_cmake(Changed2)
+
+# Warnings issued by the parser must appear on every run.
+run_cmake(Warn1)
+run_cmake(Warn2)
+
+# Files included repeatedly within one run are parsed only once.
+set(RunCMake_TEST_OPTIONS --debug-output)
+run_cmake(Repeated)
+unset(RunCMake_TEST_OPTIONS)
+
+# Files that were old enough when last read are not hashed again.
+# The first run after the wait rewrites the entries with trusted times.
+# All runs read the same script so that no file is new to the cache.
+set(RunCMake_TEST_OPTIONS --debug-output -DRunCMake_TEST=Unchanged1)
+run_cmake(Unchanged1)
+# Let the files read above grow old enough to be trusted by time.
+foreach(tick 1 2 3)
+  string(TIMESTAMP before "%Y-%m-%d %H:%M:%S")
+  set(now "${before}")
+  while("${now}" STREQUAL "${before}")
+    string(TIMESTAMP now "%Y-%m-%d %H:%M:%S")
+  endwhile()
+endforeach()
+run_cmake(Unchanged2)
+run_cmake(Unchanged3)
+unset(RunCMake_TEST_OPTIONS)
@@ -0,0 +1 @@
+include(${CMAKE_CURRENT_LIST_DIR}/warn.cmake)
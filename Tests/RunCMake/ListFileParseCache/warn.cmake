@@ -0,0 +1 @@
+message(STATUS "a""b")
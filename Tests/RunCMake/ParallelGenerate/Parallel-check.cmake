@@ -0,0 +1,32 @@
+if(NOT serial_dir)
+  set(serial_dir ${RunCMake_TEST_BINARY_DIR}/../Serial-files)
+endif()
+file(GLOB_RECURSE serial_files RELATIVE ${serial_dir} ${serial_dir}/*)
+file(GLOB_RECURSE parallel_files
+  RELATIVE ${RunCMake_TEST_BINARY_DIR} ${RunCMake_TEST_BINARY_DIR}/*)
+
+# The cache, logs, and files written while enabling languages are not
+# produced by the generate step.  Fingerprints cover the cache.
+set(skip "^(CMakeCache.txt|CMakeFiles/(CMakeOutput.log|ListFileParseCache/.*|[0-9.]+/.*)|.*/CMakeDirectoryFingerprint.txt)$")
+
+set(msg "")
+if(NOT "${serial_files}" STREQUAL "${parallel_files}")
+  set(msg "${msg}The set of generated files differs.\n")
+endif()
+foreach(f ${serial_files})
+  if(NOT "${f}" MATCHES "${skip}")
+    file(STRINGS ${serial_dir}/${f} serial REGEX ".")
+    file(STRINGS ${RunCMake_TEST_BINARY_DIR}/${f} parallel REGEX ".")
+    if("${f}" MATCHES "Makefile2$")
+      # Dependencies of a target are listed in no particular order.
+      list(SORT serial)
+      list(SORT parallel)
+    endif()
+    if(NOT "${serial}" STREQUAL "${parallel}")
+      set(msg "${msg}File differs: ${f}\n")
+    endif()
+  endif()
+endforeach()
+if(msg)
+  set(RunCMake_TEST_FAILED "${msg}")
+endif()
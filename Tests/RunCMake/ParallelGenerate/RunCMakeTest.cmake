@@ -0,0 +1,24 @@
+include(RunCMake)
+
+# Generate the same tree on one thread and then on several threads
+# in the same build directory so that the files can be compared.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Tree-build)
+run_cmake(Serial)
+file(REMOVE_RECURSE ${RunCMake_BINARY_DIR}/Serial-files)
+file(RENAME ${RunCMake_TEST_BINARY_DIR} ${RunCMake_BINARY_DIR}/Serial-files)
+
+set(RunCMake_TEST_OPTIONS -DCMAKE_PARALLEL_GENERATE=4)
+run_cmake(Parallel)
+unset(RunCMake_TEST_OPTIONS)
+
+# Directories that query the same target concurrently.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Shared-build)
+set(RunCMake_TEST_OPTIONS -DTREE=Shared)
+run_cmake(SharedSerial)
+file(REMOVE_RECURSE ${RunCMake_BINARY_DIR}/SharedSerial-files)
+file(RENAME ${RunCMake_TEST_BINARY_DIR}
+  ${RunCMake_BINARY_DIR}/SharedSerial-files)
+
+set(RunCMake_TEST_OPTIONS -DTREE=Shared -DCMAKE_PARALLEL_GENERATE=4)
+run_cmake(SharedParallel)
+unset(RunCMake_TEST_OPTIONS)
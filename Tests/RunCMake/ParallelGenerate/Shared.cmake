@@ -0,0 +1,14 @@
+# Directories that all query the same target while they are generated:
+# its include directories and locations through generator expressions,
+# and its location as a custom command dependency.
+set(CMAKE_BUILD_TYPE Debug)
+add_library(shared SHARED lib.c)
+set_target_properties(shared PROPERTIES
+  DEBUG_POSTFIX -debug
+  OUTPUT_NAME_RELEASE shared-release
+  )
+set_property(TARGET shared PROPERTY INCLUDE_DIRECTORIES
+  ${CMAKE_CURRENT_SOURCE_DIR}/inc1 ${CMAKE_CURRENT_SOURCE_DIR}/inc2)
+foreach(n 1 2 3 4 5 6 7 8)
+  add_subdirectory(shared shared${n})
+endforeach()
@@ -0,0 +1,2 @@
+set(serial_dir ${RunCMake_TEST_BINARY_DIR}/../SharedSerial-files)
+include(${RunCMake_SOURCE_DIR}/Parallel-check.cmake)
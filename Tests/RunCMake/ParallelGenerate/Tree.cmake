@@ -0,0 +1,6 @@
+# Directories whose targets link to each other.
+set(prev "")
+foreach(n 1 2 3 4 5 6 7 8)
+  add_subdirectory(sub sub${n})
+  set(prev lib${n})
+endforeach()
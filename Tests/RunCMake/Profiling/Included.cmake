@@ -0,0 +1 @@
+set(included 1)
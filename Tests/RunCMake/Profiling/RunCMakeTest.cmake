@@ -0,0 +1,6 @@
+include(RunCMake)
+
+set(RunCMake_TEST_OPTIONS
+  --profiling-output=${RunCMake_BINARY_DIR}/Trace-build/trace.json)
+run_cmake(Trace)
+unset(RunCMake_TEST_OPTIONS)
@@ -0,0 +1,34 @@
+set(trace "${RunCMake_TEST_BINARY_DIR}/trace.json")
+if(NOT EXISTS "${trace}")
+  set(RunCMake_TEST_FAILED "Profiling output\n  ${trace}\ndoes not exist.")
+  return()
+endif()
+file(READ "${trace}" content)
+
+if(NOT content MATCHES "^\\[.*\\]\n$")
+  set(RunCMake_TEST_FAILED "Profiling output is not a JSON array:\n${content}")
+  return()
+endif()
+
+foreach(event
+    "\"ph\":\"B\",\"name\":\"profiled_macro\",\"cat\":\"command\",[^\n]*\"functionArgs\":\"first second arg\",\"location\":\"[^\"]*/Trace.cmake:4\""
+    "\"ph\":\"E\",\"name\":\"profiled_macro\""
+    "\"ph\":\"B\",\"name\":\"set\",\"cat\":\"command\",[^\n]*\"location\":\"[^\"]*/Included.cmake:1\""
+    "\"ph\":\"B\",\"name\":\"[^\"]*/Included.cmake\",\"cat\":\"listfile\""
+    "\"ph\":\"E\",\"name\":\"[^\"]*/Included.cmake\""
+    )
+  if(NOT content MATCHES "${event}")
+    set(RunCMake_TEST_FAILED "Profiling output has no event matching\n  ${event}")
+    return()
+  endif()
+endforeach()
+
+# Every entry started must be ended.
+string(REGEX MATCHALL "\"ph\":\"B\"" begins "${content}")
+string(REGEX MATCHALL "\"ph\":\"E\"" ends "${content}")
+list(LENGTH begins nbegins)
+list(LENGTH ends nends)
+if(NOT nbegins EQUAL nends)
+  set(RunCMake_TEST_FAILED
+    "Profiling output has ${nbegins} begin events but ${nends} end events.")
+endif()
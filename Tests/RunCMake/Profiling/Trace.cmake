@@ -0,0 +1,5 @@
+macro(profiled_macro)
+  set(in_macro 1)
+endmacro()
+profiled_macro(first "second arg")
+include(${CMAKE_CURRENT_LIST_DIR}/Included.cmake)
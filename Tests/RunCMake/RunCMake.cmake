@@ -36,17 +36,27 @@ function(run_cmake test)
   if(NOT DEFINED RunCMake_TEST_OPTIONS)
     set(RunCMake_TEST_OPTIONS "")
   endif()
-  execute_process(
-    COMMAND ${CMAKE_COMMAND} "${RunCMake_TEST_SOURCE_DIR}"
-              -G "${RunCMake_GENERATOR}"
-              -T "${RunCMake_GENERATOR_TOOLSET}"
-              -DRunCMake_TEST=${test}
-              ${RunCMake_TEST_OPTIONS}
-    WORKING_DIRECTORY "${RunCMake_TEST_BINARY_DIR}"
-    OUTPUT_VARIABLE actual_stdout
-    ERROR_VARIABLE actual_stderr
-    RESULT_VARIABLE actual_result
-    )
+  if(RunCMake_TEST_COMMAND)
+    execute_process(
+      COMMAND ${RunCMake_TEST_COMMAND}
+      WORKING_DIRECTORY "${RunCMake_TEST_BINARY_DIR}"
+      OUTPUT_VARIABLE actual_stdout
+      ERROR_VARIABLE actual_stderr
+      RESULT_VARIABLE actual_result
+      )
+  else()
+    execute_process(
+      COMMAND ${CMAKE_COMMAND} "${RunCMake_TEST_SOURCE_DIR}"
+                -G "${RunCMake_GENERATOR}"
+                -T "${RunCMake_GENERATOR_TOOLSET}"
+                -DRunCMake_TEST=${test}
+                ${RunCMake_TEST_OPTIONS}
+      WORKING_DIRECTORY "${RunCMake_TEST_BINARY_DIR}"
+      OUTPUT_VARIABLE actual_stdout
+      ERROR_VARIABLE actual_stderr
+      RESULT_VARIABLE actual_result
+      )
+  endif()
   set(msg "")
   if(NOT "${actual_result}" STREQUAL "${expect_result}")
     set(msg "${msg}Result is [${actual_result}], not [${expect_result}].\n")
@@ -82,3 +92,8 @@ function(run_cmake test)
     message(STATUS "${test} - PASSED")
   endif()
 endfunction()
+
+function(run_cmake_command test)
+  set(RunCMake_TEST_COMMAND "${ARGN}")
+  run_cmake(${test})
+endfunction()
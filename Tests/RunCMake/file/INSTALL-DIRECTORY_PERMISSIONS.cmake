@@ -0,0 +1,24 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(out ${CMAKE_CURRENT_BINARY_DIR}/out)
+foreach(name a b c)
+  file(WRITE ${src}/dir/${name}.txt "${name}\n")
+  file(WRITE ${src}/dir/sub/${name}.txt "sub/${name}\n")
+endforeach()
+
+# Files go into directories that their owner may not write.
+file(INSTALL ${src}/dir DESTINATION ${out}
+  DIRECTORY_PERMISSIONS OWNER_READ OWNER_EXECUTE)
+set(missing)
+foreach(name a b c)
+  foreach(file dir/${name}.txt dir/sub/${name}.txt)
+    if(NOT EXISTS ${out}/${file})
+      list(APPEND missing ${file})
+    endif()
+  endforeach()
+endforeach()
+
+# Make the directories writable again so that they can be removed.
+file(INSTALL ${src}/dir DESTINATION ${out})
+if(missing)
+  message(FATAL_ERROR "Files not installed:\n  ${missing}")
+endif()
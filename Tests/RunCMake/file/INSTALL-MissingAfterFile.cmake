@@ -0,0 +1,8 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(out ${CMAKE_CURRENT_BINARY_DIR}/out)
+file(WRITE ${src}/a.txt "a\n")
+
+# The file walked before the missing one cannot be copied either, but
+# the walk stopped first.
+file(MAKE_DIRECTORY ${out}/a.txt)
+file(INSTALL ${src}/a.txt ${src}/missing.txt DESTINATION ${out})
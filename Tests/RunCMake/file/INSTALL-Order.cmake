@@ -0,0 +1,8 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+foreach(name f e d c b a)
+  file(WRITE ${src}/${name}.txt "${name}\n")
+endforeach()
+file(WRITE ${src}/dir/a.txt "dir/a\n")
+file(INSTALL ${src}/f.txt ${src}/e.txt ${src}/dir ${src}/d.txt ${src}/c.txt
+  ${src}/b.txt ${src}/a.txt
+  DESTINATION ${CMAKE_CURRENT_BINARY_DIR}/out)
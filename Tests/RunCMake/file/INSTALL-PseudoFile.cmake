@@ -0,0 +1,16 @@
+set(out ${CMAKE_CURRENT_BINARY_DIR}/out)
+
+# The kernel reports no size or a wrong one for these files, and may
+# refuse to copy them itself.
+foreach(file /proc/version /sys/devices/system/cpu/online)
+  if(EXISTS ${file})
+    get_filename_component(name ${file} NAME)
+    file(INSTALL ${file} DESTINATION ${out})
+    file(READ ${file} expect)
+    file(READ ${out}/${name} actual)
+    if(NOT actual STREQUAL expect OR actual STREQUAL "")
+      message(FATAL_ERROR
+        "${file} installed as:\n${actual}\ninstead of:\n${expect}")
+    endif()
+  endif()
+endforeach()
@@ -0,0 +1,21 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(out ${CMAKE_CURRENT_BINARY_DIR}/out)
+
+# Give the second source a time at least a second older so that it is
+# not taken as up to date once the first one has been installed.
+file(WRITE ${src}/second/x.txt "second\n")
+file(TIMESTAMP ${src}/second/x.txt before "%Y-%m-%d %H:%M:%S")
+foreach(tick 1 2)
+  set(now "${before}")
+  while("${now}" STREQUAL "${before}")
+    file(WRITE ${src}/first/x.txt "first\n")
+    file(TIMESTAMP ${src}/first/x.txt now "%Y-%m-%d %H:%M:%S")
+  endwhile()
+  set(before "${now}")
+endforeach()
+
+file(INSTALL ${src}/first/x.txt ${src}/second/x.txt DESTINATION ${out})
+file(READ ${out}/x.txt content)
+if(NOT content STREQUAL "second\n")
+  message(FATAL_ERROR "x.txt installed from the wrong source:\n${content}")
+endif()
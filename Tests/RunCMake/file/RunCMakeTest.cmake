@@ -0,0 +1,9 @@
+include(RunCMake)
+
+run_cmake(INSTALL-Order)
+run_cmake(INSTALL-Twice)
+run_cmake(INSTALL-DIRECTORY_PERMISSIONS)
+run_cmake(INSTALL-MissingAfterFile)
+if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+  run_cmake(INSTALL-PseudoFile)
+endif()
@@ -0,0 +1,15 @@
+enable_language(C)
+try_compile(SHOULD_PASS ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy)
+if(NOT SHOULD_PASS)
+  message(FATAL_ERROR "try_compile of src.c failed:\n${out}")
+endif()
+if(NOT EXISTS ${CMAKE_CURRENT_BINARY_DIR}/copy)
+  message(FATAL_ERROR "try_compile of src.c did not copy the executable")
+endif()
+try_compile(SHOULD_FAIL ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/fail.c
+  OUTPUT_VARIABLE fail_out)
+if(SHOULD_FAIL)
+  message(FATAL_ERROR "try_compile of fail.c succeeded")
+endif()
@@ -0,0 +1,11 @@
+include(ResultCache.cmake)
+if(NOT "${out}" MATCHES "RESULT_CACHE_MARKER in ${CMAKE_BINARY_DIR}\n")
+  message(FATAL_ERROR "try_compile did not reuse a cached result:\n${out}")
+endif()
+if("${out}" MATCHES "ResultCacheStore-build")
+  message(FATAL_ERROR "Cached output refers to another build tree:\n${out}")
+endif()
+# Failures are not cached, so they build again.
+if("${fail_out}" MATCHES "RESULT_CACHE_MARKER")
+  message(FATAL_ERROR "try_compile reused a cached failure:\n${fail_out}")
+endif()
@@ -0,0 +1,12 @@
+# Mark the stored outputs so the next test can tell they are reused.
+file(GLOB entries "${RunCMake_BINARY_DIR}/ResultCacheDir/*.txt")
+if(NOT entries)
+  set(RunCMake_TEST_FAILED "No results were stored in the cache.")
+endif()
+foreach(entry ${entries})
+  file(READ "${entry}" content)
+  if("${content}" MATCHES "fail\\.c")
+    set(RunCMake_TEST_FAILED "The failure was stored in the cache.")
+  endif()
+  file(APPEND "${entry}" "\nRESULT_CACHE_MARKER in <BINARY_DIR>\n")
+endforeach()
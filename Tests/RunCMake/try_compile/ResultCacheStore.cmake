@@ -0,0 +1 @@
+include(ResultCache.cmake)
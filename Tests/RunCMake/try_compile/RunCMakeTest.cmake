@@ -15,3 +15,10 @@ run_cmake(BadSources1)
 run_cmake(BadSources2)
 run_cmake(NonSourceCopyFile)
 run_cmake(NonSourceCompileDefinitions)
+
+set(RunCMake_TEST_OPTIONS
+  -DCMAKE_TRY_COMPILE_CACHE_DIR=${RunCMake_BINARY_DIR}/ResultCacheDir)
+file(REMOVE_RECURSE ${RunCMake_BINARY_DIR}/ResultCacheDir)
+run_cmake(ResultCacheStore)
+run_cmake(ResultCacheReuse)
+unset(RunCMake_TEST_OPTIONS)
@@ -0,0 +1 @@
+#error "This file does not compile."